@@ -21,6 +21,7 @@
 #include "GUI/BoxesList/OptimalScrollArea/scrollarea.h"
 #include "videoencoder.h"
 #include "ReadWrite/basicreadwrite.h"
+#include "Private/esettings.h"
 
 RenderWidget::RenderWidget(QWidget *parent) : QWidget(parent) {
     mMainLayout = new QVBoxLayout(this);
@@ -148,6 +149,12 @@ void RenderWidget::read(eReadStream &src) {
     }
 }
 
+RenderInstanceSettings* RenderWidget::getRenderInstanceSettings(
+        const int id) const {
+    if(id < 0 || id >= mRenderInstanceWidgets.count()) return nullptr;
+    return &mRenderInstanceWidgets.at(id)->getSettings();
+}
+
 #include "renderhandler.h"
 void RenderWidget::render(RenderInstanceSettings &settings) {
     const RenderSettings &renderSettings = settings.getRenderSettings();
@@ -155,7 +162,18 @@ void RenderWidget::render(RenderInstanceSettings &settings) {
                                  renderSettings.fMaxFrame);
     mRenderProgressBar->setValue(renderSettings.fMinFrame);
     mCurrentRenderedSettings = &settings;
-    RenderHandler::sInstance->renderFromSettings(&settings);
+    const int nSegments = eSettings::instance().fRenderSegments;
+    if(SegmentedRender::sSupported(settings, nSegments)) {
+        int queueId = -1;
+        for(int i = 0; i < mRenderInstanceWidgets.count(); i++) {
+            if(&mRenderInstanceWidgets.at(i)->getSettings() != &settings) continue;
+            queueId = i;
+            break;
+        }
+        mSegmentedRender = new SegmentedRender(settings, queueId,
+                                               nSegments, this);
+        renderSegmented(mSegmentedRender);
+    } else RenderHandler::sInstance->renderFromSettings(&settings);
     connect(&settings, &RenderInstanceSettings::renderFrameChanged,
             this, &RenderWidget::setRenderedFrame);
     connect(&settings, &RenderInstanceSettings::stateChanged,
@@ -166,6 +184,34 @@ void RenderWidget::render(RenderInstanceSettings &settings) {
     });
 }
 
+void RenderWidget::renderSegmented(SegmentedRender * const render) {
+    connect(render, &SegmentedRender::started,
+            this, &RenderWidget::leaveOnlyInterruptionButtonsEnabled);
+
+    connect(render, &SegmentedRender::finished,
+            this, &RenderWidget::leaveOnlyStartRenderButtonEnabled);
+    connect(render, &SegmentedRender::finished,
+            this, &RenderWidget::sendNextForRender);
+    connect(render, &SegmentedRender::finished,
+            render, &QObject::deleteLater);
+
+    connect(render, &SegmentedRender::interrupted,
+            this, &RenderWidget::clearAwaitingRender);
+    connect(render, &SegmentedRender::interrupted,
+            this, &RenderWidget::leaveOnlyStartRenderButtonEnabled);
+    connect(render, &SegmentedRender::interrupted,
+            render, &QObject::deleteLater);
+
+    connect(render, &SegmentedRender::failed,
+            this, &RenderWidget::leaveOnlyStartRenderButtonEnabled);
+    connect(render, &SegmentedRender::failed,
+            this, &RenderWidget::sendNextForRender);
+    connect(render, &SegmentedRender::failed,
+            render, &QObject::deleteLater);
+
+    render->start();
+}
+
 void RenderWidget::leaveOnlyInterruptionButtonsEnabled() {
     mStartRenderButton->setDisabled(true);
     mPauseRenderButton->setEnabled(true);
@@ -203,7 +249,8 @@ void RenderWidget::render() {
 void RenderWidget::stopRendering() {
     disableButtons();
     clearAwaitingRender();
-    VideoEncoder::sInterruptEncoding();
+    if(mSegmentedRender) mSegmentedRender->interrupt();
+    else VideoEncoder::sInterruptEncoding();
     if(mCurrentRenderedSettings) {
         disconnect(mCurrentRenderedSettings, nullptr, this, nullptr);
         mCurrentRenderedSettings = nullptr;
@@ -24,6 +24,7 @@
 #include <QLabel>
 #include <QPushButton>
 #include "smartPointers/ememory.h"
+#include "segmentedrender.h"
 class ScrollArea;
 class Canvas;
 class RenderInstanceWidget;
@@ -43,8 +44,12 @@ public:
 
     void write(eWriteStream& dst) const;
     void read(eReadStream& src);
+
+    //! @brief Returns settings of the render queue item at id
+    RenderInstanceSettings* getRenderInstanceSettings(const int id) const;
 private:
     void render(RenderInstanceSettings& settings);
+    void renderSegmented(SegmentedRender * const render);
     void addRenderInstanceWidget(RenderInstanceWidget *wid);
 
     QVBoxLayout *mMainLayout;
@@ -60,6 +65,7 @@ private:
     QList<RenderInstanceWidget*> mRenderInstanceWidgets;
     RenderInstanceSettings *mCurrentRenderedSettings = nullptr;
     QList<RenderInstanceWidget*> mAwaitingSettings;
+    qptr<SegmentedRender> mSegmentedRender;
 public:
     void leaveOnlyInterruptionButtonsEnabled();
     void leaveOnlyStartRenderButtonEnabled();
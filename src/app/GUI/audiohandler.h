@@ -50,6 +50,14 @@ public:
         mAudioIOOutput->write(request.fData, request.fSize);
     }
 
+    //! @brief Returns microseconds of audio consumed by the output
+    //! since startAudio(), or -1 if the output is not running.
+    qint64 processedUSecs() const {
+        if(!mAudioOutput) return -1;
+        if(mAudioOutput->state() == QAudio::StoppedState) return -1;
+        return mAudioOutput->processedUSecs();
+    }
+
     void initializeAudio(eSoundSettingsData &soundSettings);
     void startAudio();
     void pauseAudio();
@@ -30,6 +30,7 @@
 #include <QMessageBox>
 #include "timelinedockwidget.h"
 #include "Private/Tasks/taskexecutor.h"
+#include "Private/Tasks/complextask.h"
 #include "qdoubleslider.h"
 #include "canvaswindow.h"
 #include "GUI/BoxesList/boxscrollwidget.h"
@@ -97,6 +98,7 @@ MainWindow::MainWindow(Document& document,
     connect(&mDocument, &Document::documentChanged,
             this, [this]() {
         setFileChangedSinceSaving(true);
+        mChangedSinceQuickSave = true;
     });
     connect(&mDocument, &Document::activeSceneSet,
             this, &MainWindow::updateSettingsForCurrentCanvas);
@@ -280,6 +282,16 @@ MainWindow::MainWindow(Document& document,
     readRecentFiles();
     updateRecentMenu();
 
+    mQuickSaveTimer = new QTimer(this);
+    connect(mQuickSaveTimer, &QTimer::timeout, this, [this]() {
+        const int interval = eSettings::instance().fAutoQuickSaveMin;
+        if(interval <= 0) return;
+        if(++mMinutesSinceQuickSave < interval) return;
+        mMinutesSinceQuickSave = 0;
+        quickSave();
+    });
+    mQuickSaveTimer->start(60000);
+
     mEventFilterDisabled = false;
 
     installEventFilter(this);
@@ -892,6 +904,8 @@ void MainWindow::updateSettingsForCurrentCanvas(Canvas* const scene) {
 void MainWindow::setupStatusBar() {
     mUsageWidget = new UsageWidget(this);
     setStatusBar(mUsageWidget);
+    connect(&mRenderHandler, &RenderHandler::previewFramesDropped,
+            mUsageWidget, &UsageWidget::setDroppedFrames);
 }
 
 void MainWindow::setupToolBar() {
@@ -1179,6 +1193,10 @@ FillStrokeSettingsWidget *MainWindow::getFillStrokeSettings() {
     return mFillStrokeSettings;
 }
 
+RenderWidget *MainWindow::getRenderWidget() const {
+    return mTimeline->getRenderWidget();
+}
+
 bool MainWindow::askForSaving() {
     if(mChangedSinceSaving) {
         const QString title = tr("Save", "AskSaveDialog_Title");
@@ -1336,6 +1354,7 @@ bool MainWindow::isEnabled() {
 }
 
 void MainWindow::clearAll() {
+    waitForBackgroundSaves();
     TaskScheduler::instance()->clearTasks();
     setFileChangedSinceSaving(false);
     mObjectSettingsWidget->setMainTarget(nullptr);
@@ -1450,6 +1469,35 @@ void MainWindow::saveBackup() {
     }
 }
 
+void MainWindow::quickSave() {
+    if(mDocument.fEvFile.isEmpty() || !mChangedSinceSaving) return;
+    // the last quick save already holds the current state
+    if(!mChangedSinceQuickSave) return;
+    const auto& sett = eSettings::instance();
+    const QFileInfo evInfo(mDocument.fEvFile);
+    QString dirPath;
+    switch(sett.fQuickSaveTarget) {
+    case eSettings::AutosaveTarget::same_folder:
+        dirPath = evInfo.path();
+        break;
+    case eSettings::AutosaveTarget::dedicated_folder:
+        dirPath = eSettings::sSettingsDir() + "/QuickSaves";
+        break;
+    }
+    if(!QDir().mkpath(dirPath)) return;
+    const int cap = sett.fQuickSaveCap;
+    if(cap > 0) mQuickSaveId = mQuickSaveId % cap + 1;
+    else mQuickSaveId++;
+    const QString path = dirPath + "/" + evInfo.completeBaseName() +
+            "_quicksave_" + QString::number(mQuickSaveId) + ".ev";
+    try {
+        saveToFile(path, false);
+        mChangedSinceQuickSave = false;
+    } catch(const std::exception& e) {
+        gPrintExceptionCritical(e);
+    }
+}
+
 void MainWindow::exportSVG() {
     const auto dialog = new ExportSvgDialog(this);
     dialog->show();
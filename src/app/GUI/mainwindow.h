@@ -21,6 +21,7 @@
 #include <QGraphicsView>
 #include <QComboBox>
 #include <QPushButton>
+#include <QTimer>
 #include "undoredo.h"
 #include "Private/Tasks/taskscheduler.h"
 #include "effectsloader.h"
@@ -44,6 +45,7 @@ class AnimationDockWidget;
 class ColorSettingsWidget;
 class FillStrokeSettingsWidget;
 class TimelineDockWidget;
+class RenderWidget;
 class BrushSelectionWidget;
 class CanvasWindow;
 class MemoryHandler;
@@ -74,9 +76,12 @@ public:
     BoxScrollWidget *getObjectSettingsList();
 
     FillStrokeSettingsWidget *getFillStrokeSettings();
-    void saveToFile(const QString &path);
+    RenderWidget *getRenderWidget() const;
+    void saveToFile(const QString &path, const bool addRecent = true);
+    //! @brief Returns false if any of the awaited saves failed
+    bool waitForBackgroundSaves();
     void saveToFileXEV(const QString& path);
-    void loadEVFile(const QString &path);
+    void loadEVFile(const QString &path, const bool addRecent = true);
     void loadXevFile(const QString &path);
     void clearAll();
     void updateTitle();
@@ -150,6 +155,7 @@ public:
     void saveFile(const QString& path, const bool setPath = true);
     void saveFileAs(const bool setPath = true);
     void saveBackup();
+    void quickSave();
     void exportSVG();
     bool closeProject();
     void linkFile();
@@ -334,6 +340,12 @@ private:
     PaintColorWidget* mPaintColorWidget;
 
     bool mChangedSinceSaving = false;
+    bool mChangedSinceQuickSave = false;
+    QList<QPointer<ComplexTask>> mBackgroundSaves;
+    bool mWaitingForSaves = false;
+    QTimer* mQuickSaveTimer = nullptr;
+    int mMinutesSinceQuickSave = 0;
+    int mQuickSaveId = 0;
     bool mEventFilterDisabled = true;
     bool isEnabled();
     QWidget *mGrayOutWidget = nullptr;
@@ -147,6 +147,9 @@ UsageWidget::UsageWidget(QWidget * const parent) : QStatusBar(parent) {
 
     mRamLabel = new QLabel(this);
 
+    mDroppedLabel = new QLabel(this);
+    mDroppedLabel->hide();
+
     const auto clearRamButton = new QPushButton("clear memory", this);
     connect(clearRamButton, &QPushButton::clicked,
             this, []() {
@@ -154,6 +157,8 @@ UsageWidget::UsageWidget(QWidget * const parent) : QStatusBar(parent) {
         m->clearMemory();
     });
 
+    addPermanentWidget(mDroppedLabel);
+
     addPermanentWidget(gpuLabel);
     addPermanentWidget(mGpuBar);
 
@@ -209,6 +214,11 @@ void UsageWidget::setTotalRam(const qreal totalRamMB) {
     mRamBar->setRange(0, qRound(totalRamMB));
 }
 
+void UsageWidget::setDroppedFrames(const int frames) {
+    mDroppedLabel->setText("  dropped frames: " + QString::number(frames));
+    mDroppedLabel->setVisible(frames > 0);
+}
+
 void UsageWidget::addComplexTask(ComplexTask * const task) {
     for(const auto wid : qAsConst(mTaskWidgets)) {
         if(wid->isHidden()) {
@@ -131,6 +131,7 @@ SOURCES += main.cpp\
     iconloader.cpp \
     outputsettings.cpp \
     renderhandler.cpp \
+    segmentedrender.cpp \
     rendersettings.cpp \
     GUI/BoxesList/OptimalScrollArea/scrollarea.cpp \
     GUI/BoxesList/OptimalScrollArea/scrollwidget.cpp \
@@ -258,6 +259,7 @@ HEADERS  += \
     iconloader.h \
     outputsettings.h \
     renderhandler.h \
+    segmentedrender.h \
     rendersettings.h \
     keypoint.h \
     GUI/BoxesList/OptimalScrollArea/scrollarea.h \
@@ -37,8 +37,8 @@ qsptr<BoundingBox> eSvgImporter::import(const QFileInfo &fileInfo, Canvas * cons
     const auto gradientCreator = [scene]() {
         return scene->createNewGradient();
     };
-    return ImportSVG::loadSVGFile(fileInfo.absoluteFilePath(),
-                                  gradientCreator);
+    return ImportSVG::loadSVGFileAsync(fileInfo.absoluteFilePath(),
+                                       gradientCreator);
 }
 
 qsptr<BoundingBox> eOraImporter::import(const QFileInfo &fileInfo, Canvas * const scene) const {
@@ -15,6 +15,8 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <fstream>
+#include <QBuffer>
+#include <QFileInfo>
 #include "Animators/qrealanimator.h"
 #include "Animators/qpointfanimator.h"
 #include "Animators/coloranimator.h"
@@ -54,13 +56,14 @@
 #include "Sound/soundcomposition.h"
 #include "RasterEffects/rastereffectcollection.h"
 #include "ReadWrite/filefooter.h"
+#include "ReadWrite/evfilesavetask.h"
 #include "GUI/timelinedockwidget.h"
 #include "GUI/RenderWidgets/renderwidget.h"
 #include "GUI/BoxesList/boxscrollwidget.h"
 #include "ReadWrite/evformat.h"
 #include "XML/runtimewriteid.h"
 
-void MainWindow::loadEVFile(const QString &path) {
+void MainWindow::loadEVFile(const QString &path, const bool addRecent) {
     QFile file(path);
     if(!file.exists()) RuntimeThrow("File does not exist " + path);
     if(!file.open(QIODevice::ReadOnly))
@@ -70,6 +73,11 @@ void MainWindow::loadEVFile(const QString &path) {
         if(evVersion <= 0) RuntimeThrow("Incompatible or incomplete data");
         eReadStream readStream(evVersion, &file);
         readStream.setPath(path);
+#ifndef Q_OS_WIN
+        // a mapped file cannot be replaced on Windows,
+        // which would prevent saving over the loaded file
+        readStream.setMappedFile(eMappedFile::sMap(path));
+#endif
 
         const qint64 savedPos = file.pos();
         const qint64 pos = file.size() - FileFooter::sSize(evVersion) -
@@ -77,6 +85,9 @@ void MainWindow::loadEVFile(const QString &path) {
         file.seek(pos);
         readStream.readFutureTable();
         file.seek(savedPos);
+        const qint64 tocPos = FileFooter::sReadTableOfContentsPos(
+                                  &file, evVersion);
+        readStream.readTableOfContents(tocPos);
         readStream.readCheckpoint("File beginning pos mismatch");
         if(evVersion >= EvFormat::betterSWTAbsReadWrite) {
             int nScenes; readStream >> nScenes;
@@ -101,17 +112,18 @@ void MainWindow::loadEVFile(const QString &path) {
         RuntimeThrow("Error while reading from file " + path);
     }
     file.close();
-    addRecentFile(path);
+    if(addRecent) addRecentFile(path);
 }
 
-void MainWindow::saveToFile(const QString &path) {
-    QFile file(path);
-    if(file.exists()) file.remove();
-
-    if(!file.open(QIODevice::WriteOnly))
-        RuntimeThrow("Could not open file for writing " + path + ".");
-    eWriteStream writeStream(&file);
+void MainWindow::saveToFile(const QString &path, const bool addRecent) {
+    waitForBackgroundSaves();
+    // serialize a snapshot of the document on the main thread,
+    // compression and disk access happen in the background
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    eWriteStream writeStream(&buffer);
     writeStream.setPath(path);
+    writeStream.setDeferredCompression(true);
     try {
         writeStream.writeCheckpoint();
         const auto& scenes = mDocument.fScenes;
@@ -127,16 +139,54 @@ void MainWindow::saveToFile(const QString &path) {
         renderWidget->write(writeStream);
         writeStream.writeCheckpoint();
 
+        writeStream.writeTableOfContents();
         writeStream.writeFutureTable();
         FileFooter::sWrite(writeStream);
     } catch(...) {
-        file.close();
+        BoundingBox::sClearWriteBoxes();
         RuntimeThrow("Error while writing to file " + path);
     }
-    file.close();
-
     BoundingBox::sClearWriteBoxes();
-    addRecentFile(path);
+
+    const auto data = writeStream.takeDeferredData();
+    const auto task = new EvFileSaveTask(path, data);
+    const auto taskSPtr = QSharedPointer<EvFileSaveTask>(
+                              task, &QObject::deleteLater);
+    connect(task, &ComplexTask::canceled, this, [this, path]() {
+        if(path == mDocument.fEvFile) setFileChangedSinceSaving(true);
+        statusBar()->showMessage("Could not save " +
+                                 QFileInfo(path).fileName(), 10000);
+    });
+    mBackgroundSaves << task;
+    task->nextStep();
+    TaskScheduler::instance()->addComplexTask(taskSPtr);
+
+    if(addRecent) addRecentFile(path);
+}
+
+bool MainWindow::waitForBackgroundSaves() {
+    // a save started from the nested event loop would overlap with these
+    if(mWaitingForSaves) RuntimeThrow("Previous save is still in progress");
+    const auto saves = std::move(mBackgroundSaves);
+    mBackgroundSaves.clear();
+    mWaitingForSaves = true;
+    mQuickSaveTimer->stop();
+    bool success = true;
+    for(const auto& task : saves) {
+        if(!task) continue;
+        if(!task->done()) {
+            QEventLoop loop;
+            connect(task.data(), &ComplexTask::finishedAll,
+                    &loop, &QEventLoop::quit);
+            connect(task.data(), &ComplexTask::canceled,
+                    &loop, &QEventLoop::quit);
+            loop.exec();
+        }
+        if(task && task->value() < task->finishValue()) success = false;
+    }
+    mWaitingForSaves = false;
+    mQuickSaveTimer->start();
+    return success;
 }
 
 #include "XML/xevzipfilesaver.h"
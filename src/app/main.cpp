@@ -29,6 +29,8 @@
 #include "videoencoder.h"
 #include "iconloader.h"
 #include "GUI/envesplash.h"
+#include "GUI/RenderWidgets/renderwidget.h"
+#include "segmentedrender.h"
 #ifdef Q_OS_WIN
     #include "windowsincludes.h"
 #endif // Q_OS_WIN
@@ -104,6 +106,12 @@ int main(int argc, char *argv[]) {
     app.setStyleSheet("QStatusBar::item { border: 0; }");
     setlocale(LC_NUMERIC, "C");
 
+    // started by SegmentedRender to encode a part of a render queue item
+    SegmentedRender::WorkerArgs workerArgs;
+    const bool worker = SegmentedRender::WorkerArgs::sParse(
+                            app.arguments(), workerArgs);
+    if(worker) gSetExceptionDialogsEnabled(false);
+
     const bool threadedOpenGL = QOpenGLContext::supportsThreadedOpenGL();
     if(!threadedOpenGL) {
         gPrintException("Your GPU drivers do not support OpenGL "
@@ -171,6 +179,7 @@ int main(int argc, char *argv[]) {
     } catch(const std::exception& e) {
         gPrintExceptionCritical(e);
     }
+    if(worker) SegmentedRender::sApplyWorkerSettings(workerArgs, settings);
 
     eFilterSettings filterSettings;
     QDir(eSettings::sSettingsDir()).mkpath(eSettings::sIconsDir());
@@ -184,7 +193,7 @@ int main(int argc, char *argv[]) {
         gPrintExceptionCritical(e);
     }
     const auto splash = new EnveSplash;
-    splash->show();
+    if(!worker) splash->show();
     app.processEvents();
 
     splash->showMessage("Generate icons...");
@@ -271,6 +280,18 @@ int main(int argc, char *argv[]) {
     std::cout << "Render handler initialized" << std::endl;
 
     MainWindow w(document, actions, audioHandler, renderHandler);
+    if(worker) {
+        delete splash;
+        try {
+            w.loadEVFile(workerArgs.fEvFile, false);
+            if(!SegmentedRender::sStartWorker(workerArgs,
+                                              w.getRenderWidget())) return 1;
+            return app.exec();
+        } catch(const std::exception& e) {
+            gPrintExceptionCritical(e);
+            return 1;
+        }
+    }
     if(argc > 1) {
         try {
             splash->showMessage("Load file...");
@@ -23,6 +23,7 @@
 #include "CacheHandlers/soundcachecontainer.h"
 #include "CacheHandlers/sceneframecontainer.h"
 #include "Private/document.h"
+#include "Private/esettings.h"
 
 RenderHandler* RenderHandler::sInstance = nullptr;
 
@@ -38,6 +39,8 @@ RenderHandler::RenderHandler(Document &document,
 
     connect(&memoryHandler, &MemoryHandler::allMemoryUsed,
             this, &RenderHandler::outOfMemory);
+    connect(&document, &Document::activeSceneFrameSet,
+            this, &RenderHandler::playheadJumped);
 
     mPreviewFPSTimer = new QTimer(this);
     mPreviewFPSTimer->setTimerType(Qt::PreciseTimer);
@@ -95,11 +98,23 @@ void RenderHandler::renderFromSettings(RenderInstanceSettings * const settings)
         mCurrentSoundComposition->setMinFrameUseRange(mCurrentRenderFrame);
         mCurrentSoundComposition->scheduleFrameRange({mCurrentRenderFrame,
                                                       mCurrentRenderFrame});
+        mCurrentScene->bakeAnimationCurves({mMinRenderFrame, mMaxRenderFrame});
         mCurrentScene->anim_setAbsFrame(mCurrentRenderFrame);
         mCurrentScene->setOutputRendering(true);
         TaskScheduler::instance()->setAlwaysQue(true);
         //fitSceneToSize();
-        if(!isZero6Dec(mSavedResolutionFraction - resolutionFraction)) {
+        if(!VideoEncoder::sEncodeVideo()) {
+            // audio only, scene frames do not have to be rendered
+            mCurrentRenderFrame = mMaxRenderFrame;
+            mCurrRenderRange.fMax = mMaxRenderFrame;
+            mCurrentEncodeFrame = mMaxRenderFrame + 1;
+            mCurrentSoundComposition->scheduleFrameRange({mMinRenderFrame,
+                                                          mMaxRenderFrame});
+            mCurrentSoundComposition->setMaxFrameUseRange(mMaxRenderFrame);
+            if(TaskScheduler::sAllQuedCpuTasksFinished()) {
+                nextSaveOutputFrame();
+            }
+        } else if(!isZero6Dec(mSavedResolutionFraction - resolutionFraction)) {
             mCurrentScene->setResolution(resolutionFraction);
             mDocument.actionFinished();
         } else {
@@ -138,6 +153,10 @@ void RenderHandler::nextCurrentRenderFrame() {
 
     mCurrentRenderFrame = newCurrentRenderFrame;
     mCurrRenderRange.fMax = mCurrentRenderFrame;
+    if(mRenderingPreview) {
+        const auto deadline = previewFrameDeadline(mCurrentRenderFrame);
+        mCurrentScene->setFrameDeadline(deadline);
+    }
     if(allDone) Document::sInstance->actionFinished();
     else setFrameAction(mCurrentRenderFrame);
 }
@@ -147,11 +166,12 @@ void RenderHandler::setPreviewState(const PreviewSate state) {
     if(mPreviewSate == PreviewSate::stopped) {
         setRenderingPreview(true);
     } else if(mPreviewSate == PreviewSate::rendering) {
-        setRenderingPreview(false);
+        if(!mStreamingPreview) setRenderingPreview(false);
         if(state == PreviewSate::playing) {
             setPreviewing(true);
         }
     } else if(state == PreviewSate::stopped) {
+        if(mRenderingPreview) setRenderingPreview(false);
         setPreviewing(false);
     }
     mPreviewSate = state;
@@ -199,7 +219,10 @@ void RenderHandler::outOfMemory() {
 
 void RenderHandler::setRenderingPreview(const bool rendering) {
     mRenderingPreview = rendering;
-    if(mCurrentScene) mCurrentScene->setRenderingPreview(rendering);
+    if(mCurrentScene) {
+        mCurrentScene->setRenderingPreview(rendering);
+        if(!rendering) mCurrentScene->setFrameDeadline(-1);
+    }
     TaskScheduler::instance()->setAlwaysQue(rendering);
 }
 
@@ -214,7 +237,10 @@ void RenderHandler::interruptPreviewRendering() {
 }
 
 void RenderHandler::interruptOutputRendering() {
-    if(mCurrentScene) mCurrentScene->setOutputRendering(false);
+    if(mCurrentScene) {
+        mCurrentScene->setOutputRendering(false);
+        mCurrentScene->clearBakedAnimationCurves();
+    }
     TaskScheduler::instance()->setAlwaysQue(false);
     TaskScheduler::sClearAllFinishedFuncs();
     stopPreview();
@@ -229,6 +255,10 @@ void RenderHandler::stopPreview() {
         emit mCurrentScene->requestUpdate();
     }
 
+    if(mStreamingPreview) {
+        mStreamingPreview = false;
+        TaskScheduler::sClearAllFinishedFuncs();
+    }
     mPreviewFPSTimer->stop();
     stopAudio();
     emit previewFinished();
@@ -247,6 +277,7 @@ void RenderHandler::pausePreview() {
 void RenderHandler::resumePreview() {
     if(mPreviewing) {
         mAudioHandler.resumeAudio();
+        if(!mAudioClock) restartPreviewClock();
         mPreviewFPSTimer->start();
         emit previewBeingPlayed();
         setPreviewState(PreviewSate::playing);
@@ -269,33 +300,82 @@ void RenderHandler::playPreviewAfterAllTasksCompleted() {
 
 void RenderHandler::playPreview() {
     if(!mCurrentScene) return;
+    if(mStreamingPreview) return finishRenderingAhead();
     //setFrameAction(mSavedCurrentFrame);
     TaskScheduler::sClearAllFinishedFuncs();
     const int minPreviewFrame = mSavedCurrentFrame;
     const int maxPreviewFrame = qMin(mMaxRenderFrame, mCurrentRenderFrame);
     if(minPreviewFrame >= maxPreviewFrame) return;
-    mMinPreviewFrame = mLoop ? mCurrentScene->getMinFrame() : minPreviewFrame;
-    mMaxPreviewFrame = maxPreviewFrame;
-    mCurrentPreviewFrame = minPreviewFrame;
+    startPlayback(minPreviewFrame, maxPreviewFrame);
+}
+
+void RenderHandler::playheadJumped(const int frame) {
+    if(mPreviewSate != PreviewSate::rendering || mLoop) return;
+    if(*mDocument.fActiveScene != mCurrentScene) return;
+    // frames qued ahead of the previous position are still awaited,
+    // but should not hold back the frames after the new one
+    const auto scheduler = TaskScheduler::instance();
+    scheduler->demoteQuedTasks(eTaskPriority::lookahead,
+                               eTaskPriority::housekeeping);
+    mSavedCurrentFrame = frame;
+    mCurrentRenderFrame = frame;
+    mCurrRenderRange = {frame, frame};
+    mCurrentScene->setMinFrameUseRange(frame);
+    mCurrentSoundComposition->setMinFrameUseRange(frame);
+}
+
+qint64 RenderHandler::previewFrameDeadline(const int frame) {
+    const qreal fps = mCurrentScene->getFps();
+    const qreal playbackFrame = mPreviewSate == PreviewSate::playing ?
+                previewClockFrame() : mSavedCurrentFrame;
+    return eTask::sDeadlineIn(qRound((frame - playbackFrame)*1000/fps));
+}
+
+void RenderHandler::startPlayback(const int minFrame, const int maxFrame) {
+    mMinPreviewFrame = mLoop ? mCurrentScene->getMinFrame() : minFrame;
+    mMaxPreviewFrame = maxFrame;
+    mCurrentPreviewFrame = minFrame;
     mCurrentScene->setSceneFrame(mCurrentPreviewFrame);
+    setDroppedFrames(0);
 
     setPreviewState(PreviewSate::playing);
 
     startAudio();
 
-    const int mSecInterval = qRound(1000/mCurrentScene->getFps());
+    // the timer only polls the clock, frames are picked based on the clock
+    const int mSecInterval = qMax(1, qFloor(250/mCurrentScene->getFps()));
     mPreviewFPSTimer->setInterval(mSecInterval);
     mPreviewFPSTimer->start();
     emit previewBeingPlayed();
     emit mCurrentScene->requestUpdate();
 }
 
+void RenderHandler::startStreamingIfLeadCached() {
+    const int leadFrames = eSettings::instance().fPreviewLeadFrames;
+    if(leadFrames <= 0) return;
+    const auto& cacheHandler = mCurrentScene->getSceneFramesHandler();
+    const int firstEmpty = cacheHandler.firstEmptyFrameAtOrAfter(mSavedCurrentFrame);
+    if(firstEmpty - mSavedCurrentFrame < leadFrames) return;
+    mStreamingPreview = true;
+    startPlayback(mSavedCurrentFrame, mMaxRenderFrame);
+}
+
+void RenderHandler::finishRenderingAhead() {
+    TaskScheduler::sClearAllFinishedFuncs();
+    mStreamingPreview = false;
+    setRenderingPreview(false);
+    mMaxPreviewFrame = qMin(mMaxRenderFrame, mCurrentRenderFrame);
+}
+
 void RenderHandler::nextPreviewRenderFrame() {
     if(!mRenderingPreview) return;
     if(mCurrentRenderFrame >= mMaxRenderFrame) {
         playPreviewAfterAllTasksCompleted();
     } else {
         nextCurrentRenderFrame();
+        if(mPreviewSate == PreviewSate::rendering) {
+            startStreamingIfLeadCached();
+        }
         if(TaskScheduler::sAllTasksFinished()) {
             nextPreviewRenderFrame();
         }
@@ -304,26 +384,65 @@ void RenderHandler::nextPreviewRenderFrame() {
 
 void RenderHandler::nextPreviewFrame() {
     if(!mCurrentScene) return;
-    mCurrentPreviewFrame++;
-    if(mCurrentPreviewFrame > mMaxPreviewFrame) {
+    const int targetFrame = qFloor(previewClockFrame());
+    if(targetFrame <= mCurrentPreviewFrame) return;
+    if(mCurrentPreviewFrame >= mMaxPreviewFrame) {
         if(mLoop) {
-            mCurrentPreviewFrame = mMinPreviewFrame - 1;
-            nextPreviewFrame();
+            mCurrentPreviewFrame = mMinPreviewFrame;
+            mCurrentScene->setSceneFrame(mCurrentPreviewFrame);
+            emit mCurrentScene->currentFrameChanged(mCurrentPreviewFrame);
+            emit mCurrentScene->requestUpdate();
             stopAudio();
             startAudio();
         } else stopPreview();
-    } else {
-        mCurrentScene->setSceneFrame(mCurrentPreviewFrame);
-        if(!mLoop) mCurrentScene->setMinFrameUseRange(mCurrentPreviewFrame);
-        emit mCurrentScene->currentFrameChanged(mCurrentPreviewFrame);
+        return;
+    }
+    const auto& cacheHandler = mCurrentScene->getSceneFramesHandler();
+    const int lastFrame = qMin(targetFrame, mMaxPreviewFrame);
+    int frame = mCurrentPreviewFrame;
+    while(frame < lastFrame && cacheHandler.atFrame(frame + 1)) frame++;
+    if(frame == mCurrentPreviewFrame) {
+        // next frame is not rendered yet, hold the current one;
+        // the audio clock cannot wait, later frames will be dropped instead
+        if(!mAudioClock) restartPreviewClock();
+        return;
     }
+    const int dropped = frame - mCurrentPreviewFrame - 1;
+    if(dropped > 0) setDroppedFrames(mDroppedFrames + dropped);
+    mCurrentPreviewFrame = frame;
+    mCurrentScene->setSceneFrame(mCurrentPreviewFrame);
+    if(!mLoop) mCurrentScene->setMinFrameUseRange(mCurrentPreviewFrame);
+    emit mCurrentScene->currentFrameChanged(mCurrentPreviewFrame);
     emit mCurrentScene->requestUpdate();
 }
 
+qreal RenderHandler::previewClockFrame() {
+    const qreal fps = mCurrentScene->getFps();
+    if(mAudioClock) {
+        const qint64 uSecs = mAudioHandler.processedUSecs();
+        if(uSecs >= 0) return mPreviewClockFrame + uSecs*fps/1000000;
+        // audio output failed, continue with the wall clock
+        restartPreviewClock();
+        mAudioClock = false;
+    }
+    return mPreviewClockFrame + mPreviewClock.nsecsElapsed()*fps/1000000000;
+}
+
+void RenderHandler::restartPreviewClock() {
+    mPreviewClockFrame = mCurrentPreviewFrame;
+    mPreviewClock.start();
+}
+
+void RenderHandler::setDroppedFrames(const int count) {
+    mDroppedFrames = count;
+    emit previewFramesDropped(count);
+}
+
 void RenderHandler::finishEncoding() {
     TaskScheduler::sClearAllFinishedFuncs();
     mCurrentRenderSettings = nullptr;
     mCurrentScene->setOutputRendering(false);
+    mCurrentScene->clearBakedAnimationCurves();
     TaskScheduler::instance()->setAlwaysQue(false);
     setFrameAction(mSavedCurrentFrame);
     if(!isZero4Dec(mSavedResolutionFraction - mCurrentScene->getResolution())) {
@@ -390,6 +509,9 @@ void RenderHandler::startAudio() {
     if(mCurrentSoundComposition)
         mCurrentSoundComposition->start(mCurrentPreviewFrame);
     audioPushTimerExpired();
+    mAudioClock = mCurrentSoundComposition &&
+                  mCurrentSoundComposition->hasAnySounds();
+    restartPreviewClock();
 }
 
 void RenderHandler::stopAudio() {
@@ -16,6 +16,8 @@
 
 #ifndef RENDERHANDLER_H
 #define RENDERHANDLER_H
+#include <QElapsedTimer>
+
 #include "framerange.h"
 #include "GUI/audiohandler.h"
 #include "smartPointers/ememory.h"
@@ -64,6 +66,7 @@ signals:
     void previewPaused();
     void previewBeingPlayed();
     void previewFinished();
+    void previewFramesDropped(const int count);
 private:
     void setFrameAction(const int frame);
     void setCurrentScene(Canvas * const scene);
@@ -76,6 +79,19 @@ private:
     void nextPreviewFrame();
     void nextCurrentRenderFrame();
 
+    void playheadJumped(const int frame);
+    //! @brief Deadline of a frame rendered ahead, based on when
+    //! the playback reaches it
+    qint64 previewFrameDeadline(const int frame);
+
+    void startPlayback(const int minFrame, const int maxFrame);
+    void startStreamingIfLeadCached();
+    void finishRenderingAhead();
+
+    qreal previewClockFrame();
+    void restartPreviewClock();
+    void setDroppedFrames(const int count);
+
     void setPreviewState(const PreviewSate state);
     void setRenderingPreview(const bool rendering);
     void setPreviewing(const bool previewing);
@@ -107,6 +123,14 @@ private:
     bool mPreviewing = false;
     //! @brief true if currently preview is being rendered
     bool mRenderingPreview = false;
+    //! @brief true if preview is played while still rendering ahead
+    bool mStreamingPreview = false;
+
+    //! @brief true if playback follows the audio output position
+    bool mAudioClock = false;
+    QElapsedTimer mPreviewClock;
+    int mPreviewClockFrame = 0;
+    int mDroppedFrames = 0;
 
     int mCurrentEncodeFrame;
     int mCurrentEncodeSoundSecond;
@@ -0,0 +1,559 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "segmentedrender.h"
+
+#include <QCoreApplication>
+#include <QPointer>
+#include <QFileInfo>
+#include <QDir>
+#include <QDebug>
+#include <iostream>
+#include <cstring>
+
+#include "renderinstancesettings.h"
+#include "renderhandler.h"
+#include "videoencoder.h"
+#include "canvas.h"
+#include "Sound/soundcomposition.h"
+#include "Private/document.h"
+#include "Private/esettings.h"
+#include "GUI/mainwindow.h"
+#include "GUI/RenderWidgets/renderwidget.h"
+
+#define AV_RuntimeThrow(errId, message) \
+{ \
+    char * const errMsg = new char[AV_ERROR_MAX_STRING_SIZE]; \
+    av_make_error_string(errMsg, AV_ERROR_MAX_STRING_SIZE, errId); \
+    try { \
+        RuntimeThrow(errMsg); \
+    } catch(...) { \
+        delete[] errMsg; \
+        RuntimeThrow(message); \
+    } \
+}
+
+#define WORKER_ARG "--render-segment"
+#define FRAME_PREFIX "enve-segment-frame "
+// segments are written to a container that accepts any codec
+#define SEGMENT_FORMAT "matroska"
+
+QStringList SegmentedRender::WorkerArgs::toArguments() const {
+    return {fEvFile, WORKER_ARG,
+            QString::number(fQueueId),
+            QString::number(fRange.fMin),
+            QString::number(fRange.fMax),
+            fOutput, fAudio ? "audio" : "video",
+            QString::number(fCpuThreads),
+            QString::number(fRamMB)};
+}
+
+bool SegmentedRender::WorkerArgs::sParse(const QStringList& args,
+                                         WorkerArgs& result) {
+    if(args.count() != 10 || args.at(2) != WORKER_ARG) return false;
+    bool ok = true;
+    const auto toInt = [&ok, &args](const int id) {
+        bool iOk;
+        const int value = args.at(id).toInt(&iOk);
+        ok = ok && iOk;
+        return value;
+    };
+    result.fEvFile = args.at(1);
+    result.fQueueId = toInt(3);
+    result.fRange = {toInt(4), toInt(5)};
+    result.fOutput = args.at(6);
+    result.fAudio = args.at(7) == "audio";
+    result.fCpuThreads = toInt(8);
+    result.fRamMB = toInt(9);
+    return ok;
+}
+
+class SegmentMuxer : public eHddTask {
+    e_OBJECT
+protected:
+    SegmentMuxer(SegmentedRender * const render) : mRender(render) {
+        setPriority(eTaskPriority::output);
+        const auto& settings = render->mSettings;
+        const auto& renderSettings = settings.getRenderSettings();
+        mFrameTimeBase = renderSettings.fTimeBase;
+        mOutput = settings.getOutputDestination();
+        mOutputFormat = settings.getOutputRenderSettings().fOutputFormat;
+        for(const auto& worker : render->mWorkers) {
+            if(worker.fArgs.fAudio) continue;
+            mSegments << worker.fArgs.fOutput;
+            mFrameOffsets << worker.fArgs.fRange.fMin - renderSettings.fMinFrame;
+        }
+        mAudio = render->mAudioFile;
+    }
+public:
+    void process();
+protected:
+    void afterProcessing() {
+        if(mRender) mRender->muxingFinished();
+    }
+
+    void afterCanceled() {
+        if(mRender) mRender->fail("Could not join the segments");
+    }
+private:
+    const QPointer<SegmentedRender> mRender;
+    AVRational mFrameTimeBase;
+    QString mOutput;
+    const AVOutputFormat* mOutputFormat;
+    QStringList mSegments;
+    QList<int> mFrameOffsets;
+    QString mAudio;
+};
+
+struct MuxInput {
+    ~MuxInput() {
+        if(fContext) avformat_close_input(&fContext);
+    }
+
+    void open(const QString& path, const AVMediaType type) {
+        const auto pathBA = path.toUtf8();
+        int ret = avformat_open_input(&fContext, pathBA.constData(),
+                                      nullptr, nullptr);
+        if(ret < 0) AV_RuntimeThrow(ret, "Could not open " + path)
+        ret = avformat_find_stream_info(fContext, nullptr);
+        if(ret < 0) AV_RuntimeThrow(ret, "Could not find streams in " + path)
+        fStreamId = av_find_best_stream(fContext, type, -1, -1, nullptr, 0);
+        if(fStreamId < 0) RuntimeThrow("No matching stream in " + path);
+    }
+
+    AVStream* stream() const {
+        return fContext->streams[fStreamId];
+    }
+
+    //! @brief Returns false at the end of the input
+    bool read(AVPacket* const pkt) {
+        while(av_read_frame(fContext, pkt) >= 0) {
+            if(pkt->stream_index == fStreamId) return true;
+            av_packet_unref(pkt);
+        }
+        return false;
+    }
+
+    AVFormatContext* fContext = nullptr;
+    int fStreamId = -1;
+};
+
+//! @brief Segments can only be joined if they were encoded the same way
+static bool sameParameters(const AVCodecParameters* const a,
+                           const AVCodecParameters* const b) {
+    if(a->codec_id != b->codec_id) return false;
+    if(a->format != b->format) return false;
+    if(a->width != b->width || a->height != b->height) return false;
+    if(a->profile != b->profile || a->level != b->level) return false;
+    if(a->extradata_size != b->extradata_size) return false;
+    if(a->extradata_size == 0) return true;
+    return memcmp(a->extradata, b->extradata,
+                  static_cast<size_t>(a->extradata_size)) == 0;
+}
+
+struct MuxOutput {
+    ~MuxOutput() {
+        if(!fContext) return;
+        if(fContext->pb) avio_closep(&fContext->pb);
+        avformat_free_context(fContext);
+    }
+
+    AVStream* addStream(const AVStream* const src) {
+        const auto stream = avformat_new_stream(fContext, nullptr);
+        if(!stream) RuntimeThrow("Could not alloc stream");
+        const int ret = avcodec_parameters_copy(stream->codecpar,
+                                                src->codecpar);
+        if(ret < 0) AV_RuntimeThrow(ret, "Could not copy the stream parameters")
+        stream->codecpar->codec_tag = 0;
+        return stream;
+    }
+
+    AVFormatContext* fContext = nullptr;
+};
+
+void SegmentMuxer::process() {
+    const int nSegments = mSegments.count();
+    QList<std::shared_ptr<MuxInput>> videoInputs;
+    for(const auto& segment : mSegments) {
+        const auto input = std::make_shared<MuxInput>();
+        input->open(segment, AVMEDIA_TYPE_VIDEO);
+        if(!videoInputs.isEmpty()) {
+            const auto first = videoInputs.first()->stream()->codecpar;
+            if(!sameParameters(first, input->stream()->codecpar))
+                RuntimeThrow("Segment " + segment + " was encoded "
+                             "with different parameters");
+        }
+        videoInputs << input;
+    }
+    MuxInput audioInput;
+    const bool hasAudio = !mAudio.isEmpty();
+    if(hasAudio) audioInput.open(mAudio, AVMEDIA_TYPE_AUDIO);
+
+    MuxOutput output;
+    const auto pathBA = mOutput.toUtf8();
+    int ret = avformat_alloc_output_context2(
+                &output.fContext, const_cast<AVOutputFormat*>(mOutputFormat),
+                nullptr, pathBA.constData());
+    if(ret < 0) AV_RuntimeThrow(ret, "Could not create output for " + mOutput)
+    const auto videoStream = output.addStream(videoInputs.first()->stream());
+    videoStream->time_base = mFrameTimeBase;
+    AVStream* audioStream = nullptr;
+    if(hasAudio) {
+        audioStream = output.addStream(audioInput.stream());
+        audioStream->time_base = {1, audioStream->codecpar->sample_rate};
+    }
+    if(!(output.fContext->oformat->flags & AVFMT_NOFILE)) {
+        ret = avio_open(&output.fContext->pb, pathBA.constData(),
+                        AVIO_FLAG_WRITE);
+        if(ret < 0) AV_RuntimeThrow(ret, "Could not open " + mOutput)
+    }
+    ret = avformat_write_header(output.fContext, nullptr);
+    if(ret < 0) AV_RuntimeThrow(ret, "Could not write header to " + mOutput)
+
+    AVPacket videoPkt;
+    av_init_packet(&videoPkt);
+    AVPacket audioPkt;
+    av_init_packet(&audioPkt);
+
+    int segment = 0;
+    int64_t lastVideoDts = AV_NOPTS_VALUE;
+    int nClamped = 0;
+    const auto readVideo = [&]() {
+        for(; segment < nSegments; segment++) {
+            const auto& input = videoInputs.at(segment);
+            if(!input->read(&videoPkt)) continue;
+            const auto inTimeBase = input->stream()->time_base;
+            // segments store timestamps with their own precision,
+            // rounding back to frames recovers the exact values
+            const int64_t offset = mFrameOffsets.at(segment);
+            const auto toOutput = [&](const int64_t ts) {
+                if(ts == AV_NOPTS_VALUE) return ts;
+                const int64_t frame = av_rescale_q_rnd(
+                            ts, inTimeBase, mFrameTimeBase,
+                            AV_ROUND_NEAR_INF) + offset;
+                return av_rescale_q(frame, mFrameTimeBase,
+                                    videoStream->time_base);
+            };
+            videoPkt.pts = toOutput(videoPkt.pts);
+            videoPkt.dts = toOutput(videoPkt.dts);
+            videoPkt.duration = av_rescale_q(videoPkt.duration, inTimeBase,
+                                             videoStream->time_base);
+            // the first packets of a segment can have dts before the last
+            // packets of the previous one when the codec reorders frames
+            if(videoPkt.dts != AV_NOPTS_VALUE) {
+                if(lastVideoDts != AV_NOPTS_VALUE &&
+                   videoPkt.dts <= lastVideoDts) {
+                    videoPkt.dts = lastVideoDts + 1;
+                    nClamped++;
+                }
+                if(videoPkt.pts != AV_NOPTS_VALUE &&
+                   videoPkt.pts < videoPkt.dts) {
+                    videoPkt.pts = videoPkt.dts;
+                }
+                lastVideoDts = videoPkt.dts;
+            }
+            videoPkt.stream_index = videoStream->index;
+            return true;
+        }
+        return false;
+    };
+    const auto readAudio = [&]() {
+        if(!hasAudio || !audioInput.read(&audioPkt)) return false;
+        av_packet_rescale_ts(&audioPkt, audioInput.stream()->time_base,
+                             audioStream->time_base);
+        audioPkt.stream_index = audioStream->index;
+        return true;
+    };
+
+    bool video = readVideo();
+    bool audio = readAudio();
+    while(video || audio) {
+        bool writeVideo = video;
+        if(video && audio) {
+            writeVideo = av_compare_ts(videoPkt.dts, videoStream->time_base,
+                                       audioPkt.dts, audioStream->time_base) <= 0;
+        }
+        // takes ownership of the packet data
+        if(writeVideo) {
+            ret = av_interleaved_write_frame(output.fContext, &videoPkt);
+            video = readVideo();
+        } else {
+            ret = av_interleaved_write_frame(output.fContext, &audioPkt);
+            audio = readAudio();
+        }
+        if(ret < 0) {
+            av_packet_unref(&videoPkt);
+            av_packet_unref(&audioPkt);
+            AV_RuntimeThrow(ret, "Could not write packet to " + mOutput)
+        }
+    }
+
+    ret = av_write_trailer(output.fContext);
+    if(ret < 0) AV_RuntimeThrow(ret, "Could not write trailer to " + mOutput)
+    if(nClamped > 0) {
+        qWarning() << "Shifted the timestamps of" << nClamped <<
+                      "packets while joining segments of" << mOutput;
+    }
+}
+
+static QString snapshotPath(const QTemporaryDir& tmpDir) {
+    // relative paths in the snapshot have to match the document
+    const auto& evFile = Document::sInstance->fEvFile;
+    if(evFile.isEmpty()) return tmpDir.filePath("snapshot.ev");
+    const QFileInfo info(evFile);
+    return info.dir().filePath("." + info.completeBaseName() +
+                               ".segments.ev");
+}
+
+static QString tmpDirTemplate(const RenderInstanceSettings& settings) {
+    // segments can be large, keep them on the output file system
+    const QFileInfo info(settings.getOutputDestination());
+    return info.dir().filePath(".enve-segments-XXXXXX");
+}
+
+SegmentedRender::SegmentedRender(RenderInstanceSettings& settings,
+                                 const int queueId, const int nSegments,
+                                 QObject * const parent) :
+    QObject(parent), mSettings(settings), mQueueId(queueId),
+    mNSegments(nSegments), mTmpDir(tmpDirTemplate(settings)) {}
+
+SegmentedRender::~SegmentedRender() {
+    killWorkers();
+    if(!mSnapshot.isEmpty()) QFile::remove(mSnapshot);
+}
+
+bool SegmentedRender::sSupported(const RenderInstanceSettings& settings,
+                                 const int nSegments) {
+    if(nSegments <= 1) return false;
+    const auto& outputSettings = settings.getOutputRenderSettings();
+    if(!outputSettings.fVideoEnabled || !outputSettings.fVideoCodec)
+        return false;
+    const auto format = outputSettings.fOutputFormat;
+    if(!format || format->flags & AVFMT_NOFILE) return false;
+    const auto& renderSettings = settings.getRenderSettings();
+    const int nFrames = renderSettings.fMaxFrame - renderSettings.fMinFrame + 1;
+    return nFrames >= 2*nSegments;
+}
+
+void SegmentedRender::start() {
+    mSettings.renderingAboutToStart();
+    if(!mTmpDir.isValid()) return fail("Could not create segments folder");
+    mSnapshot = snapshotPath(mTmpDir);
+    const auto mainWindow = MainWindow::sGetInstance();
+    try {
+        mainWindow->saveToFile(mSnapshot, false);
+        if(!mainWindow->waitForBackgroundSaves())
+            RuntimeThrow("Could not write " + mSnapshot);
+    } catch(const std::exception& e) {
+        gPrintExceptionCritical(e);
+        return fail("Could not save the document for workers");
+    }
+
+    const auto& outputSettings = mSettings.getOutputRenderSettings();
+    const auto scene = mSettings.getTargetCanvas();
+    const bool audio = outputSettings.fAudioEnabled &&
+                       outputSettings.fOutputFormat->audio_codec != AV_CODEC_ID_NONE &&
+                       scene->getSoundComposition()->hasAnySounds();
+
+    const auto& renderSettings = mSettings.getRenderSettings();
+    const int minFrame = renderSettings.fMinFrame;
+    const int nFrames = renderSettings.fMaxFrame - minFrame + 1;
+    const int nProcesses = mNSegments + (audio ? 1 : 0);
+    WorkerArgs args;
+    args.fEvFile = mSnapshot;
+    args.fQueueId = mQueueId;
+    args.fCpuThreads = qMax(1, eSettings::sCpuThreadsCapped()/mNSegments);
+    // leave a share for this process
+    args.fRamMB = eSettings::sRamMBCap().fValue/(nProcesses + 1);
+    for(int i = 0; i < mNSegments; i++) {
+        args.fRange = {minFrame + nFrames*i/mNSegments,
+                       minFrame + nFrames*(i + 1)/mNSegments - 1};
+        args.fOutput = mTmpDir.filePath(QString("segment%1.mkv").arg(i));
+        args.fAudio = false;
+        startWorker(args);
+    }
+    if(audio) {
+        args.fRange = {minFrame, renderSettings.fMaxFrame};
+        args.fOutput = mTmpDir.filePath("audio.mkv");
+        args.fAudio = true;
+        mAudioFile = args.fOutput;
+        startWorker(args);
+    }
+    mSettings.setCurrentRenderFrame(minFrame);
+    mSettings.setCurrentState(RenderState::rendering);
+    emit started();
+}
+
+void SegmentedRender::startWorker(const WorkerArgs& args) {
+    const int id = mWorkers.count();
+    const auto process = new QProcess(this);
+    mWorkers << Worker{process, args, args.fRange.fMin, false, QByteArray()};
+    connect(process, &QProcess::readyReadStandardOutput,
+            this, [this, id]() { readWorkerOutput(id); });
+    connect(process, &QProcess::readyReadStandardError,
+            this, [this, id]() {
+        auto& errors = mWorkers[id].fErrors;
+        errors += mWorkers.at(id).fProcess->readAllStandardError();
+        // only the last messages are of interest
+        if(errors.size() > 4096) errors = errors.right(4096);
+    });
+    connect(process, qOverload<int, QProcess::ExitStatus>(&QProcess::finished),
+            this, [this, id](const int exitCode,
+                             const QProcess::ExitStatus exitStatus) {
+        workerFinished(id, exitCode, exitStatus);
+    });
+    process->start(QCoreApplication::applicationFilePath(),
+                   args.toArguments());
+}
+
+void SegmentedRender::readWorkerOutput(const int id) {
+    auto& worker = mWorkers[id];
+    bool changed = false;
+    while(worker.fProcess->canReadLine()) {
+        const QString line = worker.fProcess->readLine().trimmed();
+        if(!line.startsWith(FRAME_PREFIX)) continue;
+        bool ok;
+        const int frame = line.mid(int(sizeof(FRAME_PREFIX)) - 1).toInt(&ok);
+        if(!ok) continue;
+        worker.fFrame = frame;
+        changed = true;
+    }
+    if(changed) updateProgress();
+}
+
+void SegmentedRender::updateProgress() {
+    int done = 0;
+    for(const auto& worker : mWorkers) {
+        if(worker.fArgs.fAudio) continue;
+        const auto& range = worker.fArgs.fRange;
+        if(worker.fFinished) done += range.span();
+        else done += worker.fFrame - range.fMin;
+    }
+    const int minFrame = mSettings.getRenderSettings().fMinFrame;
+    mSettings.setCurrentRenderFrame(minFrame + done);
+}
+
+void SegmentedRender::workerFinished(const int id, const int exitCode,
+                                     const QProcess::ExitStatus exitStatus) {
+    if(mDone) return;
+    auto& worker = mWorkers[id];
+    if(exitStatus != QProcess::NormalExit || exitCode != 0) {
+        const auto& range = worker.fArgs.fRange;
+        QString error = worker.fArgs.fAudio ? "Audio worker failed" :
+                        QString("Segment %1 - %2 failed").arg(range.fMin).
+                                                          arg(range.fMax);
+        const auto details = QString::fromUtf8(worker.fErrors).trimmed();
+        if(!details.isEmpty()) error += ":\n" + details.right(512);
+        return fail(error);
+    }
+    worker.fFinished = true;
+    updateProgress();
+    for(const auto& other : mWorkers) {
+        if(!other.fFinished) return;
+    }
+    startMuxing();
+}
+
+void SegmentedRender::startMuxing() {
+    const auto muxer = enve::make_shared<SegmentMuxer>(this);
+    muxer->queTask();
+}
+
+void SegmentedRender::muxingFinished() {
+    if(mDone) {
+        QFile::remove(mSettings.getOutputDestination());
+        return;
+    }
+    mDone = true;
+    mSettings.setCurrentState(RenderState::finished);
+    emit finished();
+}
+
+void SegmentedRender::fail(const QString& error) {
+    if(mDone) return;
+    mDone = true;
+    killWorkers();
+    mSettings.setCurrentState(RenderState::error, error);
+    emit failed();
+}
+
+void SegmentedRender::interrupt() {
+    if(mDone) return;
+    mDone = true;
+    killWorkers();
+    mSettings.setCurrentState(RenderState::none, "Interrupted");
+    emit interrupted();
+}
+
+void SegmentedRender::killWorkers() {
+    for(const auto& worker : mWorkers) {
+        const auto process = worker.fProcess;
+        if(process->state() == QProcess::NotRunning) continue;
+        process->disconnect(this);
+        process->kill();
+        process->waitForFinished(1000);
+    }
+}
+
+void SegmentedRender::sApplyWorkerSettings(const WorkerArgs& args,
+                                           eSettings& settings) {
+    if(args.fCpuThreads > 0) settings.fCpuThreadsCap = args.fCpuThreads;
+    if(args.fRamMB > 0) settings.fRamMBCap = intMB(args.fRamMB);
+}
+
+bool SegmentedRender::sStartWorker(const WorkerArgs& args,
+                                   RenderWidget * const renderWidget) {
+    gSetExceptionDialogsEnabled(false);
+    const auto src = renderWidget->getRenderInstanceSettings(args.fQueueId);
+    if(!src || !src->getTargetCanvas()) {
+        qCritical() << "Render queue item" << args.fQueueId << "not found";
+        return false;
+    }
+    const auto settings = new RenderInstanceSettings(*src);
+    settings->setParent(renderWidget);
+
+    auto renderSettings = settings->getRenderSettings();
+    renderSettings.fMinFrame = args.fRange.fMin;
+    renderSettings.fMaxFrame = args.fRange.fMax;
+    settings->setRenderSettings(renderSettings);
+
+    auto outputSettings = settings->getOutputRenderSettings();
+    outputSettings.fOutputFormat = av_guess_format(SEGMENT_FORMAT,
+                                                   nullptr, nullptr);
+    if(args.fAudio) outputSettings.fVideoEnabled = false;
+    else outputSettings.fAudioEnabled = false;
+    settings->setOutputRenderSettings(outputSettings);
+    settings->setOutputDestination(args.fOutput);
+
+    QObject::connect(settings, &RenderInstanceSettings::renderFrameChanged,
+                     [](const int frame) {
+        std::cout << FRAME_PREFIX << frame << std::endl;
+    });
+
+    // without B-frames segments join without shifting timestamps
+    VideoEncoder::sSetFrameReordering(false);
+    RenderHandler::sInstance->renderFromSettings(settings);
+    if(!VideoEncoder::sEncodingSuccessfulyStarted()) return false;
+
+    const auto vidEmitter = VideoEncoder::sInstance->getEmitter();
+    QObject::connect(vidEmitter, &VideoEncoderEmitter::encodingFinished,
+                     []() { QCoreApplication::exit(0); });
+    QObject::connect(vidEmitter, &VideoEncoderEmitter::encodingFailed,
+                     []() { QCoreApplication::exit(1); });
+    QObject::connect(vidEmitter, &VideoEncoderEmitter::encodingInterrupted,
+                     []() { QCoreApplication::exit(1); });
+    return true;
+}
@@ -0,0 +1,109 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEGMENTEDRENDER_H
+#define SEGMENTEDRENDER_H
+
+#include <QObject>
+#include <QProcess>
+#include <QTemporaryDir>
+
+#include "framerange.h"
+
+class RenderInstanceSettings;
+class RenderWidget;
+class eSettings;
+
+//! @brief Renders a render queue item with local worker processes,
+//! each encoding a contiguous segment of the frame range to a temporary
+//! file. Video segments are concatenated at the packet level,
+//! audio is encoded once by a separate worker.
+class SegmentedRender : public QObject {
+    Q_OBJECT
+public:
+    //! @brief Command line arguments of a worker process
+    struct WorkerArgs {
+        QString fEvFile;
+        int fQueueId = -1;
+        FrameRange fRange;
+        QString fOutput;
+        //! @brief Encodes only audio if true, otherwise only video
+        bool fAudio = false;
+        int fCpuThreads = 0;
+        int fRamMB = 0;
+
+        QStringList toArguments() const;
+        //! @brief Returns false if the arguments do not start a worker
+        static bool sParse(const QStringList& args, WorkerArgs& result);
+    };
+
+    SegmentedRender(RenderInstanceSettings& settings,
+                    const int queueId, const int nSegments,
+                    QObject * const parent = nullptr);
+    ~SegmentedRender();
+
+    //! @brief Returns false if the item has to be rendered in this process
+    static bool sSupported(const RenderInstanceSettings& settings,
+                           const int nSegments);
+
+    //! @brief Saves a snapshot of the document and starts the workers
+    void start();
+    void interrupt();
+
+    //! @brief Limits the resources of a worker process
+    static void sApplyWorkerSettings(const WorkerArgs& args,
+                                     eSettings& settings);
+    //! @brief Starts rendering in a worker process, the application exits
+    //! once the segment is encoded. Returns false if it did not start.
+    static bool sStartWorker(const WorkerArgs& args,
+                             RenderWidget * const renderWidget);
+signals:
+    void started();
+    void finished();
+    void failed();
+    void interrupted();
+private:
+    struct Worker {
+        QProcess* fProcess;
+        WorkerArgs fArgs;
+        int fFrame;
+        bool fFinished;
+        QByteArray fErrors;
+    };
+
+    void startWorker(const WorkerArgs& args);
+    void readWorkerOutput(const int id);
+    void workerFinished(const int id, const int exitCode,
+                        const QProcess::ExitStatus exitStatus);
+    void updateProgress();
+    void startMuxing();
+    void muxingFinished();
+    void fail(const QString& error);
+    void killWorkers();
+
+    RenderInstanceSettings& mSettings;
+    const int mQueueId;
+    const int mNSegments;
+    QTemporaryDir mTmpDir;
+    QString mSnapshot;
+    QString mAudioFile;
+    QList<Worker> mWorkers;
+    bool mDone = false;
+
+    friend class SegmentMuxer;
+};
+
+#endif // SEGMENTEDRENDER_H
@@ -91,7 +91,8 @@ static void openVideo(const AVCodec * const codec, OutputStream * const ost) {
 static void addVideoStream(OutputStream * const ost,
                            AVFormatContext * const oc,
                            const OutputSettings &outSettings,
-                           const RenderSettings &renSettings) {
+                           const RenderSettings &renSettings,
+                           const bool frameReordering) {
     const AVCodec * const codec = outSettings.fVideoCodec;
 
 //    if(!codec) {
@@ -134,6 +135,7 @@ static void addVideoStream(OutputStream * const ost,
          * the motion of the chroma plane does not match the luma plane. */
         c->mb_decision = 2;
     }
+    if(!frameReordering) c->max_b_frames = 0;
     /* Some formats want stream headers to be separate. */
     if(oc->oformat->flags & AVFMT_GLOBALHEADER) {
         c->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
@@ -425,7 +427,8 @@ void VideoEncoder::startEncodingNow() {
     if(mOutputSettings.fVideoCodec && mOutputSettings.fVideoEnabled) {
         try {
             addVideoStream(&mVideoStream, mFormatContext,
-                           mOutputSettings, mRenderSettings);
+                           mOutputSettings, mRenderSettings,
+                           mFrameReordering);
         } catch (...) {
             RuntimeThrow("Error adding video stream");
         }
@@ -714,6 +717,14 @@ bool VideoEncoder::sEncodeAudio() {
     return sInstance->mEncodeAudio;
 }
 
+bool VideoEncoder::sEncodeVideo() {
+    return sInstance->mEncodeVideo;
+}
+
+void VideoEncoder::sSetFrameReordering(const bool reorder) {
+    sInstance->mFrameReordering = reorder;
+}
+
 void VideoEncoder::sInterruptEncoding() {
     sInstance->interruptCurrentEncoding();
 }
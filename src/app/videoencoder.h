@@ -207,6 +207,10 @@ public:
     static void sFinishEncoding();
     static bool sEncodingSuccessfulyStarted();
     static bool sEncodeAudio();
+    static bool sEncodeVideo();
+    //! @brief Disables B-frames, so that separately encoded
+    //! segments can be joined without shifting timestamps
+    static void sSetFrameReordering(const bool reorder);
 
     VideoEncoderEmitter *getEmitter() {
         return &mEmitter;
@@ -243,6 +247,7 @@ protected:
     QByteArray mPathByteArray;
     bool mEncodeVideo = false;
     bool mEncodeAudio = false;
+    bool mFrameReordering = true;
     bool mAllAudioProvided = false;
 
     bool _mAllAudioProvided = false;
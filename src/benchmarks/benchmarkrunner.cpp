@@ -0,0 +1,99 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "benchmarkrunner.h"
+
+#include <algorithm>
+#include <iostream>
+#include <QElapsedTimer>
+
+#include "exceptions.h"
+
+BenchmarkRunner::BenchmarkRunner(const int iterations,
+                                 const QString& filter) :
+    mIterations(qMax(1, iterations)), mFilter(filter) {}
+
+void BenchmarkRunner::run(const QString& name, const QJsonObject& params,
+                          const Func& func, const Func& setup) {
+    if(!enabled(name)) return;
+    std::cerr << "Running " << name.toStdString() << std::endl;
+    QList<qint64> times;
+    try {
+        // warm up caches and lazily initialized state
+        if(setup) setup();
+        func();
+        QElapsedTimer timer;
+        for(int i = 0; i < mIterations; i++) {
+            if(setup) setup();
+            timer.start();
+            func();
+            times << timer.nsecsElapsed();
+        }
+    } catch(const std::exception& e) {
+        return skip(name, gAllTextFromException(e));
+    }
+    std::sort(times.begin(), times.end());
+    qint64 total = 0;
+    for(const qint64 time : times) total += time;
+    const int n = times.count();
+    const qreal median = n % 2 ? times.at(n/2) :
+                                 0.5*(times.at(n/2 - 1) + times.at(n/2));
+    QJsonObject result;
+    result["name"] = name;
+    result["params"] = params;
+    result["iterations"] = n;
+    result["minUs"] = times.first()*0.001;
+    result["medianUs"] = median*0.001;
+    result["meanUs"] = total*0.001/n;
+    result["maxUs"] = times.last()*0.001;
+    mResults.append(result);
+}
+
+void BenchmarkRunner::skip(const QString& name, const QString& reason) {
+    if(!enabled(name)) return;
+    std::cerr << "Skipped " << name.toStdString() << ": " <<
+                 reason.toStdString() << std::endl;
+    QJsonObject result;
+    result["name"] = name;
+    result["skipped"] = reason;
+    mResults.append(result);
+}
+
+void BenchmarkRunner::check(const QString& name, const QJsonObject& params,
+                            const Func& func) {
+    if(!enabled(name)) return;
+    std::cerr << "Checking " << name.toStdString() << std::endl;
+    QJsonObject result;
+    result["name"] = name;
+    result["params"] = params;
+    try {
+        func();
+        result["passed"] = true;
+    } catch(const std::exception& e) {
+        const QString error = gAllTextFromException(e);
+        std::cerr << "Failed " << name.toStdString() << ": " <<
+                     error.toStdString() << std::endl;
+        result["passed"] = false;
+        result["error"] = error;
+        mFailed = true;
+    }
+    mResults.append(result);
+}
+
+bool BenchmarkRunner::enabled(const QString& name) const {
+    return mFilter.isEmpty() || name.contains(mFilter);
+}
@@ -0,0 +1,56 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef BENCHMARKRUNNER_H
+#define BENCHMARKRUNNER_H
+
+#include <functional>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+
+//! @brief Times benchmark functions and collects the results as JSON.
+class BenchmarkRunner {
+public:
+    using Func = std::function<void()>;
+
+    BenchmarkRunner(const int iterations, const QString& filter);
+
+    //! @brief Times func over the iteration count,
+    //! setup is called before every iteration and excluded from the timing.
+    void run(const QString& name, const QJsonObject& params,
+             const Func& func, const Func& setup = nullptr);
+    //! @brief Records a benchmark that could not be run.
+    void skip(const QString& name, const QString& reason);
+    //! @brief Runs a consistency check once, func throws on failure.
+    void check(const QString& name, const QJsonObject& params,
+               const Func& func);
+
+    bool failed() const { return mFailed; }
+
+    bool enabled(const QString& name) const;
+    int iterations() const { return mIterations; }
+
+    QJsonArray results() const { return mResults; }
+private:
+    const int mIterations;
+    const QString mFilter;
+    QJsonArray mResults;
+    bool mFailed = false;
+};
+
+#endif // BENCHMARKRUNNER_H
@@ -0,0 +1,50 @@
+# enve - 2D animations software
+# Copyright (C) 2016-2020 Maurycy Liebner
+
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+QT += multimedia core gui svg opengl sql qml xml concurrent
+LIBS += -lavutil -lavformat -lavcodec -lswscale -lswresample
+CONFIG += c++14 console
+CONFIG -= app_bundle
+DEFINES += QT_NO_FOREACH
+
+# Include third-party dependencies from core
+include(../core/core.pri)
+
+ENVE_CORE_FOLDER = ../core
+
+INCLUDEPATH += $$ENVE_CORE_FOLDER
+DEPENDPATH += $$ENVE_CORE_FOLDER
+LIBS += -L$$OUT_PWD/../core -lenvecore
+
+win32 { # Windows
+    CONFIG -= debug_and_release
+}
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TARGET = benchmarks
+TEMPLATE = app
+
+SOURCES += main.cpp \
+    benchmarkrunner.cpp \
+    kernelbenchmarks.cpp \
+    scenebenchmarks.cpp
+
+HEADERS += \
+    benchmarkrunner.h \
+    kernelbenchmarks.h \
+    scenebenchmarks.h
@@ -0,0 +1,219 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "kernelbenchmarks.h"
+
+#include <QImage>
+#include <QtMath>
+
+#include "benchmarkrunner.h"
+#include "pointhelpers.h"
+#include "pathoperations.h"
+#include "Animators/SmartPath/smartpath.h"
+#include "Paint/autotiledsurface.h"
+#include "Sound/soundmerger.h"
+#include "Sound/esoundsettings.h"
+#include "ShaderEffects/cpushaderprogram.h"
+
+static SkPath wavyCircle(const int nNodes, const qreal amplitude) {
+    SkPath path;
+    const qreal step = 2*M_PI/nNodes;
+    const auto pointAt = [&](const int i) {
+        const qreal angle = i*step;
+        const qreal radius = 200 + (i % 2 ? amplitude : -amplitude);
+        return SkPoint::Make(toSkScalar(radius*qCos(angle)),
+                             toSkScalar(radius*qSin(angle)));
+    };
+    path.moveTo(pointAt(0));
+    for(int i = 0; i < nNodes; i++) {
+        const SkPoint p0 = pointAt(i);
+        const SkPoint p3 = pointAt(i + 1);
+        const SkPoint tangent = SkPoint::Make(p0.y() - p3.y(),
+                                              p3.x() - p0.x());
+        path.cubicTo(p0 + tangent*0.2f, p3 + tangent*0.2f, p3);
+    }
+    path.close();
+    return path;
+}
+
+static void benchmarkTFromX(BenchmarkRunner& runner) {
+    const int calls = 10000;
+    const qCubicSegment1D seg(0, 0.05, 0.95, 1);
+    volatile qreal sink = 0;
+    runner.run("kernel/gTFromX", {{"calls", calls}}, [&]() {
+        for(int i = 0; i < calls; i++) {
+            sink = sink + gTFromX(seg, qreal(i)/calls);
+        }
+    });
+}
+
+static void benchmarkNodeListInterpolate(BenchmarkRunner& runner) {
+    const int nodes = 256;
+    const int calls = 100;
+    const SmartPath path1(wavyCircle(nodes, 0));
+    const SmartPath path2(wavyCircle(nodes, 40));
+    const auto& list1 = path1.getNodesRef();
+    const auto& list2 = path2.getNodesRef();
+    runner.run("kernel/NodeList::sInterpolate",
+               {{"nodes", nodes}, {"calls", calls}}, [&]() {
+        for(int i = 0; i < calls; i++) {
+            NodeList::sInterpolate(list1, list2, qreal(i)/calls);
+        }
+    });
+}
+
+static void benchmarkSolidify(BenchmarkRunner& runner) {
+    const auto src = wavyCircle(64, 20);
+    SkPath dst;
+    qreal width = 1;
+    // a different width every iteration bypasses the solidify cache
+    runner.run("kernel/gSolidify", {{"nodes", 64}}, [&]() {
+        gSolidify(width, src, &dst);
+    }, [&]() { width += 0.01; });
+    runner.run("kernel/gSolidify/cached", {{"nodes", 64}}, [&]() {
+        gSolidify(width, src, &dst);
+    });
+}
+
+static void benchmarkAutoTilesToBitmap(BenchmarkRunner& runner) {
+    const int dim = 2048;
+    QImage image(dim, dim, QImage::Format_RGBA8888_Premultiplied);
+    image.fill(QColor(255, 128, 0, 200));
+    AutoTiledSurface surface;
+    surface.loadPixmap(image);
+    runner.run("kernel/AutoTilesData::toBitmap",
+               {{"width", dim}, {"height", dim}}, [&]() {
+        surface.toBitmap();
+    });
+}
+
+static void benchmarkSoundMerger(BenchmarkRunner& runner) {
+    const auto& settings = eSoundSettings::sData();
+    const int sampleRate = settings.fSampleRate;
+    const SampleRange second{0, sampleRate - 1};
+    const int sounds = 8;
+    const auto merger = enve::make_shared<SoundMerger>(0, second, nullptr);
+    for(int i = 0; i < sounds; i++) {
+        const auto samples = enve::make_shared<Samples>(
+                    second, sampleRate, settings.fSampleFormat,
+                    settings.fChannelLayout);
+        samples->zeroAll();
+        // every other sound is stretched to cover resampling
+        const qreal stretch = i % 2 ? 1.5 : 1;
+        merger->addSoundToMerge({i*sampleRate/sounds, second,
+                                 QrealSnapshot(0.5), stretch, samples});
+    }
+    runner.run("kernel/SoundMerger::process",
+               {{"sounds", sounds}, {"sampleRate", sampleRate}}, [&]() {
+        merger->process();
+    });
+}
+
+//! @brief The Dots example shader, math, branches and texture sampling
+static const char* const sDotsShader = R"(
+#version 330 core
+layout(location = 0) out vec4 fragColor;
+
+in vec2 texCoord;
+layout(pixel_center_integer) in vec4 gl_FragCoord;
+
+uniform sampler2D texture;
+
+uniform vec2 translate;
+uniform float dotDistance;
+uniform float dotRadius;
+uniform float opacity;
+
+uniform vec2 scenePos;
+
+void main(void) {
+    bool inDot;
+    float mixAlpha;
+
+    vec2 transformedCoord = scenePos - translate + gl_FragCoord.xy;
+
+    vec2 dotID = floor(transformedCoord/dotDistance + 0.5);
+    vec2 posInDot = transformedCoord - dotID*dotDistance;
+    float distToCenter = sqrt(posInDot.x*posInDot.x +
+                              posInDot.y*posInDot.y);
+    float distToEdge = distToCenter - sqrt(dotRadius*dotRadius);
+    if(distToEdge > 0.f) {
+        inDot = false;
+    } else {
+        distToEdge = abs(distToEdge);
+        inDot = true;
+        if(distToEdge < 1.f) {
+            mixAlpha = opacity + distToEdge*(1. - opacity);
+        } else {
+            mixAlpha = 1.f;
+        }
+    }
+    vec4 texCol = texture2D(texture, texCoord);
+    if(inDot) {
+        fragColor =  vec4(mixAlpha*texCol.rgb, mixAlpha*texCol.a);
+    } else {
+        fragColor =  vec4(opacity*texCol.rgb, opacity*texCol.a);
+    }
+}
+)";
+
+static void benchmarkCpuShader(BenchmarkRunner& runner) {
+    const int width = 1920;
+    const int height = 1080;
+    const auto program = CpuShaderProgram::sCompile(sDotsShader);
+    CpuShaderProgram::Uniforms uniforms(
+                static_cast<size_t>(program->uniformCount()));
+    const auto setUniform = [&](const char* const name, const float value) {
+        const int index = program->uniformIndex(name);
+        if(index < 0) return;
+        auto& uniform = uniforms[static_cast<size_t>(index)];
+        for(auto& v : uniform.fV) v = value;
+    };
+    setUniform("dotDistance", 8);
+    setUniform("dotRadius", 8);
+    setUniform("opacity", 0.5f);
+
+    QImage srcImage(width, height, QImage::Format_RGBA8888_Premultiplied);
+    srcImage.fill(QColor(255, 128, 0, 200));
+    QImage dstImage(width, height, QImage::Format_RGBA8888_Premultiplied);
+    const auto toImage = [](QImage& image) {
+        CpuShaderProgram::Image result;
+        result.fPixels = image.bits();
+        result.fWidth = image.width();
+        result.fHeight = image.height();
+        result.fRowBytes = static_cast<size_t>(image.bytesPerLine());
+        result.fBGRA = false;
+        return result;
+    };
+    const auto src = toImage(srcImage);
+    const auto dst = toImage(dstImage);
+    // a single thread, renders split the frame into tiles across threads
+    runner.run("kernel/CpuShaderProgram::process",
+               {{"shader", "eDots"}, {"width", width},
+                {"height", height}, {"threads", 1}}, [&]() {
+        program->process(uniforms, src, dst, 0, 0);
+    });
+}
+
+void gRunKernelBenchmarks(BenchmarkRunner& runner) {
+    benchmarkTFromX(runner);
+    benchmarkNodeListInterpolate(runner);
+    benchmarkSolidify(runner);
+    benchmarkAutoTilesToBitmap(runner);
+    benchmarkSoundMerger(runner);
+    benchmarkCpuShader(runner);
+}
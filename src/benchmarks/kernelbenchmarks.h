@@ -0,0 +1,26 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef KERNELBENCHMARKS_H
+#define KERNELBENCHMARKS_H
+
+class BenchmarkRunner;
+
+//! @brief Benchmarks isolated kernels without setting up a scene.
+extern void gRunKernelBenchmarks(BenchmarkRunner& runner);
+
+#endif // KERNELBENCHMARKS_H
@@ -0,0 +1,126 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <iostream>
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonDocument>
+#include <QSurfaceFormat>
+#include <QThread>
+
+#include "Private/esettings.h"
+#include "Private/document.h"
+#include "Private/Tasks/taskscheduler.h"
+#include "Sound/esoundsettings.h"
+#include "actions.h"
+#include "benchmarkrunner.h"
+#include "kernelbenchmarks.h"
+#include "scenebenchmarks.h"
+
+void setDefaultFormat() {
+    QSurfaceFormat format;
+    format.setVersion(3, 3);
+    format.setProfile(QSurfaceFormat::CoreProfile);
+    format.setDepthBufferSize(24);
+    format.setStencilBufferSize(8);
+    format.setSamples(0);
+    QSurfaceFormat::setDefaultFormat(format);
+}
+
+int main(int argc, char *argv[]) {
+#ifdef Q_OS_LINUX
+    // run headless when there is no display to connect to
+    if(!qEnvironmentVariableIsSet("QT_QPA_PLATFORM") &&
+       !qEnvironmentVariableIsSet("DISPLAY") &&
+       !qEnvironmentVariableIsSet("WAYLAND_DISPLAY")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+#endif
+    QApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
+    QApplication::setAttribute(Qt::AA_UseDesktopOpenGL);
+    setDefaultFormat();
+    QApplication app(argc, argv);
+    app.setApplicationName("enve benchmarks");
+    setlocale(LC_NUMERIC, "C");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmarks enve hot paths "
+                                     "and writes the results as JSON.");
+    parser.addHelpOption();
+    const QCommandLineOption outputOpt({"o", "output"},
+        "Write the JSON results to <file> instead of stdout.", "file");
+    const QCommandLineOption iterationsOpt({"i", "iterations"},
+        "Number of timed iterations per benchmark.", "count", "20");
+    const QCommandLineOption filterOpt({"f", "filter"},
+        "Only run benchmarks whose name contains <text>.", "text");
+    const QCommandLineOption threadsOpt({"t", "threads"},
+        "Number of cpu threads used for rendering.", "count",
+        QString::number(QThread::idealThreadCount()));
+    parser.addOptions({outputOpt, iterationsOpt, filterOpt, threadsOpt});
+    parser.process(app);
+
+    const int cpuThreads = qMax(1, parser.value(threadsOpt).toInt());
+    eSettings settings(cpuThreads, intKB(intMB(4096)),
+                       GpuVendor::unrecognized);
+    eSoundSettings soundSettings;
+
+    TaskScheduler taskScheduler;
+    Document document(taskScheduler);
+    Actions actions(document);
+
+    QString gpuError;
+    try {
+        taskScheduler.initializeGpu();
+    } catch(const std::exception& e) {
+        gpuError = gAllTextFromException(e);
+        std::cerr << "Gpu not available: " <<
+                     gpuError.toStdString() << std::endl;
+    }
+
+    BenchmarkRunner runner(parser.value(iterationsOpt).toInt(),
+                           parser.value(filterOpt));
+    gRunKernelBenchmarks(runner);
+    gRunSceneBenchmarks(runner, document, gpuError.isEmpty());
+
+    QJsonObject root;
+    root["version"] = ENVE_VERSION;
+#ifdef LATEST_COMMIT_HASH
+    root["commit"] = LATEST_COMMIT_HASH;
+#endif
+    root["qt"] = qVersion();
+    root["cpuThreads"] = cpuThreads;
+    root["iterations"] = runner.iterations();
+    root["gpu"] = gpuError.isEmpty();
+    if(!gpuError.isEmpty()) root["gpuError"] = gpuError;
+    root["benchmarks"] = runner.results();
+    const auto json = QJsonDocument(root).toJson();
+
+    const QString outputPath = parser.value(outputOpt);
+    if(outputPath.isEmpty()) {
+        std::cout << json.toStdString();
+    } else {
+        QFile file(outputPath);
+        if(!file.open(QIODevice::WriteOnly)) {
+            std::cerr << "Could not open " <<
+                         outputPath.toStdString() << std::endl;
+            return 1;
+        }
+        file.write(json);
+    }
+    return runner.failed() ? 1 : 0;
+}
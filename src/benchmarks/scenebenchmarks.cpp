@@ -0,0 +1,370 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "scenebenchmarks.h"
+
+#include <QBuffer>
+#include <QImage>
+#include <cstring>
+
+#include "benchmarkrunner.h"
+#include "exceptions.h"
+#include "canvas.h"
+#include "Private/document.h"
+#include "Private/Tasks/taskscheduler.h"
+#include "Private/esettings.h"
+#include "CacheHandlers/sceneframecontainer.h"
+#include "Boxes/rectangle.h"
+#include "Boxes/circle.h"
+#include "Boxes/textbox.h"
+#include "Boxes/paintbox.h"
+#include "Animators/transformanimator.h"
+#include "Animators/paintsettingsanimator.h"
+#include "Expressions/expression.h"
+#include "RasterEffects/blureffect.h"
+#include "RasterEffects/shadoweffect.h"
+#include "RasterEffects/brightnesscontrasteffect.h"
+#include "ReadWrite/filefooter.h"
+#include "ReadWrite/evformat.h"
+
+struct SyntheticScene {
+    QString fName;
+    QJsonObject fParams;
+    Canvas* fScene;
+};
+
+static const int sFrameCount = 100;
+
+static Canvas* newScene(Document& document, const QString& name) {
+    const auto scene = document.createNewScene();
+    scene->prp_setName(name);
+    scene->setCanvasSize(1920, 1080);
+    scene->setFrameRange({0, sFrameCount - 1});
+    return scene;
+}
+
+static QColor colorAt(const int i) {
+    return QColor::fromHsv((i*37) % 360, 200, 230);
+}
+
+static qsptr<RectangleBox> newRectangle(const int i) {
+    const auto box = enve::make_shared<RectangleBox>();
+    const QPointF topLeft((i*53) % 1800, (i*97) % 1000);
+    box->setTopLeftPos(topLeft);
+    box->setBottomRightPos(topLeft + QPointF(120, 80));
+    box->planCenterPivotPosition();
+    const auto fill = box->getFillSettings();
+    fill->setPaintType(FLATPAINT);
+    fill->setCurrentColor(colorAt(i));
+    return box;
+}
+
+static void setRotationExpression(BoundingBox* const box,
+                                  const QString& script) {
+    const auto rot = box->getTransformAnimator()->getRotAnimator();
+    rot->setExpression(Expression::sCreate("frame = $frame;", "", script,
+                                           rot, Expression::sQrealAnimatorTester));
+}
+
+static SyntheticScene pathBoxesScene(Document& document) {
+    const int boxes = 500;
+    const auto scene = newScene(document, "pathBoxes");
+    for(int i = 0; i < boxes; i++) {
+        if(i % 2) {
+            scene->addContained(newRectangle(i));
+        } else {
+            const auto circle = enve::make_shared<Circle>();
+            circle->setCenter(QPointF((i*71) % 1900, (i*89) % 1060));
+            circle->setRadius(20 + i % 40);
+            const auto fill = circle->getFillSettings();
+            fill->setPaintType(FLATPAINT);
+            fill->setCurrentColor(colorAt(i));
+            scene->addContained(circle);
+        }
+    }
+    return {"pathBoxes", {{"boxes", boxes}}, scene};
+}
+
+static SyntheticScene deepGroupsScene(Document& document) {
+    const int depth = 32;
+    const auto scene = newScene(document, "deepGroups");
+    ContainerBox* parent = scene;
+    for(int i = 0; i < depth; i++) {
+        const auto group = enve::make_shared<ContainerBox>(eBoxType::group);
+        group->addContained(newRectangle(i));
+        parent->addContained(group);
+        setRotationExpression(group.get(), "return frame*0.1;");
+        parent = group.get();
+    }
+    return {"deepGroups", {{"depth", depth}}, scene};
+}
+
+static SyntheticScene paintSurfacesScene(Document& document) {
+    const int surfaces = 8;
+    const int dim = 1024;
+    const auto scene = newScene(document, "paintSurfaces");
+    QImage image(dim, dim, QImage::Format_RGBA8888_Premultiplied);
+    for(int i = 0; i < surfaces; i++) {
+        image.fill(colorAt(i));
+        const auto paintBox = enve::make_shared<PaintBox>();
+        paintBox->getSurface()->loadPixmap(image);
+        setRotationExpression(paintBox.get(), "return frame;");
+        scene->addContained(paintBox);
+    }
+    return {"paintSurfaces", {{"surfaces", surfaces}, {"dim", dim}}, scene};
+}
+
+static SyntheticScene textScene(Document& document) {
+    const int boxes = 100;
+    const auto scene = newScene(document, "text");
+    for(int i = 0; i < boxes; i++) {
+        const auto text = enve::make_shared<TextBox>();
+        text->setCurrentValue("enve benchmark text " + QString::number(i));
+        text->setFontSize(24 + i % 16);
+        text->getTransformAnimator()->setPosition((i*53) % 1700,
+                                                  (i*97) % 1040);
+        scene->addContained(text);
+    }
+    return {"text", {{"boxes", boxes}}, scene};
+}
+
+static SyntheticScene rasterEffectsScene(Document& document) {
+    const int boxes = 20;
+    const auto scene = newScene(document, "rasterEffects");
+    for(int i = 0; i < boxes; i++) {
+        const auto box = newRectangle(i);
+        box->addRasterEffect(enve::make_shared<BlurEffect>());
+        box->addRasterEffect(enve::make_shared<ShadowEffect>());
+        box->addRasterEffect(enve::make_shared<BrightnessContrastEffect>());
+        scene->addContained(box);
+    }
+    return {"rasterEffects", {{"boxes", boxes}, {"effects", 3}}, scene};
+}
+
+static SyntheticScene expressionsScene(Document& document) {
+    const int boxes = 200;
+    const auto scene = newScene(document, "expressions");
+    for(int i = 0; i < boxes; i++) {
+        const auto box = newRectangle(i);
+        setRotationExpression(box.get(), "return Math.sin(frame*0.1)*" +
+                                         QString::number(i % 90) + ";");
+        scene->addContained(box);
+    }
+    return {"expressions", {{"boxes", boxes}}, scene};
+}
+
+static void planUserChange(BoundingBox* const box) {
+    box->planUpdate(UpdateReason::userChange);
+    if(const auto cont = enve_cast<ContainerBox*>(box)) {
+        for(const auto child : cont->getContainedBoxes()) {
+            planUserChange(child);
+        }
+    }
+}
+
+static void benchmarkFrameRender(BenchmarkRunner& runner,
+                                 Document& document,
+                                 const SyntheticScene& synth) {
+    const auto scene = synth.fScene;
+    const auto name = "render/" + synth.fName;
+    if(!runner.enabled(name)) return;
+    document.addVisibleScene(scene);
+    int frame = 0;
+    runner.run(name, synth.fParams, [&]() {
+        scene->anim_setAbsFrame(frame);
+        document.actionFinished();
+        TaskScheduler::instance()->waitTillFinished();
+        if(!scene->getSceneFramesHandler().atFrame(frame))
+            RuntimeThrow("Frame " + QString::number(frame) +
+                         " was not rendered");
+    }, [&]() {
+        frame = (frame + 1) % sFrameCount;
+        // drop cached frames and render data to force a full render
+        scene->getSceneFramesHandler().clear();
+        planUserChange(scene);
+    });
+    document.removeVisibleScene(scene);
+}
+
+//! @brief Direct-draw paths mixed with the blend modes
+//! that affect everything drawn below them.
+static SyntheticScene blendModesScene(Document& document) {
+    const int boxes = 200;
+    const SkBlendMode modes[] = {SkBlendMode::kDstIn, SkBlendMode::kSrcIn,
+                                 SkBlendMode::kDstATop, SkBlendMode::kModulate,
+                                 SkBlendMode::kSrcOut};
+    const int nModes = sizeof(modes)/sizeof(SkBlendMode);
+    const auto scene = newScene(document, "blendModes");
+    for(int i = 0; i < boxes; i++) {
+        const auto box = newRectangle(i);
+        if(i % 20 == 19) box->setBlendModeSk(modes[(i/20) % nModes]);
+        scene->addContained(box);
+    }
+    return {"blendModes", {{"boxes", boxes}, {"modes", nModes}}, scene};
+}
+
+static SkBitmap renderFrame(Document& document, Canvas* const scene,
+                            const int frame) {
+    scene->getSceneFramesHandler().clear();
+    planUserChange(scene);
+    scene->anim_setAbsFrame(frame);
+    document.actionFinished();
+    TaskScheduler::instance()->waitTillFinished();
+    const auto cont = scene->getSceneFramesHandler().
+            atFrame<SceneFrameContainer>(frame);
+    if(!cont) RuntimeThrow("Frame " + QString::number(frame) +
+                           " was not rendered");
+    const auto image = cont->getImage()->makeRasterImage();
+    SkBitmap bitmap;
+    if(!image || !bitmap.tryAllocPixels(image->imageInfo()) ||
+       !image->readPixels(bitmap.pixmap(), 0, 0))
+        RuntimeThrow("Could not read frame " + QString::number(frame));
+    return bitmap;
+}
+
+//! @brief Renders the scene with the children composited in parallel
+//! bands and sequentially, the results have to match exactly.
+static void checkBandedComposite(BenchmarkRunner& runner,
+                                 Document& document,
+                                 const SyntheticScene& synth) {
+    const QString name = "check/bandedComposite";
+    if(eSettings::sCpuThreadsCapped() < 2)
+        return runner.skip(name, "banding requires two cpu threads");
+    const auto scene = synth.fScene;
+    const int cpuThreadsCap = eSettings::sInstance->fCpuThreadsCap;
+    document.addVisibleScene(scene);
+    // do not reuse the previous composite for partial redraws
+    scene->setOutputRendering(true);
+    runner.check(name, synth.fParams, [&]() {
+        for(const int frame : {0, sFrameCount/2}) {
+            const auto banded = renderFrame(document, scene, frame);
+            eSettings::sInstance->fCpuThreadsCap = 1;
+            const auto sequential = renderFrame(document, scene, frame);
+            eSettings::sInstance->fCpuThreadsCap = cpuThreadsCap;
+            if(banded.computeByteSize() != sequential.computeByteSize() ||
+               std::memcmp(banded.getPixels(), sequential.getPixels(),
+                           banded.computeByteSize()))
+                RuntimeThrow("Banded and sequential frame " +
+                             QString::number(frame) + " differ");
+        }
+    });
+    eSettings::sInstance->fCpuThreadsCap = cpuThreadsCap;
+    scene->setOutputRendering(false);
+    document.removeVisibleScene(scene);
+}
+
+static QByteArray writeDocument(Document& document) {
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    eWriteStream writeStream(&buffer);
+    writeStream.writeCheckpoint();
+    const auto& scenes = document.fScenes;
+    writeStream << scenes.count();
+    for(const auto& scene : scenes) {
+        scene->writeSettings(writeStream);
+    }
+    writeStream.writeCheckpoint();
+    document.writeScenes(writeStream);
+    writeStream.writeCheckpoint();
+
+    writeStream.writeTableOfContents();
+    writeStream.writeFutureTable();
+    FileFooter::sWrite(writeStream);
+    BoundingBox::sClearWriteBoxes();
+    buffer.close();
+    return buffer.data();
+}
+
+//! @brief Mirrors the .ev loading sequence without the gui parts,
+//! returns the number of scenes read.
+static int readDocument(Document& document, QByteArray& data) {
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadOnly);
+    const int evVersion = FileFooter::sReadEvFileVersion(&buffer);
+    if(evVersion <= 0) RuntimeThrow("Incompatible or incomplete data");
+    eReadStream readStream(evVersion, &buffer);
+
+    const qint64 savedPos = buffer.pos();
+    const qint64 pos = buffer.size() - FileFooter::sSize(evVersion) -
+            qint64(sizeof(int));
+    buffer.seek(pos);
+    readStream.readFutureTable();
+    buffer.seek(savedPos);
+    const qint64 tocPos = FileFooter::sReadTableOfContentsPos(
+                              &buffer, evVersion);
+    readStream.readTableOfContents(tocPos);
+    readStream.readCheckpoint("File beginning pos mismatch");
+    int nScenes; readStream >> nScenes;
+    for(int i = 0; i < nScenes; i++) {
+        const auto scene = document.createNewScene();
+        scene->readSettings(readStream);
+    }
+    readStream.readCheckpoint("Error reading settings");
+    document.readScenes(readStream);
+    readStream.readCheckpoint("Error reading Document");
+    return nScenes;
+}
+
+static void benchmarkEvReadWrite(BenchmarkRunner& runner,
+                                 Document& document,
+                                 const QJsonObject& params) {
+    QByteArray data;
+    runner.run("ev/write", params, [&]() {
+        data = writeDocument(document);
+    });
+    if(!runner.enabled("ev/read")) return;
+    if(data.isEmpty()) data = writeDocument(document);
+    QJsonObject readParams = params;
+    readParams["bytes"] = data.size();
+    const int nOriginal = document.fScenes.count();
+    runner.run("ev/read", readParams, [&]() {
+        readDocument(document, data);
+    }, [&]() {
+        while(document.fScenes.count() > nOriginal) {
+            document.removeScene(document.fScenes.count() - 1);
+        }
+    });
+    while(document.fScenes.count() > nOriginal) {
+        document.removeScene(document.fScenes.count() - 1);
+    }
+}
+
+void gRunSceneBenchmarks(BenchmarkRunner& runner,
+                         Document& document,
+                         const bool gpu) {
+    QList<SyntheticScene> scenes;
+    scenes << pathBoxesScene(document);
+    scenes << deepGroupsScene(document);
+    scenes << paintSurfacesScene(document);
+    scenes << textScene(document);
+    scenes << rasterEffectsScene(document);
+    scenes << expressionsScene(document);
+    const auto blendModes = blendModesScene(document);
+    scenes << blendModes;
+    // process the tasks scheduled while building the scenes
+    document.actionFinished();
+
+    QJsonObject evParams;
+    for(const auto& synth : scenes) {
+        evParams[synth.fName] = synth.fParams;
+        if(gpu) benchmarkFrameRender(runner, document, synth);
+        else runner.skip("render/" + synth.fName, "gpu not available");
+    }
+    if(gpu) checkBandedComposite(runner, document, blendModes);
+    else runner.skip("check/bandedComposite", "gpu not available");
+    benchmarkEvReadWrite(runner, document, evParams);
+}
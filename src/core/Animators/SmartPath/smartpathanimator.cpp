@@ -152,8 +152,9 @@ SkPath SmartPathAnimator::getPathAtRelFrame(const qreal frame) {
            anim_getKeyAtIndex<SmartPathKey>(pn.first + 1);
     if(keyAtRelFrame) return keyAtRelFrame->getValue().getPathAt();
     if(prevKey && nextKey) {
-        SkPath result;
         const qreal nWeight = graph_prevKeyWeight(prevKey, nextKey, frame);
+        const auto morph = getMorph(prevKey, nextKey);
+        if(morph) return morph->pathAt(nWeight);
         SmartPath sPath;
         const auto& prevPath = prevKey->getValue();
         const auto& nextPath = nextKey->getValue();
@@ -167,6 +168,24 @@ SkPath SmartPathAnimator::getPathAtRelFrame(const qreal frame) {
     return baseValue().getPathAt();
 }
 
+const SmartPathMorph* SmartPathAnimator::getMorph(
+        SmartPathKey * const prevKey, SmartPathKey * const nextKey) {
+    auto it = mMorphs.find(prevKey);
+    if(it == mMorphs.end() || it->fNextKey != nextKey) {
+        MorphCacheEntry entry{nextKey, false, SmartPathMorph()};
+        entry.fValid = entry.fMorph.build(prevKey->getValue(),
+                                          nextKey->getValue());
+        it = mMorphs.insert(prevKey, entry);
+    }
+    return it->fValid ? &it->fMorph : nullptr;
+}
+
+void SmartPathAnimator::prp_afterChangedAbsRange(const FrameRange &range,
+                                                 const bool clip) {
+    mMorphs.clear();
+    SmartPathAnimatorBase::prp_afterChangedAbsRange(range, clip);
+}
+
 void SmartPathAnimator::actionSetNormalNodeCtrlsMode(
         const int nodeId, const CtrlsMode mode) {
     prp_pushUndoRedoName("Set Node Ctrls Mode");
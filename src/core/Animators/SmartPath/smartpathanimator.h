@@ -23,6 +23,7 @@
 #include "../interoptimalanimatort.h"
 #include "differsinterpolate.h"
 #include "smartpath.h"
+#include "smartpathmorph.h"
 
 using SmartPathKey = InterpolationKeyT<SmartPath>;
 
@@ -57,6 +58,9 @@ public:
     void prp_readProperty_impl(eReadStream& src);
     void prp_writeProperty_impl(eWriteStream& dst) const;
 
+    void prp_afterChangedAbsRange(const FrameRange &range,
+                                  const bool clip = true);
+
     SkPath getPathAtAbsFrame(const qreal frame)
     { return getPathAtRelFrame(prp_absFrameToRelFrameF(frame)); }
     SkPath getPathAtRelFrame(const qreal frame);
@@ -127,6 +131,19 @@ private:
 
     void updateAllPoints();
 
+    const SmartPathMorph* getMorph(SmartPathKey * const prevKey,
+                                   SmartPathKey * const nextKey);
+
+    struct MorphCacheEntry {
+        const SmartPathKey* fNextKey;
+        bool fValid;
+        SmartPathMorph fMorph;
+    };
+
+    //! @brief Morph tables keyed by the previous key,
+    //! dropped whenever any of the keys changes
+    QHash<const SmartPathKey*, MorphCacheEntry> mMorphs;
+
     SkPath mResultPath;
     Mode mMode = Mode::normal;
     QColor mPathColor = Qt::white;
@@ -0,0 +1,129 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "smartpathmorph.h"
+#include "pointhelpers.h"
+#include "Segments/qcubicsegment2d.h"
+
+bool SmartPathMorph::build(const SmartPath& path1, const SmartPath& path2) {
+    const NodeList& list1 = path1.getNodesRef();
+    const NodeList& list2 = path2.getNodesRef();
+    if(list1.count() != list2.count()) return false;
+    if(list1.isClosed() != list2.isClosed()) return false;
+    NodeList list1Cpy = list1;
+    NodeList list2Cpy = list2;
+    const int listCount = list1Cpy.count();
+    for(int i = 0; i < listCount; i++) {
+        const Node * const node1 = list1Cpy.at(i);
+        const Node * const node2 = list2Cpy.at(i);
+        if(node1->getType() == node2->getType()) continue;
+        if(node1->isDissolved()) {
+            list1Cpy.promoteDissolvedNodeToNormal(i);
+        } else if(node2->isDissolved()) {
+            list2Cpy.promoteDissolvedNodeToNormal(i);
+        } else return false;
+    }
+    mClosed = list1Cpy.isClosed();
+    if(listCount == 0) return true;
+    // promoting an interpolated first node depends on the weight
+    if(!list1Cpy.at(0)->isNormal()) return false;
+
+    int firstId = -1;
+    int prevNormalId = -1;
+    mSegTs << 0;
+    for(int i = 0; i < listCount; i++) {
+        const Node * const node1 = list1Cpy.at(i);
+        const Node * const node2 = list2Cpy.at(i);
+        if(node1->isDissolved() && node2->isDissolved()) {
+            mT1 << node1->t();
+            mT2 << node2->t();
+        } else if(node1->isNormal() && node2->isNormal()) {
+            if(firstId == -1) {
+                firstId = i;
+                addPoint(node1->p1(), node2->p1());
+            } else {
+                addSegment(*list1Cpy.at(prevNormalId), *node1,
+                           *list2Cpy.at(prevNormalId), *node2);
+            }
+            prevNormalId = i;
+        } else return false;
+    }
+    if(mClosed) {
+        addSegment(*list1Cpy.at(prevNormalId), *list1Cpy.at(firstId),
+                   *list2Cpy.at(prevNormalId), *list2Cpy.at(firstId));
+    }
+    return true;
+}
+
+void SmartPathMorph::addPoint(const QPointF& pt1, const QPointF& pt2) {
+    mX1 << pt1.x();
+    mY1 << pt1.y();
+    mX2 << pt2.x();
+    mY2 << pt2.y();
+}
+
+void SmartPathMorph::addSegment(const Node& prev1, const Node& next1,
+                                const Node& prev2, const Node& next2) {
+    addPoint(prev1.c2(), prev2.c2());
+    addPoint(next1.c0(), next2.c0());
+    addPoint(next1.p1(), next2.p1());
+    mSegTs << mT1.count();
+}
+
+SkPath SmartPathMorph::pathAt(const qreal weight2) const {
+    SkPath result;
+    const int count = mX1.count();
+    if(count == 0) return result;
+    const qreal w1 = 1 - weight2;
+    const auto point = [&](const int i) {
+        return QPointF(w1*mX1[i] + weight2*mX2[i],
+                       w1*mY1[i] + weight2*mY2[i]);
+    };
+    result.incReserve(count);
+    result.moveTo(toSkPoint(point(0)));
+    if(mT1.isEmpty()) {
+        for(int i = 1; i < count; i += 3) {
+            result.cubicTo(toSkPoint(point(i)),
+                           toSkPoint(point(i + 1)),
+                           toSkPoint(point(i + 2)));
+        }
+    } else {
+        const int segCount = mSegTs.count() - 1;
+        for(int s = 0; s < segCount; s++) {
+            const int i = 3*s;
+            qCubicSegment2D seg(point(i), point(i + 1),
+                                point(i + 2), point(i + 3));
+            qreal lastT = 0;
+            for(int j = mSegTs[s]; j < mSegTs[s + 1]; j++) {
+                const qreal t = w1*mT1[j] + weight2*mT2[j];
+                const qreal mappedT = gMapTToFragment(lastT, 1, t);
+                const auto div = seg.dividedAtT(mappedT);
+                const auto& first = div.first;
+                result.cubicTo(toSkPoint(first.c1()),
+                               toSkPoint(first.c2()),
+                               toSkPoint(first.p3()));
+                seg = div.second;
+                lastT = t;
+            }
+            result.cubicTo(toSkPoint(seg.c1()),
+                           toSkPoint(seg.c2()),
+                           toSkPoint(seg.p3()));
+        }
+    }
+    if(mClosed) result.close();
+    return result;
+}
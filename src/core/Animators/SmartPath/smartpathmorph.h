@@ -0,0 +1,51 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef SMARTPATHMORPH_H
+#define SMARTPATHMORPH_H
+
+#include "smartpath.h"
+#include "skia/skiaincludes.h"
+
+//! @brief Flattened interpolation table of two SmartPath values,
+//! node matching and dissolved node promotion are done only once.
+class CORE_EXPORT SmartPathMorph {
+public:
+    //! @brief Returns false if the values cannot be flattened,
+    //! regular interpolation has to be used in that case.
+    bool build(const SmartPath& path1, const SmartPath& path2);
+
+    //! @brief Same result as gInterpolate followed by getPathAt.
+    SkPath pathAt(const qreal weight2) const;
+private:
+    void addPoint(const QPointF& pt1, const QPointF& pt2);
+    void addSegment(const Node& prev1, const Node& next1,
+                    const Node& prev2, const Node& next2);
+
+    bool mClosed = false;
+    // moveTo point followed by c1, c2, p3 of every segment
+    QVector<qreal> mX1;
+    QVector<qreal> mY1;
+    QVector<qreal> mX2;
+    QVector<qreal> mY2;
+    // dissolved node ts of segment i are in [mSegTs[i], mSegTs[i + 1])
+    QVector<int> mSegTs;
+    QVector<qreal> mT1;
+    QVector<qreal> mT2;
+};
+
+#endif // SMARTPATHMORPH_H
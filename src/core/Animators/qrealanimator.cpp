@@ -408,8 +408,39 @@ void QrealAnimator::setExpression(const qsptr<Expression>& expression) {
     emit expressionChanged();
 }
 
+#define MAX_BAKED_CURVE_SAMPLES 100000
+
+bool QrealAnimator::bakeCurve(const FrameRange& relRange,
+                              const int samplesPerFrame) {
+    mBakedCurve.clearBaked();
+    if(anim_getKeys().count() < 2) return false;
+    if(relRange.span() > MAX_BAKED_CURVE_SAMPLES/qMax(1, samplesPerFrame))
+        return false;
+    mBakedCurve.setBakeGrid(relRange, samplesPerFrame);
+    return mBakedCurve.isBaked();
+}
+
+void QrealAnimator::clearBakedCurve() {
+    mBakedCurve.clearBaked();
+}
+
+int QrealAnimator::bakedCurveBytes() const {
+    return mBakedCurve.bakedBytes();
+}
+
 qreal QrealAnimator::calculateBaseValueAtRelFrame(const qreal frame) const {
     if(!anim_hasKeys()) return mCurrentBaseValue;
+    // frames between the samples are evaluated exactly
+    const int sample = mBakedCurve.bakedSample(frame);
+    if(sample == -1) return calculateKeysValueAtRelFrame(frame);
+    qreal value;
+    if(mBakedCurve.bakedValue(sample, value)) return value;
+    value = calculateKeysValueAtRelFrame(mBakedCurve.bakedSampleFrame(sample));
+    mBakedCurve.setBakedValue(sample, value);
+    return value;
+}
+
+qreal QrealAnimator::calculateKeysValueAtRelFrame(const qreal frame) const {
     const auto pn = anim_getPrevAndNextKeyIdF(frame);
     const int prevId = pn.first;
     const int nextId = pn.second;
@@ -749,6 +780,7 @@ FrameRange QrealAnimator::prp_nextNonUnaryIdenticalRelRange(const int relFrame)
 
 void QrealAnimator::prp_afterChangedAbsRange(const FrameRange &range,
                                              const bool clip) {
+    mBakedCurve.clearBaked();
     if(range.inRange(anim_getCurrentAbsFrame()))
         updateCurrentBaseValue();
     GraphAnimator::prp_afterChangedAbsRange(range, clip);
@@ -99,6 +99,12 @@ public:
                           const qreal frameMultiplier = 1,
                           const qreal valueMultiplier = 1) const;
 
+    //! @brief Stores base values on a grid of samples over relRange as they
+    //! are evaluated, dropped on any change. Returns false if not baked.
+    bool bakeCurve(const FrameRange& relRange, const int samplesPerFrame = 1);
+    void clearBakedCurve();
+    int bakedCurveBytes() const;
+
     void setPrefferedValueStep(const qreal valueStep);
 
     void setValueRange(const qreal minVal, const qreal maxVal);
@@ -182,6 +188,7 @@ public:
                       const QString& templ = "%1");
 private:
     qreal calculateBaseValueAtRelFrame(const qreal frame) const;
+    qreal calculateKeysValueAtRelFrame(const qreal frame) const;
     void startBaseValueTransform();
     void finishBaseValueTransform();
     bool updateExpressionRelFrame();
@@ -207,6 +214,7 @@ private:
     qreal mSavedCurrentValue = 0;
 
     ConnContextQSPtr<Expression> mExpression;
+    mutable QrealSnapshot mBakedCurve;
 
     qreal mPrefferedValueStep = 1;
 signals:
@@ -17,6 +17,8 @@
 #include "qrealsnapshot.h"
 #include "qrealkey.h"
 
+#include <QtNumeric>
+
 void QrealSnapshot::appendKey(const QrealKey * const key) {
     appendKey(key->getC0Frame(), key->getC0Value(),
               key->getRelFrame(), key->getValue(),
@@ -31,6 +33,46 @@ void QrealSnapshot::appendKey(const qreal c0Frame, const qreal c0Value,
                   c1Frame*mFrameMultiplier, c1Value*mValueMultiplier});
 }
 
+void QrealSnapshot::setBakeGrid(const FrameRange& relRange,
+                                const int samplesPerFrame) {
+    clearBaked();
+    if(!relRange.isValid() || samplesPerFrame < 1) return;
+    mBakedSamplesPerFrame = samplesPerFrame;
+    mBakedMinFrame = relRange.fMin;
+    mBakedCount = relRange.span()*samplesPerFrame;
+}
+
+void QrealSnapshot::clearBaked() {
+    mBakedCount = 0;
+    mBaked = QVector<qreal>();
+}
+
+int QrealSnapshot::bakedSample(const qreal relFrame) const {
+    if(mBakedCount == 0) return -1;
+    const qreal sample = (relFrame - mBakedMinFrame)*mBakedSamplesPerFrame;
+    const int id = qRound(sample);
+    if(id < 0 || id >= mBakedCount) return -1;
+    if(!isZero4Dec(sample - id)) return -1;
+    return id;
+}
+
+qreal QrealSnapshot::bakedSampleFrame(const int sample) const {
+    return mBakedMinFrame + qreal(sample)/mBakedSamplesPerFrame;
+}
+
+bool QrealSnapshot::bakedValue(const int sample, qreal& value) const {
+    if(mBaked.isEmpty()) return false;
+    const qreal baked = mBaked.at(sample);
+    if(qIsNaN(baked)) return false;
+    value = baked;
+    return true;
+}
+
+void QrealSnapshot::setBakedValue(const int sample, const qreal value) {
+    if(mBaked.isEmpty()) mBaked.fill(qQNaN(), mBakedCount);
+    mBaked[sample] = value;
+}
+
 qreal QrealSnapshot::getValue(const qreal relFrame) const {
     const KeySnaphot * prevKey = nullptr;
     const KeySnaphot * nextKey = nullptr;
@@ -20,6 +20,8 @@ class QrealKey;
 #include "../pointhelpers.h"
 #include "../framerange.h"
 
+#include <QVector>
+
 class CORE_EXPORT QrealSnapshot {
     friend class Iterator;
     struct KeySnaphot {
@@ -72,6 +74,20 @@ public:
                    const qreal c1Frame, const qreal c1Value);
 
     qreal getValue(const qreal relFrame) const;
+
+    //! @brief Sets up a grid of samplesPerFrame samples per frame over
+    //! relRange, samples are stored on the first lookup.
+    void setBakeGrid(const FrameRange& relRange, const int samplesPerFrame);
+    void clearBaked();
+    bool isBaked() const { return mBakedCount > 0; }
+    int bakedBytes() const { return mBaked.count()*int(sizeof(qreal)); }
+
+    //! @brief Returns the sample at relFrame, -1 if relFrame is off the grid
+    int bakedSample(const qreal relFrame) const;
+    qreal bakedSampleFrame(const int sample) const;
+    //! @brief Returns false if the sample was not stored yet
+    bool bakedValue(const int sample, qreal& value) const;
+    void setBakedValue(const int sample, const qreal value);
 protected:
     void getPrevAndNextKey(const qreal relFrame,
                            KeySnaphot const *& prevKey,
@@ -90,5 +106,10 @@ protected:
 
     qreal mFrameMultiplier;
     qreal mValueMultiplier;
+
+    int mBakedSamplesPerFrame = 1;
+    qreal mBakedMinFrame = 0;
+    int mBakedCount = 0;
+    QVector<qreal> mBaked;
 };
 #endif // QREALSNAPSHOT_H
@@ -42,8 +42,12 @@ BasicTransformAnimator::BasicTransformAnimator() :
 
     connect(this, &Property::prp_currentFrameChanged,
             this, &BasicTransformAnimator::updateRelativeTransform);
+    connect(this, &Property::prp_absFrameRangeChanged,
+            this, [this]() { sTransformEpoch++; });
 }
 
+std::atomic<uint> BasicTransformAnimator::sTransformEpoch{1};
+
 void BasicTransformAnimator::resetScale() {
     mScaleAnimator->prp_startTransform();
     mScaleAnimator->setBaseValue(QPointF(1, 1));
@@ -239,6 +243,7 @@ const QMatrix &BasicTransformAnimator::getRelativeTransform() const {
 
 void BasicTransformAnimator::setParentTransformAnimator(
         BasicTransformAnimator* parent) {
+    sTransformEpoch++;
     auto& conn = mParentTransform.assign(parent);
     if(parent) {
         conn << connect(parent, &BasicTransformAnimator::totalTransformChanged,
@@ -286,8 +291,35 @@ QMatrix BasicTransformAnimator::getInheritedTransformAtFrame(
     }
 }
 
+#define MAX_CACHED_TOTAL_TRANSFORMS 64
+
 QMatrix BasicTransformAnimator::getTotalTransformAtFrame(
         const qreal relFrame) const {
+    const uint epoch = sTransformEpoch;
+    {
+        std::lock_guard<std::mutex> lock(mTotalCacheMutex);
+        if(mTotalCacheEpoch == epoch) {
+            const auto it = mTotalCache.constFind(relFrame);
+            if(it != mTotalCache.constEnd()) return *it;
+        }
+    }
+    // parents fill their caches first, each level is evaluated once
+    const auto total = calculateTotalTransformAtFrame(relFrame);
+    {
+        std::lock_guard<std::mutex> lock(mTotalCacheMutex);
+        if(epoch != sTransformEpoch) return total;
+        if(mTotalCacheEpoch != epoch ||
+           mTotalCache.count() >= MAX_CACHED_TOTAL_TRANSFORMS) {
+            mTotalCache.clear();
+            mTotalCacheEpoch = epoch;
+        }
+        mTotalCache.insert(relFrame, total);
+    }
+    return total;
+}
+
+QMatrix BasicTransformAnimator::calculateTotalTransformAtFrame(
+        const qreal relFrame) const {
     if(mParentTransform) {
         const qreal absFrame = prp_relFrameToAbsFrameF(relFrame);
         const qreal parentRelFrame =
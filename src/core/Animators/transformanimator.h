@@ -21,6 +21,9 @@
 #include "transformvalues.h"
 
 #include <QMatrix>
+#include <QHash>
+#include <mutex>
+#include <atomic>
 
 class TransformUpdater;
 class BoxPathPoint;
@@ -112,6 +115,15 @@ protected:
     qsptr<QrealAnimator> mRotAnimator;
 private:
     bool rotationFlipped() const;
+    QMatrix calculateTotalTransformAtFrame(const qreal relFrame) const;
+
+    //! @brief Bumped by any transform change,
+    //! invalidates the total transform caches of all animators
+    static std::atomic<uint> sTransformEpoch;
+
+    mutable std::mutex mTotalCacheMutex;
+    mutable uint mTotalCacheEpoch = 0;
+    mutable QHash<qreal, QMatrix> mTotalCache;
 signals:
     void totalTransformChanged(const UpdateReason);
     void inheritedTransformChanged(const UpdateReason);
@@ -18,6 +18,7 @@
 
 #include <QMenu>
 #include <QInputDialog>
+#include <QtMath>
 
 #include "canvas.h"
 #include "FileCacheHandlers/animationcachehandler.h"
@@ -40,6 +41,7 @@ struct AnimationBoxRenderData : public ImageContainerRenderData {
 
     const qptr<AnimationFrameHandler> fSrcCacheHandler;
     int fAnimFrame;
+    int fProxyLevel = 0;
 };
 
 AnimationBox::AnimationBox(const QString &name, const eBoxType type) :
@@ -301,12 +303,36 @@ void AnimationBox::setupRenderData(const qreal relFrame,
     const auto imgData = static_cast<AnimationBoxRenderData*>(data);
     const int animFrame = getAnimationFrameForRelFrame(relFrame);
     imgData->fAnimFrame = animFrame;
-    const auto upd = mSrcFramesCache->scheduleFrameLoad(animFrame);
+    int proxyLevel = 0;
+    if(!scene->isRenderingOutput()) {
+        const qreal scale = imgData->sourcePixelScale();
+        proxyLevel = ImageCacheContainer::sProxyLevel(scale);
+    }
+    imgData->fProxyLevel = proxyLevel;
+    const auto upd = mSrcFramesCache->scheduleFrameLoad(animFrame, proxyLevel);
     if(upd) upd->addDependent(imgData);
     else {
-        const auto cont = mSrcFramesCache->getFrameAtFrame(animFrame);
+        const auto cont = mSrcFramesCache->getFrameAtFrame(animFrame,
+                                                           proxyLevel);
         imgData->setContainer(cont);
     }
+    if(scene->isRenderingPreview() || scene->isRenderingOutput()) {
+        prefetchFrames(qFloor(relFrame), proxyLevel, scene);
+    }
+}
+
+void AnimationBox::prefetchFrames(const int relFrame, const int proxyLevel,
+                                  Canvas * const scene) {
+    const int count = mSrcFramesCache->prefetchCount();
+    if(count <= 0) return;
+    // scenes are rendered forward, the source frames follow the stretch
+    const int maxRelFrame = prp_absFrameToRelFrame(scene->getMaxFrame());
+    const int lastRelFrame = qMin(relFrame + count, maxRelFrame);
+    for(int i = relFrame + 1; i <= lastRelFrame; i++) {
+        if(!isVisibleAndInDurationRect(i)) break;
+        const int animFrame = getAnimationFrameForRelFrame(i);
+        mSrcFramesCache->scheduleFrameLoad(animFrame, proxyLevel);
+    }
 }
 
 stdsptr<BoxRenderData> AnimationBox::createRenderData() {
@@ -330,6 +356,7 @@ AnimationBoxRenderData::AnimationBoxRenderData(
 
 void AnimationBoxRenderData::loadImageFromHandler() {
     if(!fSrcCacheHandler) return;
-    const auto cont = fSrcCacheHandler->getFrameAtOrBeforeFrame(fAnimFrame);
+    const auto cont = fSrcCacheHandler->getFrameAtOrBeforeFrame(fAnimFrame,
+                                                                fProxyLevel);
     setContainer(cont);
 }
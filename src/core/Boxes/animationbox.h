@@ -70,6 +70,8 @@ private:
     void createPaintObject(const int firstAbsFrame,
                            const int lastAbsFrame,
                            const int increment);
+    void prefetchFrames(const int relFrame, const int proxyLevel,
+                        Canvas * const scene);
 
     qreal mStretch = 1;
     qsptr<AnimationFrameHandler> mSrcFramesCache;
@@ -474,6 +474,7 @@ QPointF BoundingBox::getPivotAbsPos(const qreal relFrame) {
 
 void BoundingBox::setRelBoundingRect(const QRectF& relRect) {
     mRelRect = relRect;
+    mRelRectRendered = false;
     mRelRectSk = toSkRect(mRelRect);
     mSkRelBoundingRectPath.reset();
     mSkRelBoundingRectPath.addRect(mRelRectSk);
@@ -497,6 +498,30 @@ void BoundingBox::prp_updateCanvasProps() {
 void BoundingBox::updateCurrentPreviewDataFromRenderData(
         BoxRenderData* renderData) {
     setRelBoundingRect(renderData->fRelBoundingRect);
+    mRelRectRendered = true;
+    mRelRectFrame = renderData->fRelFrame;
+    mRelRectStateId = renderData->fBoxStateId;
+}
+
+bool BoundingBox::outsideRenderBounds(const qreal relFrame,
+                                      const QMatrix& parentM,
+                                      Canvas* const scene) const {
+    if(!scene || !mRelRectRendered || mRelRectStateId != mStateId) return false;
+    // effects can draw outside of the box, e.g., motion blur samples
+    if(mRasterEffectsAnimators->hasEffects()) return false;
+    const auto idRange = prp_getIdenticalRelRange(qFloor(relFrame));
+    if(!idRange.inRange(qCeil(relFrame))) return false;
+    if(!idRange.inRange(qFloor(mRelRectFrame)) ||
+       !idRange.inRange(qCeil(mRelRectFrame))) return false;
+
+    const auto parent = getParentGroup();
+    const QRectF maxBounds = parent ? parent->currentGlobalBounds() :
+                                      scene->getCurrentBounds();
+    const auto totalM = getRelativeTransformAtFrame(relFrame)*parentM;
+    const qreal margin = 3/qMax(scene->getResolution(), 0.01);
+    const auto absRect = totalM.mapRect(mRelRect).adjusted(
+                -margin, -margin, margin, margin);
+    return !absRect.intersects(maxBounds);
 }
 
 void BoundingBox::planUpdate(const UpdateReason reason) {
@@ -201,6 +201,10 @@ public:
     virtual void renderDataFinished(BoxRenderData *renderData);
     virtual void updateCurrentPreviewDataFromRenderData(
             BoxRenderData* renderData);
+    //! @brief Returns true only if the box certainly draws nothing inside
+    //! the render bounds at relFrame, based on the last rendered bounds.
+    bool outsideRenderBounds(const qreal relFrame, const QMatrix& parentM,
+                             Canvas* const scene) const;
 
     virtual FrameRange getMotionBlurIdenticalRange(
             const qreal relFrame, const bool inheritedTransform);
@@ -220,6 +224,9 @@ public:
     virtual SkBlendMode getBlendMode() const
     { return mBlendMode; }
 
+    //! @brief Changes with every user change to the box or its contents
+    uint stateId() const { return mStateId; }
+
     virtual qreal getOpacity(const qreal relFrame) const;
 
     virtual void saveSVG(SvgExporter& exp, DomEleTask* const task) const {
@@ -475,6 +482,10 @@ private:
     QPointF mSavedTransformPivot;
 
     QRectF mRelRect;
+    //! @brief mRelRect comes from render data of this frame and state
+    bool mRelRectRendered = false;
+    qreal mRelRectFrame = 0;
+    uint mRelRectStateId = 0;
     SkRect mRelRectSk;
     SkPath mSkRelBoundingRectPath;
 
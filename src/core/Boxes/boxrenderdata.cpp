@@ -21,6 +21,8 @@
 #include "Private/Tasks/taskscheduler.h"
 #include "Private/Tasks/gputaskexecutor.h"
 
+#include <QThread>
+
 BoxRenderData::BoxRenderData(BoundingBox * const parent) :
     fFilterQuality(eFilterSettings::sRender()) {
     fParentBox = parent;
@@ -215,7 +217,15 @@ void BoxRenderData::dataSet() {
         updateRelBoundingRect();
     }
     if(!fParentBox || !fParentIsTarget) return;
-    fParentBox->updateCurrentPreviewDataFromRenderData(this);
+    if(QThread::currentThread() == fParentBox->thread()) {
+        fParentBox->updateCurrentPreviewDataFromRenderData(this);
+    } else { // started by a worker, the box lives in the main thread
+        const qptr<BoundingBox> box = fParentBox;
+        const auto data = ref<BoxRenderData>();
+        QMetaObject::invokeMethod(box, [box, data]() {
+            if(box) box->updateCurrentPreviewDataFromRenderData(data.get());
+        }, Qt::QueuedConnection);
+    }
 }
 
 #include "Boxes/textboxrenderdata.h"
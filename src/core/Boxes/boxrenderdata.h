@@ -68,6 +68,11 @@ public:
 
     bool nextStep();
 
+    bool releasesDependentsOnWorker() const {
+        // motion blur target is updated in afterProcessing
+        return !fMotionBlurTarget;
+    }
+
     void processGpu(QGL33 * const gl, SwitchableContext &context);
     void process();
 
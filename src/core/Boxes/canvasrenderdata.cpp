@@ -16,6 +16,12 @@
 
 #include "canvasrenderdata.h"
 #include "skia/skiahelpers.h"
+#include "skia/skqtconversions.h"
+#include "simplemath.h"
+
+#include <QRegion>
+
+#define TILE_SIZE 128
 
 CanvasRenderData::CanvasRenderData(BoundingBox * const parentBoxT) :
     ContainerBoxRenderData(parentBoxT) {}
@@ -34,3 +40,113 @@ void CanvasRenderData::updateGlobalRect() {
 void CanvasRenderData::updateRelBoundingRect() {
     fRelBoundingRect = QRectF(0, 0, fCanvasWidth, fCanvasHeight);
 }
+
+bool SceneComposite::Child::operator==(const Child& other) const {
+    return fBox == other.fBox && fStateId == other.fStateId &&
+           isZero4Dec(fRelFrame - other.fRelFrame) &&
+           fTotalTransform == other.fTotalTransform &&
+           fDrawnRect == other.fDrawnRect &&
+           isZero4Dec(fOpacity - other.fOpacity) &&
+           fBlendMode == other.fBlendMode &&
+           fClipped == other.fClipped;
+}
+
+SceneComposite::Child SceneComposite::sChild(const ChildRenderData& child) {
+    const auto& data = child.fData;
+    Child result;
+    result.fBox = data->fBlendEffectIdentifier;
+    result.fStateId = data->fBoxStateId;
+    result.fRelFrame = data->fRelFrame;
+    result.fTotalTransform = data->fTotalTransform;
+    result.fDrawnRect = ContainerBoxRenderData::sDrawnRect(*data);
+    result.fOpacity = data->fOpacity;
+    result.fBlendMode = data->fBlendMode;
+    result.fClipped = !child.fClip.fClipOps.isEmpty();
+    result.fAffectsAll = ContainerBoxRenderData::sAffectsAll(data->fBlendMode);
+    return result;
+}
+
+static void addDamagedTiles(const QRect& rect, const QRect& bounds,
+                            QRegion& damage) {
+    // filtering can touch pixels next to the drawn rect
+    const auto clamped = rect.adjusted(-1, -1, 1, 1).intersected(bounds);
+    if(clamped.isEmpty()) return;
+    const int minX = qFloor(qreal(clamped.left())/TILE_SIZE);
+    const int maxX = qFloor(qreal(clamped.right())/TILE_SIZE);
+    const int minY = qFloor(qreal(clamped.top())/TILE_SIZE);
+    const int maxY = qFloor(qreal(clamped.bottom())/TILE_SIZE);
+    const QRect tiles(minX*TILE_SIZE, minY*TILE_SIZE,
+                      (maxX - minX + 1)*TILE_SIZE,
+                      (maxY - minY + 1)*TILE_SIZE);
+    damage += tiles.intersected(bounds);
+}
+
+bool SceneComposite::damagedTiles(const SceneComposite& prev,
+                                  QRegion& damage) const {
+    if(!prev.fImage) return false;
+    if(prev.fRelFrame != fRelFrame) return false;
+    if(!isZero4Dec(prev.fResolution - fResolution)) return false;
+    if(prev.fGlobalRect != fGlobalRect) return false;
+    if(prev.fBgColor != fBgColor) return false;
+    const int nChildren = fChildren.count();
+    if(prev.fChildren.count() != nChildren) return false;
+    for(int i = 0; i < nChildren; i++) {
+        const auto& prevChild = prev.fChildren.at(i);
+        const auto& child = fChildren.at(i);
+        if(prevChild.fBox != child.fBox) return false;
+        if(!child.fClipped && prevChild == child) continue;
+        if(child.fAffectsAll || prevChild.fAffectsAll) return false;
+        addDamagedTiles(prevChild.fDrawnRect, fGlobalRect, damage);
+        addDamagedTiles(child.fDrawnRect, fGlobalRect, damage);
+    }
+    qint64 damagedArea = 0;
+    for(const auto& rect : damage.rects()) {
+        damagedArea += qint64(rect.width())*rect.height();
+    }
+    const qint64 area = qint64(fGlobalRect.width())*fGlobalRect.height();
+    // redrawing most of the frame is not worth the copy
+    return 2*damagedArea < area;
+}
+
+void CanvasRenderData::drawSk(SkCanvas * const canvas) {
+    fComposite.reset();
+    if(hasEffects()) return ContainerBoxRenderData::drawSk(canvas);
+    const auto composite = std::make_shared<SceneComposite>();
+    composite->fRelFrame = qRound(fRelFrame);
+    composite->fResolution = fResolution;
+    composite->fGlobalRect = fGlobalRect;
+    composite->fBgColor = fBgColor;
+    for(const auto& child : fChildrenRenderData) {
+        composite->fChildren << SceneComposite::sChild(child);
+    }
+    fComposite = composite;
+
+    QRegion damage;
+    const bool partial = fBase && composite->damagedTiles(*fBase, damage);
+    const auto base = fBase;
+    fBase.reset();
+    if(!partial) return ContainerBoxRenderData::drawSk(canvas);
+
+    SkPaint copyPaint;
+    copyPaint.setBlendMode(SkBlendMode::kSrc);
+    canvas->drawImage(base->fImage, fGlobalRect.x(), fGlobalRect.y(),
+                      &copyPaint);
+    if(damage.isEmpty()) return;
+
+    SkPath clipPath;
+    for(const auto& rect : damage.rects()) {
+        clipPath.addRect(toSkRect(rect));
+    }
+    canvas->save();
+    canvas->clipPath(clipPath);
+    canvas->clear(eraseColor());
+    const int nChildren = fChildrenRenderData.count();
+    for(int i = 0; i < nChildren; i++) {
+        const auto& child = composite->fChildren.at(i);
+        // same filtering margin as used for the damaged tiles
+        const auto drawnRect = child.fDrawnRect.adjusted(-1, -1, 1, 1);
+        if(!child.fAffectsAll && !damage.intersects(drawnRect)) continue;
+        drawChild(canvas, fChildrenRenderData.at(i));
+    }
+    canvas->restore();
+}
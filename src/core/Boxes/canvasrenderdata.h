@@ -17,6 +17,40 @@
 #ifndef CANVASRENDERDATA_H
 #define CANVASRENDERDATA_H
 #include "layerboxrenderdata.h"
+
+//! @brief Describes a composited scene frame, lets the next frame of the
+//! same scene redraw only the tiles touched by children that changed.
+struct CORE_EXPORT SceneComposite {
+    struct Child {
+        const BoundingBox* fBox;
+        uint fStateId;
+        qreal fRelFrame;
+        QMatrix fTotalTransform;
+        QRect fDrawnRect;
+        qreal fOpacity;
+        SkBlendMode fBlendMode;
+        //! @brief Clipped by another box, has to be redrawn every time
+        bool fClipped;
+        //! @brief Blend mode affects pixels outside of fDrawnRect
+        bool fAffectsAll;
+
+        bool operator==(const Child& other) const;
+    };
+
+    static Child sChild(const ChildRenderData& child);
+
+    //! @brief Collects tiles to be redrawn to get from prev to this,
+    //! returns false if the whole frame should be redrawn.
+    bool damagedTiles(const SceneComposite& prev, QRegion& damage) const;
+
+    int fRelFrame;
+    qreal fResolution;
+    QRect fGlobalRect;
+    SkColor fBgColor;
+    QList<Child> fChildren;
+    sk_sp<SkImage> fImage;
+};
+
 struct CORE_EXPORT CanvasRenderData : public ContainerBoxRenderData {
     CanvasRenderData(BoundingBox * const parentBoxT);
 
@@ -25,7 +59,13 @@ struct CORE_EXPORT CanvasRenderData : public ContainerBoxRenderData {
     SkColor fBgColor;
 
     SkColor eraseColor() const { return fBgColor; }
+
+    //! @brief Previously composited frame used as the redraw base
+    stdsptr<SceneComposite> fBase;
+    //! @brief Composite state of this frame, set by drawSk
+    stdsptr<SceneComposite> fComposite;
 protected:
+    void drawSk(SkCanvas * const canvas);
     void updateGlobalRect();
     void updateRelBoundingRect();
 };
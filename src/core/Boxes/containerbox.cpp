@@ -15,6 +15,7 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "containerbox.h"
+#include "layerboxrenderdata.h"
 #include "Timeline/durationrectangle.h"
 #include "Animators/transformanimator.h"
 #include "canvas.h"
@@ -940,12 +941,18 @@ void ContainerBox::updateIfUsesProgram(
     BoundingBox::updateIfUsesProgram(program);
 }
 
-void processChildData(BoundingBox * const child,
-                      ContainerBoxRenderData * const parentData,
-                      const qreal childRelFrame,
-                      const QMatrix& thisM,
-                      const qreal absFrame,
-                      QList<ChildRenderData>& delayed) {
+struct ChildCandidate {
+    BoundingBox* fBox;
+    qreal fRelFrame;
+    QMatrix fParentM;
+};
+
+void gatherChildData(BoundingBox * const child,
+                     const qreal childRelFrame,
+                     const QMatrix& thisM,
+                     const qreal absFrame,
+                     const bool cull,
+                     QList<ChildCandidate>& children) {
     if(!child->isFrameFVisibleAndInDurationRect(childRelFrame)) return;
     if(child->isGroup()) {
         const auto childGroup = static_cast<ContainerBox*>(child);
@@ -956,17 +963,28 @@ void processChildData(BoundingBox * const child,
         for(int i = minMax.fMax; i >= minMax.fMin; i--) {
             const auto& desc = descs.at(i);
             const qreal descRelFrame = desc->prp_absFrameToRelFrameF(absFrame);
-            processChildData(desc, parentData, descRelFrame,
-                             childM, absFrame, delayed);
+            gatherChildData(desc, descRelFrame, childM, absFrame,
+                            cull, children);
         }
         return;
     }
+    const auto scene = child->getParentScene();
+    if(cull && child->outsideRenderBounds(childRelFrame, thisM, scene)) return;
+    children.append({child, childRelFrame, thisM});
+}
+
+void processChildData(const ChildCandidate& candidate,
+                      ContainerBoxRenderData * const parentData,
+                      QList<ChildRenderData>& delayed,
+                      const stdsptr<StaticChildRun>& run) {
+    const auto child = candidate.fBox;
+    const qreal childRelFrame = candidate.fRelFrame;
     stdsptr<BoxRenderData> boxRenderData;
     if(parentData->fParentIsTarget) {
         boxRenderData = child->getCurrentRenderData(childRelFrame);
     }
     if(!boxRenderData) {
-        boxRenderData = child->queRender(childRelFrame, thisM);
+        boxRenderData = child->queRender(childRelFrame, candidate.fParentM);
     }
     if(!boxRenderData) return;
     boxRenderData->fParentIsTarget = parentData->fParentIsTarget;
@@ -974,12 +992,34 @@ void processChildData(BoundingBox * const child,
     boxRenderData->addDependent(parentData);
     ChildRenderData cData = boxRenderData;
     cData.fIsMain = true;
+    cData.fRun = run;
     cData.fClip.fTargetIndex = parentData->fChildrenRenderData.count();
     child->blendSetup(cData, parentData->fChildrenRenderData.count(),
                       childRelFrame, delayed);
     parentData->fChildrenRenderData << cData;
 }
 
+//! @brief Returns the run of static children starting at from,
+//! children without own animation, blended normally.
+QList<StaticChildRun::Member> staticRunAt(
+        const QList<ChildCandidate>& children, const int from) {
+    QList<StaticChildRun::Member> members;
+    for(int i = from; i < children.count(); i++) {
+        const auto& child = children.at(i);
+        const auto box = child.fBox;
+        if(box->getBlendMode() != SkBlendMode::kSrcOver) break;
+        const qreal relFrame = child.fRelFrame;
+        const auto idRange = box->prp_getIdenticalRelRange(qFloor(relFrame));
+        if(idRange.span() < 2 || !idRange.inRange(qCeil(relFrame))) break;
+        const auto relM = box->getRelativeTransformAtFrame(relFrame);
+        members.append({box, box->stateId(), idRange,
+                        relM*child.fParentM, relFrame});
+    }
+    return members;
+}
+
+#define MIN_STATIC_RUN 2
+
 void ContainerBox::processChildrenData(const qreal relFrame,
                                        const QMatrix& thisM,
                                        BoxRenderData * const data,
@@ -989,14 +1029,56 @@ void ContainerBox::processChildrenData(const qreal relFrame,
     groupData->fChildrenRenderData.clear();
     groupData->fOtherGlobalRects.clear();
     const qreal absFrame = prp_relFrameToAbsFrameF(relFrame);
-    QList<ChildRenderData> delayed;
+    QList<ChildCandidate> children;
+    // a culled blend effect target would drop the boxes targeting it
+    const bool cull = mBoxesWithBlendEffects.isEmpty();
     const auto minMax = getContainedMinMax();
     for(int i = minMax.fMax; i >= minMax.fMin; i--) {
         const auto& box = mContainedBoxes.at(i);
         const qreal boxRelFrame = box->prp_absFrameToRelFrameF(absFrame);
-        processChildData(box, groupData, boxRelFrame,
-                         thisM, absFrame, delayed);
+        gatherChildData(box, boxRelFrame, thisM, absFrame, cull, children);
+    }
+    // the scene composites by tiles, blend effects reorder children
+    bool cacheRuns = !enve_cast<Canvas*>(this) && groupData->fParentIsTarget;
+    for(const auto& child : children) {
+        if(!cacheRuns) break;
+        const auto box = child.fBox;
+        cacheRuns = !box->hasBlendEffects() || !box->blendEffectsEnabled();
+    }
+    QList<stdsptr<StaticChildRun>> runs;
+    QList<ChildRenderData> delayed;
+    const int nChildren = children.count();
+    for(int i = 0; i < nChildren;) {
+        const auto members = cacheRuns ? staticRunAt(children, i) :
+                                         QList<StaticChildRun::Member>();
+        if(members.count() < MIN_STATIC_RUN) {
+            processChildData(children.at(i++), groupData, delayed, nullptr);
+            continue;
+        }
+        stdsptr<StaticChildRun> run;
+        for(const auto& iRun : qAsConst(mStaticRuns)) {
+            if(iRun->matches(members, groupData->fResolution)) {
+                run = iRun;
+                break;
+            }
+        }
+        const int end = i + members.count();
+        if(run && run->hasImage()) {
+            groupData->fChildrenRenderData << ChildRenderData(run);
+        } else {
+            if(!run) {
+                run = std::make_shared<StaticChildRun>();
+                run->fMembers = members;
+                run->fResolution = groupData->fResolution;
+            }
+            for(int j = i; j < end; j++) {
+                processChildData(children.at(j), groupData, delayed, run);
+            }
+        }
+        runs << run;
+        i = end;
     }
+    mStaticRuns = runs;
     for(auto& del : delayed) {
         auto& iClip = del.fClip;
         if(!iClip.fTargetBox) continue;
@@ -1413,6 +1495,8 @@ void ContainerBox::writeAllContained(eWriteStream& dst) const {
         const auto &child = mContained.at(i);
         if(enve_cast<BlendEffectBoxShadow*>(child.get())) continue;
         const auto futureId = dst.planFuturePos();
+        const int chunk = dst.beginChunk(eChunkType::contained,
+                                         child->prp_getName());
         const auto box = enve_cast<BoundingBox*>(child);
         const bool isBox = box;
         dst << isBox;
@@ -1425,6 +1509,7 @@ void ContainerBox::writeAllContained(eWriteStream& dst) const {
         }
         dst.assignFuturePos(futureId);
         dst.writeCheckpoint();
+        dst.endChunk(chunk);
     }
 }
 
@@ -1642,10 +1727,12 @@ void ContainerBox::readAllContained(eReadStream& src) {
     src >> nCont;
     for(int i = 0; i < nCont; i++) {
         const auto futurePos = src.readFuturePos();
+        const int chunk = src.chunkAt(src.pos());
         try {
             readContained(src);
         } catch(const std::exception& e) {
-            src.seek(futurePos);
+            if(chunk == -1) src.seek(futurePos);
+            else src.seekChunkEnd(chunk);
             gPrintExceptionCritical(e);
         }
     }
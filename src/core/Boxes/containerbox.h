@@ -19,6 +19,8 @@
 #include "boxwithpatheffects.h"
 #include "conncontextobjlist.h"
 
+struct StaticChildRun;
+
 class PathBox;
 class PathEffectCollection;
 class BlendEffectBoxShadow;
@@ -285,6 +287,8 @@ private:
     QList<BoundingBox*> mBoxesWithBlendEffects;
     QList<BoundingBox*> mContainedBoxes;
     QList<qsptr<BlendEffectBoxShadow>> mBlendShadows;
+    //! @brief Runs of static children composited for the last render
+    QList<stdsptr<StaticChildRun>> mStaticRuns;
     ConnContextObjList<qsptr<eBoxOrSound>> mContained;
     qsptr<FlipBookProperty> mFlipBook;
 };
@@ -75,6 +75,8 @@ void EffectSubTaskSpawner_priv::splitSpawn(CpuRenderData& data,
                 CpuRenderTools tools{mSrcBitmap, dstBitmap};
                 mEffectCaller->processCpu(tools, data);
             }, decRemaining, decRemaining);
+        subTask->setPriority(data.fPriority);
+        subTask->setDeadline(data.fDeadline);
         CpuTaskExecutor::sAddTask(subTask);
         return;
     }
@@ -120,6 +122,8 @@ void EffectSubTaskSpawner_priv::spawn() {
     data.fPos = mData->fGlobalRect.topLeft();
     data.fWidth = static_cast<uint>(srcWidth);
     data.fHeight = static_cast<uint>(srcHeight);
+    data.fPriority = mData->priority();
+    data.fDeadline = mData->deadline();
 
     splitSpawn(data, srcImage->bounds(), nThreads);
 }
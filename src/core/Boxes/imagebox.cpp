@@ -153,10 +153,15 @@ void ImageBox::setupRenderData(const qreal relFrame, const QMatrix& parentM,
                                Canvas* const scene) {
     BoundingBox::setupRenderData(relFrame, parentM, data, scene);
     const auto imgData = static_cast<ImageBoxRenderData*>(data);
-    if(mFileHandler->hasImage()) {
-        imgData->setContainer(mFileHandler->getImageContainer());
+    // mips never go below the rendered resolution, so output uses them too
+    const qreal scale = imgData->sourcePixelScale();
+    const int level = ImageCacheContainer::sProxyLevel(scale,
+                                                       IMAGE_MIP_LEVELS - 1);
+    imgData->fMipLevel = level;
+    if(mFileHandler->hasImage(level)) {
+        imgData->setContainer(mFileHandler->getImageContainer(level));
     } else {
-        const auto loader = mFileHandler->scheduleLoad();
+        const auto loader = mFileHandler->scheduleLoad(level);
         if(loader) loader->addDependent(imgData);
     }
 }
@@ -194,6 +199,6 @@ void ImageBox::saveSVG(SvgExporter& exp, DomEleTask* const eleTask) const {
 
 void ImageBoxRenderData::loadImageFromHandler() {
     if(fSrcCacheHandler) {
-        setContainer(fSrcCacheHandler->getImageContainer());
+        setContainer(fSrcCacheHandler->getImageContainer(fMipLevel));
     }
 }
@@ -31,6 +31,7 @@ struct CORE_EXPORT ImageBoxRenderData : public ImageContainerRenderData {
     void loadImageFromHandler();
 
     const qptr<ImageFileHandler> fSrcCacheHandler;
+    int fMipLevel = 0;
 };
 
 class CORE_EXPORT ImageBox : public BoundingBox {
@@ -15,6 +15,9 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "imagerenderdata.h"
+#include "simplemath.h"
+
+#include <QtMath>
 
 ImageRenderData::ImageRenderData(BoundingBox * const parentBoxT) :
     BoxRenderData(parentBoxT) {
@@ -23,7 +26,8 @@ ImageRenderData::ImageRenderData(BoundingBox * const parentBoxT) :
 
 void ImageRenderData::updateRelBoundingRect() {
     if(fImage) fRelBoundingRect =
-            QRectF(0, 0, fImage->width(), fImage->height());
+            QRectF(0, 0, fImage->width()*fProxyScale.width(),
+                   fImage->height()*fProxyScale.height());
     else fRelBoundingRect = QRectF(0, 0, 0, 0);
 }
 
@@ -39,6 +43,8 @@ void ImageRenderData::setupDirectDraw() {
     fRenderTransform.reset();
     fRenderTransform.translate(fRelBoundingRect.x(), fRelBoundingRect.y());
     fRenderTransform *= fScaledTransform;
+    if(isProxy()) fRenderTransform.scale(fProxyScale.width(),
+                                         fProxyScale.height());
     fRenderTransform.translate(-fGlobalRect.x(), -fGlobalRect.y());
     fUseRenderTransform = true;
     fRenderedImage = fImage;
@@ -46,21 +52,48 @@ void ImageRenderData::setupDirectDraw() {
     finishedProcessing();
 }
 
+qreal ImageRenderData::sourcePixelScale() const {
+    const auto& m = fTotalTransform;
+    const qreal xScale = qSqrt(m.m11()*m.m11() + m.m12()*m.m12());
+    const qreal yScale = qSqrt(m.m21()*m.m21() + m.m22()*m.m22());
+    return qMax(xScale, yScale)*fResolution;
+}
+
+bool ImageRenderData::isProxy() const {
+    return !isOne4Dec(fProxyScale.width()) ||
+           !isOne4Dec(fProxyScale.height());
+}
+
 void ImageRenderData::drawSk(SkCanvas * const canvas) {
-    const float x = static_cast<float>(fRelBoundingRect.x());
-    const float y = static_cast<float>(fRelBoundingRect.y());
+    float x = static_cast<float>(fRelBoundingRect.x());
+    float y = static_cast<float>(fRelBoundingRect.y());
+    const bool proxy = isProxy();
+    if(proxy) {
+        canvas->save();
+        canvas->translate(x, y);
+        canvas->scale(static_cast<float>(fProxyScale.width()),
+                      static_cast<float>(fProxyScale.height()));
+        x = 0;
+        y = 0;
+    }
     if(fFilterQuality > kNone_SkFilterQuality) {
         SkPaint paint;
         paint.setAntiAlias(true);
         paint.setFilterQuality(fFilterQuality);
         canvas->drawImage(fImage, x, y, &paint);
     } else if(fImage) canvas->drawImage(fImage, x, y);
+    if(proxy) canvas->restore();
 }
 
 void ImageContainerRenderData::setContainer(ImageCacheContainer *container) {
     if(!container) return;
     mSrcContainer = container;
     fImage = container->requestImageCopy();
+    const QSize srcSize = container->sourceSize();
+    if(fImage && container->proxyLevel() > 0 && !srcSize.isEmpty()) {
+        fProxyScale = QSizeF(qreal(srcSize.width())/fImage->width(),
+                             qreal(srcSize.height())/fImage->height());
+    } else fProxyScale = QSizeF(1, 1);
 }
 
 void ImageContainerRenderData::afterProcessing() {
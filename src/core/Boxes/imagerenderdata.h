@@ -24,11 +24,19 @@ struct CORE_EXPORT ImageRenderData : public BoxRenderData {
 
     virtual void loadImageFromHandler() = 0;
 
+    //! @brief Scale at which source pixels end up in the rendered image.
+    qreal sourcePixelScale() const;
+
     void updateRelBoundingRect();
     void setupRenderData() final;
 
     sk_sp<SkImage> fImage;
+    //! @brief Source size to fImage size ratio for proxy images,
+    //! the box geometry is always expressed in source pixels.
+    QSizeF fProxyScale = QSizeF(1, 1);
 private:
+    bool isProxy() const;
+
     void setupDirectDraw();
 
     void drawSk(SkCanvas * const canvas);
@@ -16,6 +16,62 @@
 
 #include "layerboxrenderdata.h"
 #include "skia/skqtconversions.h"
+#include "skia/skiahelpers.h"
+#include "Private/esettings.h"
+#include "Private/Tasks/workqueue.h"
+
+#include <QtMath>
+
+// smaller containers are not worth the synchronization
+#define BAND_MIN_AREA 1024*1024
+#define BAND_MIN_HEIGHT 128
+
+bool StaticChildRun::matches(const QList<Member>& members,
+                             const qreal resolution) const {
+    if(members.count() != fMembers.count()) return false;
+    if(!isZero4Dec(resolution - fResolution)) return false;
+    for(int i = 0; i < members.count(); i++) {
+        const auto& cached = fMembers.at(i);
+        const auto& member = members.at(i);
+        if(cached.fBox != member.fBox) return false;
+        if(cached.fStateId != member.fStateId) return false;
+        if(cached.fTotalTransform != member.fTotalTransform) return false;
+        const auto& idRange = cached.fIdenticalRange;
+        if(!idRange.inRange(qFloor(member.fRelFrame)) ||
+           !idRange.inRange(qCeil(member.fRelFrame))) return false;
+    }
+    return true;
+}
+
+void StaticChildRun::setImage(const sk_sp<SkImage>& image,
+                              const QRect& globalRect,
+                              const QRectF& relBoundingRect) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mImage = image;
+    mGlobalRect = globalRect;
+    mRelBoundingRect = relBoundingRect;
+}
+
+bool StaticChildRun::hasImage() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return static_cast<bool>(mImage);
+}
+
+void StaticChildRun::draw(SkCanvas * const canvas) const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if(!mImage) return;
+    canvas->drawImage(mImage, mGlobalRect.x(), mGlobalRect.y());
+}
+
+QRect StaticChildRun::globalRect() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mGlobalRect;
+}
+
+QRectF StaticChildRun::relBoundingRect() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mRelBoundingRect;
+}
 
 ContainerBoxRenderData::ContainerBoxRenderData(BoundingBox * const parentBox) :
     BoxRenderData(parentBox) {
@@ -27,53 +83,217 @@ void ContainerBoxRenderData::transformRenderCanvas(SkCanvas &canvas) const {
                      toSkScalar(-fGlobalRect.y()));
 }
 #include "pointhelpers.h"
+QRectF ContainerBoxRenderData::childRelBoundingRect(
+        const BoxRenderData& child) const {
+    if(child.fRelBoundingRect.isEmpty()) return QRectF();
+    QPointF tl = child.fRelBoundingRect.topLeft();
+    QPointF tr = child.fRelBoundingRect.topRight();
+    QPointF br = child.fRelBoundingRect.bottomRight();
+    QPointF bl = child.fRelBoundingRect.bottomLeft();
+
+    const auto trans = child.fTotalTransform*fTotalTransform.inverted();
+
+    tl = trans.map(tl);
+    tr = trans.map(tr);
+    br = trans.map(br);
+    bl = trans.map(bl);
+
+    QRectF result;
+    result.setTop(qMin4(tl.y(), tr.y(), br.y(), bl.y()));
+    result.setLeft(qMin4(tl.x(), tr.x(), br.x(), bl.x()));
+    result.setBottom(qMax4(tl.y(), tr.y(), br.y(), bl.y()));
+    result.setRight(qMax4(tl.x(), tr.x(), br.x(), bl.x()));
+    return result;
+}
+
 void ContainerBoxRenderData::updateRelBoundingRect() {
     fRelBoundingRect = QRectF();
-    const auto invTrans = fTotalTransform.inverted();
     for(const auto &child : fChildrenRenderData) {
-        if(child->fRelBoundingRect.isEmpty()) continue;
-        QPointF tl = child->fRelBoundingRect.topLeft();
-        QPointF tr = child->fRelBoundingRect.topRight();
-        QPointF br = child->fRelBoundingRect.bottomRight();
-        QPointF bl = child->fRelBoundingRect.bottomLeft();
-
-        const auto trans = child->fTotalTransform*invTrans;
-
-        tl = trans.map(tl);
-        tr = trans.map(tr);
-        br = trans.map(br);
-        bl = trans.map(bl);
+        QRectF childRect;
+        if(child.fData) {
+            childRect = childRelBoundingRect(*child.fData);
+            if(childRect.isNull()) continue;
+            fOtherGlobalRects << child->fGlobalRect;
+        } else {
+            childRect = child.fRun->relBoundingRect();
+            fOtherGlobalRects << child.fRun->globalRect();
+            if(childRect.isNull()) continue;
+        }
 
         if(fRelBoundingRect.isNull()) {
-            fRelBoundingRect.setTop(qMin4(tl.y(), tr.y(), br.y(), bl.y()));
-            fRelBoundingRect.setLeft(qMin4(tl.x(), tr.x(), br.x(), bl.x()));
-            fRelBoundingRect.setBottom(qMax4(tl.y(), tr.y(), br.y(), bl.y()));
-            fRelBoundingRect.setRight(qMax4(tl.x(), tr.x(), br.x(), bl.x()));
+            fRelBoundingRect = childRect;
         } else {
             fRelBoundingRect.setTop(qMin(fRelBoundingRect.top(),
-                                         qMin4(tl.y(), tr.y(), br.y(), bl.y())));
+                                         childRect.top()));
             fRelBoundingRect.setLeft(qMin(fRelBoundingRect.left(),
-                                          qMin4(tl.x(), tr.x(), br.x(), bl.x())));
+                                          childRect.left()));
             fRelBoundingRect.setBottom(qMax(fRelBoundingRect.bottom(),
-                                            qMax4(tl.y(), tr.y(), br.y(), bl.y())));
+                                            childRect.bottom()));
             fRelBoundingRect.setRight(qMax(fRelBoundingRect.right(),
-                                           qMax4(tl.x(), tr.x(), br.x(), bl.x())));
+                                           childRect.right()));
+        }
+    }
+}
+
+QRect ContainerBoxRenderData::sDrawnRect(const BoxRenderData& child) {
+    if(isZero4Dec(child.fOpacity)) return QRect();
+    // directly drawn data has no image, it draws within its global rect,
+    // with an extra pixel for antialiasing
+    if(!child.fRenderedImage) return child.fGlobalRect.adjusted(-1, -1, 1, 1);
+    if(child.fUseRenderTransform) {
+        const QRectF globalRect(child.fGlobalRect);
+        const auto drawnRect = child.fRenderTransform.mapRect(globalRect);
+        return drawnRect.toAlignedRect();
+    }
+    return QRect(child.fGlobalRect.topLeft(),
+                 QSize(child.fRenderedImage->width(),
+                       child.fRenderedImage->height()));
+}
+
+bool ContainerBoxRenderData::sAffectsAll(const SkBlendMode mode) {
+    return mode == SkBlendMode::kDstIn ||
+           mode == SkBlendMode::kSrcIn ||
+           mode == SkBlendMode::kDstATop ||
+           mode == SkBlendMode::kModulate ||
+           mode == SkBlendMode::kSrcOut;
+}
+
+bool ContainerBoxRenderData::drawBands(SkCanvas * const canvas) {
+    const int nChildren = fChildrenRenderData.count();
+    if(nChildren < 2) return false;
+    if(!canvas->isClipRect()) return false;
+    SkPixmap pixmap;
+    if(!canvas->peekPixels(&pixmap)) return false;
+    const auto clip = canvas->getDeviceClipBounds();
+    if(qint64(clip.width())*clip.height() < BAND_MIN_AREA) return false;
+    const int nBands = qMin(eSettings::sCpuThreadsCapped(),
+                            clip.height()/BAND_MIN_HEIGHT);
+    if(nBands < 2) return false;
+
+    const SkMatrix matrix = canvas->getTotalMatrix();
+    QList<BandChild> children;
+    for(int i = 0; i < nChildren; i++) {
+        const auto& child = fChildrenRenderData.at(i);
+        // the raster of a static run has to be composited in one piece
+        if(child.fRun && child.fData) return false;
+        QRect drawnRect;
+        bool affectsAll = false;
+        if(child.fData) {
+            if(isZero4Dec(child->fOpacity)) continue;
+            drawnRect = sDrawnRect(*child.fData);
+            affectsAll = sAffectsAll(child->fBlendMode);
+            // a visible child with unknown bounds cannot be banded
+            if(drawnRect.isEmpty() && !affectsAll) return false;
+        } else {
+            drawnRect = child.fRun->globalRect();
+            if(drawnRect.isEmpty()) continue;
         }
+        SkRect deviceRect;
+        matrix.mapRect(&deviceRect, toSkRect(drawnRect));
+        // filtering can touch pixels next to the drawn rect
+        auto deviceIRect = deviceRect.roundOut();
+        deviceIRect.outset(1, 1);
+        children << BandChild{i, deviceIRect, affectsAll};
+    }
+
+    SkBitmap bitmap;
+    if(!bitmap.installPixels(pixmap)) return false;
+
+    gRunJobs(nBands, nBands, priority(), deadline(), [&](const int band) {
+        const int top = clip.top() + clip.height()*band/nBands;
+        const int bottom = clip.top() + clip.height()*(band + 1)/nBands;
+        const auto bandRect = SkIRect::MakeLTRB(clip.left(), top,
+                                                clip.right(), bottom);
+        drawBand(bitmap, matrix, bandRect, children);
+    });
+    return true;
+}
 
-        fOtherGlobalRects << child->fGlobalRect;
+void ContainerBoxRenderData::drawBand(const SkBitmap& bitmap,
+                                      const SkMatrix& matrix,
+                                      const SkIRect& band,
+                                      const QList<BandChild>& children) {
+    SkCanvas canvas(bitmap);
+    canvas.clipRect(SkRect::Make(band));
+    canvas.setMatrix(matrix);
+    for(const auto& child : children) {
+        if(!child.fAffectsAll &&
+           !SkIRect::Intersects(child.fDeviceRect, band)) continue;
+        drawChild(&canvas, fChildrenRenderData.at(child.fId));
     }
 }
 
 void ContainerBoxRenderData::drawSk(SkCanvas * const canvas) {
-    for(const auto &child : fChildrenRenderData) {
-        canvas->save();
-        if(!child.fClip.fClipOps.isEmpty()) {
-            const SkMatrix transform = canvas->getTotalMatrix();
-            canvas->concat(toSkMatrix(fResolutionScale));
-            child.fClip.clip(canvas);
-            canvas->setMatrix(transform);
+    if(drawBands(canvas)) return;
+    const int nChildren = fChildrenRenderData.count();
+    for(int i = 0; i < nChildren;) {
+        const auto& child = fChildrenRenderData.at(i);
+        if(child.fRun && child.fData) {
+            int end = i + 1;
+            while(end < nChildren &&
+                  fChildrenRenderData.at(end).fRun == child.fRun) end++;
+            drawRun(canvas, i, end);
+            i = end;
+        } else {
+            drawChild(canvas, child);
+            i++;
+        }
+    }
+}
+
+void ContainerBoxRenderData::drawRun(SkCanvas * const canvas,
+                                     const int from, const int to) {
+    QRect globalRect;
+    QRectF relRect;
+    bool cacheable = true;
+    for(int i = from; i < to; i++) {
+        const auto& child = fChildrenRenderData.at(i);
+        if(child->fUseRenderTransform) cacheable = false;
+        const auto& image = child->fRenderedImage;
+        if(!image || isZero4Dec(child->fOpacity)) continue;
+        globalRect |= QRect(child->fGlobalRect.topLeft(),
+                            QSize(image->width(), image->height()));
+        relRect |= childRelBoundingRect(*child.fData);
+    }
+    if(!cacheable || globalRect.isEmpty()) {
+        for(int i = from; i < to; i++) {
+            drawChild(canvas, fChildrenRenderData.at(i));
         }
-        child->drawOnParentLayer(canvas);
-        canvas->restore();
+        return;
+    }
+    const auto info = SkiaHelpers::getPremulRGBAInfo(globalRect.width(),
+                                                     globalRect.height());
+    // matches the hardware of the canvas, raster for cpu processing
+    auto surface = canvas->makeSurface(info);
+    if(!surface) surface = SkSurface::MakeRaster(info);
+    if(!surface) {
+        for(int i = from; i < to; i++) {
+            drawChild(canvas, fChildrenRenderData.at(i));
+        }
+        return;
+    }
+    const auto runCanvas = surface->getCanvas();
+    runCanvas->clear(SK_ColorTRANSPARENT);
+    runCanvas->translate(-globalRect.x(), -globalRect.y());
+    for(int i = from; i < to; i++) {
+        drawChild(runCanvas, fChildrenRenderData.at(i));
+    }
+    auto image = surface->makeImageSnapshot();
+    if(image->isTextureBacked()) image = image->makeRasterImage();
+    fChildrenRenderData.at(from).fRun->setImage(image, globalRect, relRect);
+    canvas->drawImage(image, globalRect.x(), globalRect.y());
+}
+
+void ContainerBoxRenderData::drawChild(SkCanvas * const canvas,
+                                       const ChildRenderData& child) {
+    if(!child.fData) return child.fRun->draw(canvas);
+    canvas->save();
+    if(!child.fClip.fClipOps.isEmpty()) {
+        const SkMatrix transform = canvas->getTotalMatrix();
+        canvas->concat(toSkMatrix(fResolutionScale));
+        child.fClip.clip(canvas);
+        canvas->setMatrix(transform);
     }
+    child->drawOnParentLayer(canvas);
+    canvas->restore();
 }
@@ -17,6 +17,9 @@
 #ifndef CONTAINERBOXRENDERDATA_H
 #define CONTAINERBOXRENDERDATA_H
 #include "boxrenderdata.h"
+#include "simplemath.h"
+
+#include <mutex>
 
 struct CORE_EXPORT PathClipOp {
     SkPath fClipPath;
@@ -39,10 +42,46 @@ struct CORE_EXPORT PathClip {
     }
 };
 
+//! @brief Raster of consecutive children that do not change between frames,
+//! drawn in place of the children while they stay the same.
+struct CORE_EXPORT StaticChildRun {
+    struct Member {
+        BoundingBox* fBox;
+        uint fStateId;
+        //! @brief Identical relative frame range of fBox
+        FrameRange fIdenticalRange;
+        QMatrix fTotalTransform;
+        qreal fRelFrame;
+    };
+
+    //! @brief Compares the cached children with the ones at a new frame
+    bool matches(const QList<Member>& members,
+                 const qreal resolution) const;
+
+    //! @brief Set once the children were composited
+    void setImage(const sk_sp<SkImage>& image, const QRect& globalRect,
+                  const QRectF& relBoundingRect);
+    bool hasImage() const;
+    void draw(SkCanvas * const canvas) const;
+    QRect globalRect() const;
+    QRectF relBoundingRect() const;
+
+    QList<Member> fMembers;
+    qreal fResolution;
+private:
+    mutable std::mutex mMutex;
+    sk_sp<SkImage> mImage;
+    QRect mGlobalRect;
+    QRectF mRelBoundingRect;
+};
+
 struct CORE_EXPORT ChildRenderData {
     template <typename T>
     ChildRenderData(const stdsptr<T>& data) :
         fData(data) {}
+    //! @brief Draws the cached run instead of rendering its children
+    ChildRenderData(const stdsptr<StaticChildRun>& run) :
+        fRun(run) {}
 
     inline BoxRenderData* operator->() const
     { return fData.operator->(); }
@@ -50,6 +89,8 @@ struct CORE_EXPORT ChildRenderData {
     stdsptr<BoxRenderData> fData;
     bool fIsMain = false;
     PathClip fClip;
+    //! @brief With fData the child is composited into the run
+    stdsptr<StaticChildRun> fRun;
 };
 
 struct CORE_EXPORT ContainerBoxRenderData : public BoxRenderData {
@@ -57,11 +98,38 @@ struct CORE_EXPORT ContainerBoxRenderData : public BoxRenderData {
 public:
     ContainerBoxRenderData(BoundingBox * const parentBox);
 
+    bool startableOnWorker() const {
+        // zero opacity data finishes in beforeProcessing
+        return !isZero4Dec(fOpacity);
+    }
+
     QList<ChildRenderData> fChildrenRenderData;
+
+    //! @brief Global rect the child draws to, empty if it draws nothing,
+    //! for directly drawn children the global rect of the data
+    static QRect sDrawnRect(const BoxRenderData& child);
+    //! @brief Blend mode affects pixels outside of the drawn rect
+    static bool sAffectsAll(const SkBlendMode mode);
 protected:
     void drawSk(SkCanvas * const canvas);
+    void drawChild(SkCanvas * const canvas, const ChildRenderData& child);
     void transformRenderCanvas(SkCanvas& canvas) const final;
     void updateRelBoundingRect();
+private:
+    QRectF childRelBoundingRect(const BoxRenderData& child) const;
+    void drawRun(SkCanvas * const canvas, const int from, const int to);
+
+    struct BandChild {
+        int fId;
+        SkIRect fDeviceRect;
+        bool fAffectsAll;
+    };
+
+    //! @brief Composites horizontal bands of a large raster canvas
+    //! on multiple threads, returns false if drawSk should draw directly.
+    bool drawBands(SkCanvas * const canvas);
+    void drawBand(const SkBitmap& bitmap, const SkMatrix& matrix,
+                  const SkIRect& band, const QList<BandChild>& children);
 };
 
 #endif // CONTAINERBOXRENDERDATA_H
@@ -25,7 +25,7 @@ HddCachableCont::~HddCachableCont() {
 int HddCachableCont::free_RAM_k() {
     const int bytes = clearMemory();
     setDataInMemory(false);
-    if(!mTmpFile && !mTmpSaveTask) noDataLeft_k();
+    if(!mTmpFile && !mTmpSaveTask && !mFileRegion.isValid()) noDataLeft_k();
     return bytes;
 }
 
@@ -39,7 +39,10 @@ eTask *HddCachableCont::scheduleDeleteTmpFile() {
 
 eTask *HddCachableCont::scheduleSaveToTmpFile() {
     if(mTmpSaveTask || mTmpFile) return nullptr;
+    // unchanged data can be loaded back from the file region
+    if(mFileRegion.isValid()) return nullptr;
     mTmpSaveTask = createTmpFileDataSaver();
+    mTmpSaveTask->setPriority(eTaskPriority::backgroundIo);
     mTmpSaveTask->queTask();
     return mTmpSaveTask.get();
 }
@@ -47,7 +50,7 @@ eTask *HddCachableCont::scheduleSaveToTmpFile() {
 eTask *HddCachableCont::scheduleLoadFromTmpFile() {
     if(storesDataInMemory()) return nullptr;
     if(mTmpLoadTask) return mTmpLoadTask.get();
-    if(!mTmpSaveTask && !mTmpFile) return nullptr;
+    if(!mTmpSaveTask && !mTmpFile && !mFileRegion.isValid()) return nullptr;
 
     mTmpLoadTask = createTmpFileDataLoader();
     if(mTmpSaveTask)
@@ -68,11 +71,19 @@ void HddCachableCont::afterDataLoadedFromTmpFile() {
 }
 
 void HddCachableCont::afterDataReplaced() {
+    discardFileRegion();
     setDataInMemory(true);
     updateInMemoryManagment();
     if(mTmpFile) scheduleDeleteTmpFile();
 }
 
+void HddCachableCont::setDataInFileRegion(const eFileRegion& region) {
+    if(mTmpFile) scheduleDeleteTmpFile();
+    mFileRegion = region;
+    setDataInMemory(false);
+    removeFromMemoryManagment();
+}
+
 void HddCachableCont::setDataInMemory(const bool dataInMemory) {
     mDataInMemory = dataInMemory;
 }
@@ -18,6 +18,7 @@
 #define HddCACHABLECONT_H
 #include "cachecontainer.h"
 #include "tmpdeleter.h"
+#include "ReadWrite/emappedfile.h"
 class eTask;
 
 class CORE_EXPORT HddCachableCont : public CacheContainer {
@@ -39,12 +40,19 @@ public:
 
     bool storesDataInMemory() const { return mDataInMemory; }
     qsptr<QTemporaryFile> getTmpFile() const { return mTmpFile; }
+    const eFileRegion& getFileRegion() const { return mFileRegion; }
 protected:
     void afterDataLoadedFromTmpFile();
     void afterDataReplaced();
     void setDataInMemory(const bool dataInMemory);
 
+    //! @brief Data is not read until needed, it is loaded from the region
+    //! like from a tmp file, the region stays valid until data changes.
+    void setDataInFileRegion(const eFileRegion& region);
+    void discardFileRegion() { mFileRegion = eFileRegion(); }
+
     qsptr<QTemporaryFile> mTmpFile;
+    eFileRegion mFileRegion;
 private:
     bool mDataInMemory = false;
     stdsptr<eTask> mTmpLoadTask;
@@ -35,6 +35,18 @@ void ImageCacheContainer::replaceImage(const sk_sp<SkImage> &img) {
     afterDataReplaced();
 }
 
+void ImageCacheContainer::setProxyLevel(const int level,
+                                        const QSize& sourceSize) {
+    mProxyLevel = level;
+    mSourceSize = sourceSize;
+}
+
+int ImageCacheContainer::sProxyLevel(const qreal scale, const int maxLevel) {
+    int level = 0;
+    while(level < maxLevel && scale*(2 << level) < 1.0001) level++;
+    return level;
+}
+
 int ImageCacheContainer::getByteCount() {
     return getImageByteCount();
 }
@@ -20,6 +20,9 @@
 #include "skia/skiahelpers.h"
 #include "hddcachablerangecont.h"
 #include "imagedatahandler.h"
+
+#include <QSize>
+
 class Canvas;
 
 class CORE_EXPORT ImageCacheContainer : public HddCachableRangeCont,
@@ -39,6 +42,20 @@ public:
 
     void setDataLoadedFromTmpFile(const sk_sp<SkImage> &img);
     void replaceImage(const sk_sp<SkImage> &img);
+
+    //! @brief Marks the stored image as a proxy downscaled by 2^level
+    //! from a source of the given size.
+    void setProxyLevel(const int level, const QSize& sourceSize);
+    //! @brief 0 for full resolution images.
+    int proxyLevel() const { return mProxyLevel; }
+    const QSize& sourceSize() const { return mSourceSize; }
+
+    //! @brief Coarsest proxy level that still provides enough detail
+    //! for drawing the source at the given scale (1 - full resolution).
+    static int sProxyLevel(const qreal scale, const int maxLevel = 2);
+private:
+    int mProxyLevel = 0;
+    QSize mSourceSize;
 };
 
 
@@ -58,6 +58,9 @@ sk_sp<SkImage> ImageDataHandler::requestImageCopy() {
 }
 
 void ImageDataHandler::addImageCopy(const sk_sp<SkImage> &img) {
+    if(!mImage || !img) return;
+    // the image might have been replaced while the copy was in use
+    if(img->dimensions() != mImage->dimensions()) return;
     mImageCopies << img;
 }
 
@@ -16,13 +16,22 @@
 
 #include "tmploader.h"
 
+#include <QBuffer>
+
 TmpLoader::TmpLoader(const qsptr<QTemporaryFile> &file,
                      HddCachableCont * const target) :
     mTmpFile(file), mTarget(target) {}
 
 void TmpLoader::process() {
-    if(!mTmpFile) return;
-    if(mTmpFile->open()) {
+    if(!mTmpFile) {
+        if(!mFileRegion.isValid()) return;
+        QByteArray data = mFileRegion.data();
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        eReadStream src(mFileRegion.fEvFileVersion, &buffer);
+        read(src);
+        buffer.close();
+    } else if(mTmpFile->open()) {
         eReadStream src(mTmpFile.get());
         read(src);
         mTmpFile->close();
@@ -32,5 +41,8 @@ void TmpLoader::process() {
 }
 
 void TmpLoader::beforeProcessing(const Hardware) {
-    if(mTarget && !mTmpFile) mTmpFile = mTarget->getTmpFile();
+    if(mTarget && !mTmpFile) {
+        mTmpFile = mTarget->getTmpFile();
+        if(!mTmpFile) mFileRegion = mTarget->getFileRegion();
+    }
 }
@@ -30,6 +30,7 @@ public:
     void beforeProcessing(const Hardware);
 private:
     qsptr<QTemporaryFile> mTmpFile;
+    eFileRegion mFileRegion;
     const stdptr<HddCachableCont> mTarget;
 };
 
@@ -32,11 +32,19 @@ class CORE_EXPORT AnimationFrameHandler : public SelfRef {
 protected:
     AnimationFrameHandler();
 public:
-    virtual ImageCacheContainer* getFrameAtFrame(const int relFrame) = 0;
-    virtual ImageCacheContainer* getFrameAtOrBeforeFrame(const int relFrame) = 0;
-    virtual eTask* scheduleFrameLoad(const int frame) = 0;
+    virtual ImageCacheContainer* getFrameAtFrame(
+            const int relFrame, const int proxyLevel = 0) = 0;
+    virtual ImageCacheContainer* getFrameAtOrBeforeFrame(
+            const int relFrame, const int proxyLevel = 0) = 0;
+    //! @brief Frames may be loaded as proxies downscaled by 2^proxyLevel,
+    //! a frame already available at proxyLevel or finer is not reloaded.
+    virtual eTask* scheduleFrameLoad(const int frame,
+                                     const int proxyLevel = 0) = 0;
     virtual int getFrameCount() const = 0;
     virtual void reload() = 0;
+    //! @brief Number of frames to load ahead of the rendered one,
+    //! only useful if frames can be loaded independently.
+    virtual int prefetchCount() const { return 0; }
 
     eTaskBase* saveAnimationSVG(SvgExporter& exp, QDomElement& parent,
                                 const FrameRange& relRange,
@@ -20,6 +20,11 @@
 #include "Ora/oraimporter.h"
 #include "kraimporter.h"
 
+#include "Private/Tasks/taskscheduler.h"
+#include "Private/Tasks/taskexecutor.h"
+
+#include "include/codec/SkAndroidCodec.h"
+
 ImageFileDataHandler::ImageFileDataHandler() {}
 
 void ImageFileDataHandler::afterSourceChanged() {
@@ -35,65 +40,199 @@ void ImageFileDataHandler::afterSourceChanged() {
 }
 
 void ImageFileDataHandler::clearCache() {
-    mImage.reset();
-    mImageLoader.reset();
+    for(int i = 0; i < IMAGE_MIP_LEVELS; i++) {
+        mLevels[i].reset();
+        mLoaders[i].reset();
+    }
 }
 
-eTask *ImageFileDataHandler::scheduleLoad() {
-    if(mImage) {
-        const auto task = mImage->scheduleLoadFromTmpFile();
+eTask *ImageFileDataHandler::scheduleLoad(const int level) {
+    const int lvl = qBound(0, level, IMAGE_MIP_LEVELS - 1);
+    const auto& cont = mLevels[lvl];
+    if(cont) {
+        const auto task = cont->scheduleLoadFromTmpFile();
         if(task) return task;
     }
-    if(mImageLoader) return mImageLoader.get();
+    auto& loader = mLoaders[lvl];
+    if(loader) return loader.get();
+    const int finer = finerLevelInMemory(lvl);
+    if(finer >= 0) {
+        const auto& src = mLevels[finer];
+        loader = enve::make_shared<ImageMipBuilder>(
+                    src->getImage(), src->sourceSize(), lvl, this);
+        loader->queTask();
+        return loader.get();
+    }
     switch(mType) {
     case Type::ora:
-        mImageLoader = enve::make_shared<OraLoader>(mFilePath, this);
+        // layered formats are merged at full size, mips are built from it
+        if(lvl > 0) return scheduleLoad(0);
+        loader = enve::make_shared<OraLoader>(mFilePath, this);
         break;
     case Type::kra:
-        mImageLoader = enve::make_shared<KraLoader>(mFilePath, this);
+        if(lvl > 0) return scheduleLoad(0);
+        loader = enve::make_shared<KraLoader>(mFilePath, this);
         break;
     case Type::image:
-        mImageLoader = enve::make_shared<ImageLoader>(mFilePath, this);
+        loader = enve::make_shared<ImageLoader>(mFilePath, this, lvl);
         break;
     case Type::none: return nullptr;
     }
-    if(mImageLoader) mImageLoader->queTask();
-    return mImageLoader.get();
+    if(loader) loader->queTask();
+    return loader.get();
 }
 
-bool ImageFileDataHandler::hasImage() const {
-    if(!mImage) return false;
-    return mImage->hasImage();
+bool ImageFileDataHandler::hasImage(const int level) const {
+    const int lvl = qBound(0, level, IMAGE_MIP_LEVELS - 1);
+    const auto& cont = mLevels[lvl];
+    if(!cont) return false;
+    return cont->hasImage();
 }
 
 sk_sp<SkImage> ImageFileDataHandler::getImage() const {
-    if(!mImage) return nullptr;
-    return mImage->getImage();
+    const auto& cont = mLevels[0];
+    if(!cont) return nullptr;
+    return cont->getImage();
 }
 
-void ImageFileDataHandler::replaceImage(const sk_sp<SkImage> &img) {
+ImageCacheContainer* ImageFileDataHandler::getImageContainer(const int level) {
+    const int lvl = qBound(0, level, IMAGE_MIP_LEVELS - 1);
+    if(hasImage(lvl)) return mLevels[lvl].get();
+    const int finer = finerLevelInMemory(lvl);
+    if(finer >= 0) return mLevels[finer].get();
+    for(int i = lvl + 1; i < IMAGE_MIP_LEVELS; i++) {
+        if(hasImage(i)) return mLevels[i].get();
+    }
+    return mLevels[lvl].get();
+}
+
+int ImageFileDataHandler::finerLevelInMemory(const int level) const {
+    for(int i = level - 1; i >= 0; i--) {
+        if(hasImage(i)) return i;
+    }
+    return -1;
+}
+
+void ImageFileDataHandler::replaceImage(const int level,
+                                        const sk_sp<SkImage> &img,
+                                        const QSize& sourceSize) {
+    auto& cont = mLevels[level];
     if(img) {
-        mImage = enve::make_shared<ImageCacheContainerX>(img, this);
-    } else mImage.reset();
-    mImageLoader.reset();
+        cont = enve::make_shared<ImageCacheContainerX>(img, level, this);
+        const QSize imgSize(img->width(), img->height());
+        cont->setProxyLevel(level, sourceSize.isEmpty() ? imgSize : sourceSize);
+    } else cont.reset();
+    mLoaders[level].reset();
+}
+
+//! @brief Decodes skipping pixels where the codec supports it,
+//! e.g. JPEG is decoded at reduced size by scaling the DCT.
+sk_sp<SkImage> decodeSampled(const sk_sp<SkData>& data,
+                             const int sampleSize, QSize& sourceSize) {
+    const auto codec = SkAndroidCodec::MakeFromData(data);
+    if(!codec) return nullptr;
+    const auto srcDims = codec->getInfo().dimensions();
+    sourceSize = QSize(srcDims.width(), srcDims.height());
+    const auto dims = codec->getSampledDimensions(sampleSize);
+    const auto info = SkiaHelpers::getPremulRGBAInfo(dims.width(),
+                                                     dims.height());
+    SkBitmap bitmap;
+    if(!bitmap.tryAllocPixels(info)) return nullptr;
+    SkAndroidCodec::AndroidOptions options;
+    options.fSampleSize = sampleSize;
+    const auto result = codec->getAndroidPixels(info, bitmap.getPixels(),
+                                                bitmap.rowBytes(), &options);
+    if(result != SkCodec::kSuccess &&
+       result != SkCodec::kIncompleteInput) return nullptr;
+    return SkiaHelpers::transferDataToSkImage(bitmap);
+}
+
+sk_sp<SkImage> downscaledImage(const sk_sp<SkImage>& src,
+                               const QSize& sourceSize, const int level) {
+    if(!src) return nullptr;
+    const int div = 1 << level;
+    const int width = qMax(1, (sourceSize.width() + div - 1)/div);
+    const int height = qMax(1, (sourceSize.height() + div - 1)/div);
+    const auto info = SkiaHelpers::getPremulRGBAInfo(width, height);
+    SkBitmap bitmap;
+    if(!bitmap.tryAllocPixels(info)) return nullptr;
+    SkPixmap pixmap;
+    bitmap.peekPixels(&pixmap);
+    if(!src->scalePixels(pixmap, kMedium_SkFilterQuality)) return nullptr;
+    return SkiaHelpers::transferDataToSkImage(bitmap);
 }
 
 ImageLoader::ImageLoader(const QString &filePath,
-                         ImageFileDataHandler * const handler) :
-    mTargetHandler(handler), mFilePath(filePath) {}
+                         ImageFileDataHandler * const handler,
+                         const int level) :
+    mTargetHandler(handler), mFilePath(filePath), mLevel(level) {}
 
 void ImageLoader::process() {
-    const sk_sp<SkData> data = SkData::MakeFromFileName(
-                mFilePath.toUtf8().data());
-    mImage = SkImage::MakeFromEncoded(data);
+    if(mData) {
+        decode();
+        mData.reset();
+    } else {
+        mData = SkData::MakeFromFileName(mFilePath.toUtf8().data());
+    }
+}
+
+bool ImageLoader::nextStep() {
+    if(mData) {
+        CpuTaskExecutor::sAddTask(ref<eTask>());
+        return true;
+    }
+    return false;
+}
+
+void ImageLoader::queTaskNow() {
+    if(mData) {
+        TaskScheduler::instance()->queCpuTask(ref<eTask>());
+    } else {
+        TaskScheduler::instance()->queHddTask(ref<eTask>());
+    }
+}
+
+void ImageLoader::decode() {
+    if(mLevel > 0) {
+        mImage = decodeSampled(mData, 1 << mLevel, mSourceSize);
+        if(mImage) return;
+    }
+    const auto encoded = SkImage::MakeFromEncoded(mData);
+    if(!encoded) return;
+    mSourceSize = QSize(encoded->width(), encoded->height());
+    // decode now, otherwise the decoding happens when the image is drawn
+    mImage = encoded->makeRasterImage();
+    if(mLevel > 0) mImage = downscaledImage(mImage, mSourceSize, mLevel);
 }
 
 void ImageLoader::afterProcessing() {
-    if(mTargetHandler) mTargetHandler->replaceImage(mImage);
+    if(mTargetHandler) mTargetHandler->replaceImage(mLevel, mImage,
+                                                    mSourceSize);
 }
 
 void ImageLoader::afterCanceled() {
-    if(mTargetHandler) mTargetHandler->replaceImage(mImage);
+    if(mTargetHandler) mTargetHandler->replaceImage(mLevel, mImage,
+                                                    mSourceSize);
+}
+
+ImageMipBuilder::ImageMipBuilder(const sk_sp<SkImage> &src,
+                                 const QSize &sourceSize, const int level,
+                                 ImageFileDataHandler * const handler) :
+    mTargetHandler(handler), mSrc(src),
+    mSourceSize(sourceSize), mLevel(level) {}
+
+void ImageMipBuilder::process() {
+    mImage = downscaledImage(mSrc, mSourceSize, mLevel);
+}
+
+void ImageMipBuilder::afterProcessing() {
+    if(mTargetHandler) mTargetHandler->replaceImage(mLevel, mImage,
+                                                    mSourceSize);
+}
+
+void ImageMipBuilder::afterCanceled() {
+    if(mTargetHandler) mTargetHandler->replaceImage(mLevel, nullptr,
+                                                    mSourceSize);
 }
 
 void OraLoader::process() {
@@ -23,18 +23,52 @@
 #include "CacheHandlers/imagecachecontainer.h"
 class ImageFileDataHandler;
 
+#define IMAGE_MIP_LEVELS 5
+
+//! @brief Reads the file on the HDD executor,
+//! the decoding then runs on the CPU executors.
 class CORE_EXPORT ImageLoader : public eHddTask {
     e_OBJECT
 protected:
     ImageLoader(const QString &filePath,
-                ImageFileDataHandler * const handler);
+                ImageFileDataHandler * const handler,
+                const int level = 0);
 public:
     void process();
+    bool nextStep();
     void afterProcessing();
     void afterCanceled();
 protected:
+    void queTaskNow();
+
     const qptr<ImageFileDataHandler> mTargetHandler;
     const QString mFilePath;
+    //! @brief The image is decoded downscaled by 2^level.
+    const int mLevel;
+    sk_sp<SkImage> mImage;
+    QSize mSourceSize;
+private:
+    void decode();
+
+    sk_sp<SkData> mData;
+};
+
+//! @brief Builds a mip level by downscaling a finer level already in memory.
+class CORE_EXPORT ImageMipBuilder : public eCpuTask {
+    e_OBJECT
+protected:
+    ImageMipBuilder(const sk_sp<SkImage>& src,
+                    const QSize& sourceSize, const int level,
+                    ImageFileDataHandler * const handler);
+public:
+    void process();
+    void afterProcessing();
+    void afterCanceled();
+private:
+    const qptr<ImageFileDataHandler> mTargetHandler;
+    const sk_sp<SkImage> mSrc;
+    const QSize mSourceSize;
+    const int mLevel;
     sk_sp<SkImage> mImage;
 };
 
@@ -54,9 +88,13 @@ public:
     void process();
 };
 
+//! @brief Caches the image as a mip chain, level n stores the image
+//! downscaled by 2^n. Levels are loaded on demand, each one is managed
+//! (freed or swapped to HDD) independently.
 class CORE_EXPORT ImageFileDataHandler : public FileDataCacheHandler {
     e_OBJECT
     friend class ImageLoader;
+    friend class ImageMipBuilder;
 
     enum class Type {
         image, kra, ora, none
@@ -65,17 +103,18 @@ class CORE_EXPORT ImageFileDataHandler : public FileDataCacheHandler {
     class ImageCacheContainerX : public ImageCacheContainer {
         e_OBJECT
     protected:
-        ImageCacheContainerX(const sk_sp<SkImage>& img,
+        ImageCacheContainerX(const sk_sp<SkImage>& img, const int level,
                              ImageFileDataHandler* const handler) :
             ImageCacheContainer(img, FrameRange::EMINMAX, nullptr),
-            mHandler(handler) {}
+            mLevel(level), mHandler(handler) {}
 
         void noDataLeft_k() {
             ImageCacheContainer::noDataLeft_k();
             if(!mHandler) return;
-            mHandler->mImage.reset();
+            mHandler->mLevels[mLevel].reset();
         }
     private:
+        const int mLevel;
         const qptr<ImageFileDataHandler> mHandler;
     };
 protected:
@@ -85,17 +124,21 @@ public:
 
     void clearCache();
 
-    eTask *scheduleLoad();
+    eTask *scheduleLoad(const int level = 0);
 
-    bool hasImage() const;
+    bool hasImage(const int level = 0) const;
     sk_sp<SkImage> getImage() const;
-    ImageCacheContainer* getImageContainer() { return mImage.get(); }
+    //! @brief If the level is not in memory the nearest one that is,
+    //! preferably a finer one, is returned instead.
+    ImageCacheContainer* getImageContainer(const int level = 0);
 private:
-    void replaceImage(const sk_sp<SkImage> &img);
+    void replaceImage(const int level, const sk_sp<SkImage> &img,
+                      const QSize& sourceSize);
+    int finerLevelInMemory(const int level) const;
 
-    stdsptr<ImageCacheContainerX> mImage;
+    stdsptr<ImageCacheContainerX> mLevels[IMAGE_MIP_LEVELS];
+    stdsptr<eTask> mLoaders[IMAGE_MIP_LEVELS];
     Type mType = Type::none;
-    stdsptr<ImageLoader> mImageLoader;
 };
 
 class CORE_EXPORT ImageFileHandler : public FileCacheHandler {
@@ -111,14 +154,14 @@ protected:
 public:
     void replace();
 
-    eTask * scheduleLoad() {
+    eTask * scheduleLoad(const int level = 0) {
         if(!mDataHandler) return nullptr;
-        return mDataHandler->scheduleLoad();
+        return mDataHandler->scheduleLoad(level);
     }
 
-    bool hasImage() const {
+    bool hasImage(const int level = 0) const {
         if(!mDataHandler) return false;
-        return mDataHandler->hasImage();
+        return mDataHandler->hasImage(level);
     }
 
     sk_sp<SkImage> getImage() const {
@@ -126,9 +169,9 @@ public:
         return mDataHandler->getImage();
     }
 
-    ImageCacheContainer* getImageContainer() const {
+    ImageCacheContainer* getImageContainer(const int level = 0) const {
         if(!mDataHandler) return nullptr;
-        return mDataHandler->getImageContainer();
+        return mDataHandler->getImageContainer(level);
     }
 private:
     qsptr<ImageFileDataHandler> mDataHandler;
@@ -21,28 +21,30 @@
 #include "filesourcescache.h"
 #include "fileshandler.h"
 
-ImageCacheContainer* ImageSequenceFileHandler::getFrameAtFrame(const int relFrame) {
+ImageCacheContainer* ImageSequenceFileHandler::getFrameAtFrame(
+        const int relFrame, const int level) {
     if(mFrameImageHandlers.isEmpty()) return nullptr;
     const auto& cacheHandler = mFrameImageHandlers.at(relFrame);
     if(!cacheHandler) return nullptr;
-    return cacheHandler->getImageContainer();
+    return cacheHandler->getImageContainer(level);
 }
 
 ImageCacheContainer *ImageSequenceFileHandler::getFrameAtOrBeforeFrame(
-        const int relFrame) {
+        const int relFrame, const int level) {
     if(mFrameImageHandlers.isEmpty()) return nullptr;
     if(relFrame >= mFrameImageHandlers.count()) {
-        return mFrameImageHandlers.last()->getImageContainer();
+        return mFrameImageHandlers.last()->getImageContainer(level);
     }
     const auto& cacheHandler = mFrameImageHandlers.at(relFrame);
-    return cacheHandler->getImageContainer();
+    return cacheHandler->getImageContainer(level);
 }
 
-eTask *ImageSequenceFileHandler::scheduleFrameLoad(const int frame) {
+eTask *ImageSequenceFileHandler::scheduleFrameLoad(const int frame,
+                                                   const int level) {
     if(mFrameImageHandlers.isEmpty()) return nullptr;
     const auto& imageHandler = mFrameImageHandlers.at(frame);
-    if(imageHandler->hasImage()) return nullptr;
-    return imageHandler->scheduleLoad();
+    if(imageHandler->hasImage(level)) return nullptr;
+    return imageHandler->scheduleLoad(level);
 }
 
 void ImageSequenceFileHandler::reload() {
@@ -19,15 +19,19 @@
 #include "imagecachehandler.h"
 #include "animationcachehandler.h"
 
+#include <QThread>
+
 class CORE_EXPORT ImageSequenceFileHandler : public FileCacheHandler {
 protected:
     void reload();
 public:
     void replace();
 
-    ImageCacheContainer* getFrameAtFrame(const int relFrame);
-    ImageCacheContainer* getFrameAtOrBeforeFrame(const int relFrame);
-    eTask* scheduleFrameLoad(const int frame);
+    ImageCacheContainer* getFrameAtFrame(const int relFrame,
+                                         const int level);
+    ImageCacheContainer* getFrameAtOrBeforeFrame(const int relFrame,
+                                                 const int level);
+    eTask* scheduleFrameLoad(const int frame, const int level);
     int getFrameCount() const { return mFrameImageHandlers.count(); }
 private:
     QList<qsptr<ImageFileDataHandler>> mFrameImageHandlers;
@@ -38,18 +42,20 @@ class CORE_EXPORT ImageSequenceCacheHandler : public AnimationFrameHandler {
 protected:
     ImageSequenceCacheHandler(ImageSequenceFileHandler* fileHandler);
 public:
-    ImageCacheContainer* getFrameAtFrame(const int relFrame) {
+    ImageCacheContainer* getFrameAtFrame(const int relFrame,
+                                         const int proxyLevel) {
         if(!mFileHandler) return nullptr;
-        return mFileHandler->getFrameAtFrame(relFrame);
+        return mFileHandler->getFrameAtFrame(relFrame, proxyLevel);
     }
 
-    ImageCacheContainer* getFrameAtOrBeforeFrame(const int relFrame) {
+    ImageCacheContainer* getFrameAtOrBeforeFrame(const int relFrame,
+                                                 const int proxyLevel) {
         if(!mFileHandler) return nullptr;
-        return mFileHandler->getFrameAtOrBeforeFrame(relFrame);
+        return mFileHandler->getFrameAtOrBeforeFrame(relFrame, proxyLevel);
     }
-    eTask* scheduleFrameLoad(const int frame) {
+    eTask* scheduleFrameLoad(const int frame, const int proxyLevel) {
         if(!mFileHandler) return nullptr;
-        return mFileHandler->scheduleFrameLoad(frame);
+        return mFileHandler->scheduleFrameLoad(frame, proxyLevel);
     }
     void reload() {
         if(mFileHandler) mFileHandler->reloadAction();
@@ -58,6 +64,9 @@ public:
         if(!mFileHandler) return 0;
         return mFileHandler->getFrameCount();
     }
+    int prefetchCount() const {
+        return qBound(2, QThread::idealThreadCount(), 8);
+    }
 private:
     const qptr<ImageSequenceFileHandler> mFileHandler;
 
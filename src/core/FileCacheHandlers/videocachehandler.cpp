@@ -29,17 +29,23 @@ VideoFrameHandler::VideoFrameHandler(VideoDataHandler * const cacheHandler) :
     openVideoStream();
 }
 
-ImageCacheContainer* VideoFrameHandler::getFrameAtFrame(const int relFrame) {
+ImageCacheContainer* VideoFrameHandler::getFrameAtFrame(const int relFrame,
+                                                        const int proxyLevel) {
+    Q_UNUSED(proxyLevel)
     return mDataHandler->getFrameAtFrame(relFrame);
 }
 
-ImageCacheContainer* VideoFrameHandler::getFrameAtOrBeforeFrame(const int relFrame) {
+ImageCacheContainer* VideoFrameHandler::getFrameAtOrBeforeFrame(
+        const int relFrame, const int proxyLevel) {
+    Q_UNUSED(proxyLevel)
     return mDataHandler->getFrameAtOrBeforeFrame(relFrame);
 }
 
 void VideoFrameHandler::frameLoaderFinished(const int frame,
-                                            const sk_sp<SkImage>& image) {
-    mDataHandler->frameLoaderFinished(frame, image);
+                                            const sk_sp<SkImage>& image,
+                                            const int proxyLevel,
+                                            const QSize& sourceSize) {
+    mDataHandler->frameLoaderFinished(frame, image, proxyLevel, sourceSize);
     removeFrameLoader(frame);
 }
 
@@ -64,9 +70,10 @@ VideoFrameLoader *VideoFrameHandler::getFrameLoader(const int frame) {
     return mDataHandler->getFrameLoader(frame);
 }
 
-VideoFrameLoader *VideoFrameHandler::addFrameLoader(const int frameId) {
+VideoFrameLoader *VideoFrameHandler::addFrameLoader(const int frameId,
+                                                    const int proxyLevel) {
     const auto loader = enve::make_shared<VideoFrameLoader>(
-                    this, mVideoStreamsData, frameId);
+                    this, mVideoStreamsData, frameId, proxyLevel);
     mDataHandler->addFrameLoader(frameId, loader);
     for(const auto& nFrame : mNeededFrames) {
         const auto nLoader = getFrameLoader(nFrame);
@@ -79,9 +86,9 @@ VideoFrameLoader *VideoFrameHandler::addFrameLoader(const int frameId) {
 }
 
 VideoFrameLoader *VideoFrameHandler::addFrameConverter(
-        const int frameId,  AVFrame * const frame) {
+        const int frameId, const int proxyLevel, AVFrame * const frame) {
     const auto loader = enve::make_shared<VideoFrameLoader>(
-                    this, mVideoStreamsData, frameId, frame);
+                    this, mVideoStreamsData, frameId, proxyLevel, frame);
     mDataHandler->addFrameLoader(frameId, loader);
     return loader.get();
 }
@@ -97,15 +104,23 @@ void VideoFrameHandler::openVideoStream() {
     mDataHandler->setFrameCount(mVideoStreamsData->fFrameCount);
 }
 
-eTask* VideoFrameHandler::scheduleFrameLoad(const int frame) {
+eTask* VideoFrameHandler::scheduleFrameLoad(const int frame,
+                                            const int proxyLevel) {
     if(frame < 0 || frame >= getFrameCount())
         RuntimeThrow("Frame outside of range " + std::to_string(frame));
     const auto currLoader = getFrameLoader(frame);
-    if(currLoader) return currLoader;
-    if(mDataHandler->getFrameAtFrame(frame)) return nullptr;
-    const auto loadTask = mDataHandler->scheduleFrameHddCacheLoad(frame);
-    if(loadTask) return loadTask;
-    const auto loader = addFrameLoader(frame);
+    if(currLoader) {
+        currLoader->requestProxyLevel(proxyLevel);
+        return currLoader;
+    }
+    if(const auto cont = mDataHandler->getFrameAtFrame(frame)) {
+        // a coarser proxy gets replaced with a more detailed frame
+        if(cont->proxyLevel() <= proxyLevel) return nullptr;
+    } else {
+        const auto loadTask = mDataHandler->scheduleFrameHddCacheLoad(frame);
+        if(loadTask) return loadTask;
+    }
+    const auto loader = addFrameLoader(frame, proxyLevel);
     loader->queTask();
     return loader;
 }
@@ -179,10 +194,21 @@ void VideoDataHandler::removeFrameLoader(const int frame) {
 }
 
 void VideoDataHandler::frameLoaderFinished(const int frame,
-                                           const sk_sp<SkImage> &image) {
+                                           const sk_sp<SkImage> &image,
+                                           const int proxyLevel,
+                                           const QSize& sourceSize) {
     if(image) {
-        mFramesCache.add(enve::make_shared<ImageCacheContainer>(
-                             image, FrameRange{frame, frame}, &mFramesCache));
+        const auto curr = getFrameAtFrame(frame);
+        if(curr) {
+            if(curr->proxyLevel() <= proxyLevel) return;
+            curr->setProxyLevel(proxyLevel, sourceSize);
+            curr->replaceImage(image);
+            return;
+        }
+        const auto cont = enve::make_shared<ImageCacheContainer>(
+                    image, FrameRange{frame, frame}, &mFramesCache);
+        cont->setProxyLevel(proxyLevel, sourceSize);
+        mFramesCache.add(cont);
     } else {
         mFrameCount = frame;
         emit frameCountUpdated(mFrameCount);
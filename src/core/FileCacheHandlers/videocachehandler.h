@@ -40,7 +40,8 @@ public:
     void addFrameLoader(const int frameId, const stdsptr<VideoFrameLoader>& loader);
     VideoFrameLoader * getFrameLoader(const int frame) const;
     void removeFrameLoader(const int frame);
-    void frameLoaderFinished(const int frame, const sk_sp<SkImage>& image);
+    void frameLoaderFinished(const int frame, const sk_sp<SkImage>& image,
+                             const int proxyLevel, const QSize& sourceSize);
     eTask* scheduleFrameHddCacheLoad(const int frame);
     ImageCacheContainer* getFrameAtFrame(const int relFrame) const;
     ImageCacheContainer* getFrameAtOrBeforeFrame(const int relFrame) const;
@@ -62,15 +63,18 @@ class CORE_EXPORT VideoFrameHandler : public AnimationFrameHandler {
 protected:
     VideoFrameHandler(VideoDataHandler* const cacheHandler);
 public:
-    ImageCacheContainer* getFrameAtFrame(const int relFrame);
-    ImageCacheContainer* getFrameAtOrBeforeFrame(const int relFrame);
-    eTask *scheduleFrameLoad(const int frame);
+    ImageCacheContainer* getFrameAtFrame(const int relFrame,
+                                         const int proxyLevel = 0);
+    ImageCacheContainer* getFrameAtOrBeforeFrame(const int relFrame,
+                                                 const int proxyLevel = 0);
+    eTask *scheduleFrameLoad(const int frame, const int proxyLevel);
     int getFrameCount() const;
     void reload();
 
     void afterSourceChanged();
 
-    void frameLoaderFinished(const int frame, const sk_sp<SkImage>& image);
+    void frameLoaderFinished(const int frame, const sk_sp<SkImage>& image,
+                             const int proxyLevel, const QSize& sourceSize);
     void frameLoaderCanceled(const int frameId);
     void frameLoaderFailed(const int frameId);
 
@@ -78,8 +82,9 @@ public:
     const HddCachableCacheHandler& getCacheHandler() const;
 protected:
     VideoFrameLoader * getFrameLoader(const int frame);
-    VideoFrameLoader * addFrameLoader(const int frameId);
-    VideoFrameLoader * addFrameConverter(const int frameId, AVFrame * const frame);
+    VideoFrameLoader * addFrameLoader(const int frameId, const int proxyLevel);
+    VideoFrameLoader * addFrameConverter(const int frameId, const int proxyLevel,
+                                         AVFrame * const frame);
     void removeFrameLoader(const int frame);
 
     void openVideoStream();
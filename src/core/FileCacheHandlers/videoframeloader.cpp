@@ -21,14 +21,16 @@
 
 VideoFrameLoader::VideoFrameLoader(VideoFrameHandler * const cacheHandler,
                                    const stdsptr<VideoStreamsData> &openedVideo,
-                                   const int frameId) :
+                                   const int frameId,
+                                   const int proxyLevel) :
     mCacheHandler(cacheHandler), mOpenedVideo(openedVideo),
-    mFrameId(frameId) {}
+    mFrameId(frameId), mProxyLevel(proxyLevel) {}
 
 VideoFrameLoader::VideoFrameLoader(VideoFrameHandler * const cacheHandler,
                                    const stdsptr<VideoStreamsData> &openedVideo,
-                                   const int frameId, AVFrame * const frame) :
-    VideoFrameLoader(cacheHandler, openedVideo, frameId) {
+                                   const int frameId, const int proxyLevel,
+                                   AVFrame * const frame) :
+    VideoFrameLoader(cacheHandler, openedVideo, frameId, proxyLevel) {
     setFrameToConvert(frame, openedVideo->fCodecContext);
 }
 
@@ -40,9 +42,26 @@ VideoFrameLoader::~VideoFrameLoader() {
     cleanUp();
 }
 
+void VideoFrameLoader::requestProxyLevel(const int level) {
+    if(level < mProxyLevel) mProxyLevel = level;
+}
+
 void VideoFrameLoader::convertFrame() {
-    const auto info = SkiaHelpers::getPremulRGBAInfo(
-                mFrameToConvert->width, mFrameToConvert->height);
+    const int srcWidth = mSourceSize.width();
+    const int srcHeight = mSourceSize.height();
+    // downscaling for proxies happens in the same pass as the conversion
+    mLoadedProxyLevel = mProxyLevel;
+    const int div = 1 << mLoadedProxyLevel;
+    const int dstWidth = qMax(1, (srcWidth + div - 1)/div);
+    const int dstHeight = qMax(1, (srcHeight + div - 1)/div);
+    const int flags = mLoadedProxyLevel > 0 ? SWS_AREA : SWS_BICUBIC;
+    mSwsContext = sws_getContext(srcWidth, srcHeight, mSrcFormat,
+                                 dstWidth, dstHeight,
+                                 AV_PIX_FMT_RGBA, flags,
+                                 nullptr, nullptr, nullptr);
+    if(!mSwsContext) RuntimeThrow("Failed to create a conversion context");
+
+    const auto info = SkiaHelpers::getPremulRGBAInfo(dstWidth, dstHeight);
     SkBitmap bitmap;
     bitmap.allocPixels(info);
 
@@ -53,11 +72,10 @@ void VideoFrameLoader::convertFrame() {
     uint8_t * const dstSk[] = { static_cast<uint8_t*>(addr) };
     int linesizesSk[4];
 
-    av_image_fill_linesizes(linesizesSk, AV_PIX_FMT_RGBA,
-                            mFrameToConvert->width);
+    av_image_fill_linesizes(linesizesSk, AV_PIX_FMT_RGBA, dstWidth);
 
     sws_scale(mSwsContext, mFrameToConvert->data, mFrameToConvert->linesize,
-              0, mFrameToConvert->height, dstSk, linesizesSk);
+              0, srcHeight, dstSk, linesizesSk);
 
     mLoadedFrame = SkiaHelpers::transferDataToSkImage(bitmap);
 
@@ -186,7 +204,8 @@ void VideoFrameLoader::readFrame() {
 
 void VideoFrameLoader::afterProcessing() {
     if(!mCacheHandler) return;
-    mCacheHandler->frameLoaderFinished(mFrameId, mLoadedFrame);
+    mCacheHandler->frameLoaderFinished(mFrameId, mLoadedFrame,
+                                       mLoadedProxyLevel, mSourceSize);
     for(auto& excess : mExcessFrames) {
         if(mCacheHandler->getFrameAtFrame(excess.first)) {
             av_frame_unref(excess.second);
@@ -203,7 +222,7 @@ void VideoFrameLoader::afterProcessing() {
             currFL->setFrameToConvert(excess.second, mOpenedVideo->fCodecContext);
         } else {
             const auto newFL = mCacheHandler->addFrameConverter(
-                        excess.first, excess.second);
+                        excess.first, mLoadedProxyLevel, excess.second);
             newFL->queTask();
         }
     }
@@ -222,7 +241,8 @@ bool VideoFrameLoader::handleException() {
         finishedProcessing();
         return false;
     }
-    const auto moved = mCacheHandler->addFrameLoader(mFrameId - 1);
+    const auto moved = mCacheHandler->addFrameLoader(mFrameId - 1,
+                                                     mProxyLevel);
     moveDependent(moved);
     mCacheHandler->frameLoaderFailed(mFrameId);
     moved->queTask();
@@ -242,13 +262,8 @@ void VideoFrameLoader::setFrameToConvert(
         AVCodecContext * const codecContext) {
     cleanUp();
     mFrameToConvert = frame;
-    mSwsContext = sws_getContext(codecContext->width,
-                                 codecContext->height,
-                                 codecContext->pix_fmt,
-                                 codecContext->width,
-                                 codecContext->height,
-                                 AV_PIX_FMT_RGBA, SWS_BICUBIC,
-                                 nullptr, nullptr, nullptr);
+    mSourceSize = QSize(codecContext->width, codecContext->height);
+    mSrcFormat = codecContext->pix_fmt;
 }
 
 void VideoFrameLoader::process() {
@@ -19,6 +19,9 @@
 #include "Tasks/updatable.h"
 #include "skia/skiaincludes.h"
 #include "videocachehandler.h"
+
+#include <atomic>
+
 extern "C" {
     #include <libavutil/opt.h>
     #include <libavcodec/avcodec.h>
@@ -34,13 +37,18 @@ class CORE_EXPORT VideoFrameLoader : public eHddTask {
 protected:
     VideoFrameLoader(VideoFrameHandler * const cacheHandler,
                      const stdsptr<VideoStreamsData>& openedVideo,
-                     const int frameId);
+                     const int frameId, const int proxyLevel);
     VideoFrameLoader(VideoFrameHandler * const cacheHandler,
                      const stdsptr<VideoStreamsData>& openedVideo,
-                     const int frameId, AVFrame* const frame);
+                     const int frameId, const int proxyLevel,
+                     AVFrame* const frame);
 public:
     ~VideoFrameLoader();
 
+    int proxyLevel() const { return mProxyLevel; }
+    //! @brief Lowers the proxy level, has no effect once conversion started.
+    void requestProxyLevel(const int level);
+
     void process();
     bool nextStep();
 protected:
@@ -60,11 +68,16 @@ private:
     const qptr<VideoFrameHandler> mCacheHandler;
     const stdsptr<VideoStreamsData> mOpenedVideo;
     const int mFrameId;
+    //! @brief The frame is downscaled by 2^level during conversion.
+    std::atomic<int> mProxyLevel;
+    int mLoadedProxyLevel = 0;
+    QSize mSourceSize;
     sk_sp<SkImage> mLoadedFrame;
 
     QList<std::pair<int, AVFrame*>> mExcessFrames;
 
     AVFrame * mFrameToConvert = nullptr;
+    AVPixelFormat mSrcFormat = AV_PIX_FMT_NONE;
     struct SwsContext * mSwsContext = nullptr;
 };
 
@@ -296,16 +296,14 @@ void AnimatedSurface::addUndoRedo(const QString& name, const QRect& roi) {
     {
         prp_pushUndoRedoName(name);
         const stdptr<DrawableAutoTiledSurface> ptr = mCurrent_d;
+        const auto data = enve::make_shared<UndoTilesData>(undoList);
         UndoRedo ur;
 
-        const auto replaceTile = [this, undoList, ptr, roi](
-                                 const stdsptr<Tile>& (UndoTile::*getter)() const) {
+        const auto applyTiles = [this, data, ptr, roi](const bool undo) {
             if(!ptr) return;
             auto& surface = ptr->surface();
-            for(const auto& undoTile : undoList) {
-                surface.replaceTile(undoTile.tileX(),
-                                    undoTile.tileY(),
-                                    (undoTile.*getter)());
+            for(const auto& undoTile : data->tiles()) {
+                surface.applyUndoTile(undoTile, undo);
             }
             surface.autoCrop();
             ptr->updateTileDimensions();
@@ -313,12 +311,9 @@ void AnimatedSurface::addUndoRedo(const QString& name, const QRect& roi) {
             afterChangedCurrentContent();
         };
 
-        ur.fUndo = [replaceTile]() {
-            replaceTile(&UndoTile::oldValue);
-        };
-        ur.fRedo = [replaceTile]() {
-            replaceTile(&UndoTile::newValue);
-        };
+        ur.fUndo = [applyTiles]() { applyTiles(true); };
+        ur.fRedo = [applyTiles]() { applyTiles(false); };
+        ur.fData = data;
         prp_addUndoRedo(ur);
     }
 }
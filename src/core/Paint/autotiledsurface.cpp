@@ -31,11 +31,9 @@ AutoTiledSurfaceBase::AutoTiledSurfaceBase(const TileCreator tileCreator,
     mRequestEnd(requestEnd) {
     mypaint_tiled_surface_init(&mParent, requestStart, requestEnd);
     mParent.parent.destroy = sFree;
-//#ifdef _OPENMP
+    // tile requests are guarded by mTilesLock,
+    // libmypaint can process dirty tiles in parallel
     mParent.threadsafe_tile_requests = true;
-//#else
-//    mParent.threadsafe_tile_requests = false;
-//#endif
 }
 
 AutoTiledSurfaceBase::AutoTiledSurfaceBase(const AutoTiledSurfaceBase &other) :
@@ -103,6 +101,16 @@ stdsptr<Tile> AutoTiledSurfaceBase::requestTile(const int tx, const int ty) {
     return mAutoTilesData.requestTile(tx, ty);
 }
 
+stdsptr<Tile> AutoTiledSurfaceBase::requestTileThreadSafe(const int tx, const int ty) {
+    {
+        QReadLocker readLock(&mTilesLock);
+        if(const auto tile = mAutoTilesData.getTile(tx, ty)) return tile;
+    }
+    // stretching reallocates the column lists, has to be exclusive
+    QWriteLocker writeLock(&mTilesLock);
+    return mAutoTilesData.requestTile(tx, ty);
+}
+
 void AutoTiledSurfaceBase::sFree(MyPaintSurface *surface) {
     const auto self = reinterpret_cast<AutoTiledSurfaceBase*>(surface);
     self->free();
@@ -113,22 +121,14 @@ void AutoTiledSurfaceBase::free() {
     mypaint_tiled_surface_destroy(&mParent);
 }
 
-//#ifdef _OPENMP
-#include <omp.h>
-//#endif
-
 void AutoTiledSurface::sRequestStart(MyPaintTiledSurface *surface,
                                      MyPaintTileRequest *request) {
     const auto self = reinterpret_cast<AutoTiledSurface*>(surface);
-    #pragma omp critical
-    {
-        // make copy for undo/redo if not yet done,
-        // keep references to tiles,
-        // flush undo/redo later
-        const auto tile = self->requestTile(request->tx, request->ty);
-        if(tile) request->buffer = tile->requestZeroedData();
-        else request->buffer = nullptr;
-    }
+    // each tile is requested by at most one thread at a time,
+    // its data can be allocated without locking
+    const auto tile = self->requestTileThreadSafe(request->tx, request->ty);
+    if(tile) request->buffer = tile->requestZeroedData();
+    else request->buffer = nullptr;
 }
 
 void AutoTiledSurface::sRequestEnd(MyPaintTiledSurface *,
@@ -139,21 +139,48 @@ AutoTiledSurface::AutoTiledSurface() :
                             return std::make_shared<Tile>(size);
                          }, sRequestStart, sRequestEnd) {}
 
+UndoableAutoTiledSurface::UndoableAutoTiledSurface(
+        const UndoableAutoTiledSurface &other) :
+    AutoTiledSurfaceBase(other), mUndoList(other.mUndoList) {}
+
+UndoableAutoTiledSurface::UndoableAutoTiledSurface(
+        UndoableAutoTiledSurface &&other) :
+    AutoTiledSurfaceBase(std::move(other)),
+    mUndoList(std::move(other.mUndoList)) {}
+
+UndoableAutoTiledSurface &UndoableAutoTiledSurface::operator=(
+        const UndoableAutoTiledSurface &other) {
+    AutoTiledSurfaceBase::operator=(other);
+    mUndoList = other.mUndoList;
+    return *this;
+}
+
+UndoableAutoTiledSurface &UndoableAutoTiledSurface::operator=(
+        UndoableAutoTiledSurface &&other) {
+    AutoTiledSurfaceBase::operator=(std::move(other));
+    mUndoList = std::move(other.mUndoList);
+    return *this;
+}
+
 void UndoableAutoTiledSurface::sRequestStart(MyPaintTiledSurface *surface,
                                              MyPaintTileRequest *request) {
     const auto self = reinterpret_cast<UndoableAutoTiledSurface*>(surface);
-    #pragma omp critical
+    const auto tile = self->requestTileThreadSafe(request->tx, request->ty);
+    if(!tile) {
+        request->buffer = nullptr;
+        return;
+    }
+    const auto undoableTile = std::static_pointer_cast<UndoableTile>(tile);
     {
         // make copy for undo/redo if not yet done,
         // keep references to tiles,
         // flush undo/redo later
-        const auto tile = self->requestTile(request->tx, request->ty);
-        const auto undoableTile = std::static_pointer_cast<UndoableTile>(tile);
+        std::lock_guard<std::mutex> lk(self->mUndoListMutex);
         if(!undoableTile->fUndo) {
             self->addToUndoList(UndoTile(request->tx, request->ty, undoableTile));
         }
-        request->buffer = tile->requestZeroedData();
     }
+    request->buffer = tile->requestZeroedData();
 }
 
 void UndoableAutoTiledSurface::sRequestEnd(MyPaintTiledSurface *,
@@ -18,6 +18,8 @@
 #define AUTOTILEDSURFACE_H
 
 #include <QPointF>
+#include <QReadWriteLock>
+#include <mutex>
 
 #include "smartPointers/stdselfref.h"
 #include "libmypaintincludes.h"
@@ -140,6 +142,9 @@ public:
     void autoCrop();
 protected:
     stdsptr<Tile> requestTile(const int tx, const int ty);
+    //! @brief Safe to call concurrently from libmypaint tile requests,
+    //! existing tiles are looked up without exclusive locking.
+    stdsptr<Tile> requestTileThreadSafe(const int tx, const int ty);
 private:
     static void sFree(MyPaintSurface *surface);
 
@@ -147,6 +152,7 @@ private:
 
     MyPaintTiledSurface mParent;
     MyPaintSurface* const mMyPaintSurface;
+    QReadWriteLock mTilesLock;
     AutoTilesData mAutoTilesData;
     const TileCreator mTileCreator;
     const Request mRequestStart;
@@ -166,6 +172,11 @@ public:
 class CORE_EXPORT UndoableAutoTiledSurface : public AutoTiledSurfaceBase {
 public:
     UndoableAutoTiledSurface();
+    UndoableAutoTiledSurface(const UndoableAutoTiledSurface& other);
+    UndoableAutoTiledSurface(UndoableAutoTiledSurface&& other);
+
+    UndoableAutoTiledSurface& operator=(const UndoableAutoTiledSurface& other);
+    UndoableAutoTiledSurface& operator=(UndoableAutoTiledSurface&& other);
 
     QList<UndoTile> takeUndoList() {
         for(auto& pair : mUndoList)
@@ -177,6 +188,11 @@ public:
 
     void triggerAllChange();
 
+    void applyUndoTile(const UndoTile& tile, const bool undo) {
+        const auto dst = requestTile(tile.tileX(), tile.tileY());
+        tile.apply(*dst, undo);
+    }
+
     static void sRequestStart(MyPaintTiledSurface *surface,
                               MyPaintTileRequest *request);
     static void sRequestEnd(MyPaintTiledSurface *,
@@ -185,6 +201,7 @@ private:
     void addToUndoList(const UndoTile& tile)
     { mUndoList << tile; }
 
+    std::mutex mUndoListMutex;
     QList<UndoTile> mUndoList;
 };
 
@@ -753,6 +753,17 @@ void AutoTilesData::read(eReadStream &src) {
     }
 }
 
+void AutoTilesData::sSkip(eReadStream &src) {
+    int zeroTileCol; src >> zeroTileCol;
+    int zeroTileRow; src >> zeroTileRow;
+    int columnCount; src >> columnCount;
+    int rowCount; src >> rowCount;
+    int nCols; src >> nCols;
+    int nRows; src >> nRows;
+    const int nTiles = nCols*nRows;
+    for(int i = 0; i < nTiles; i++) Tile::sSkip(src);
+}
+
 void AutoTilesData::discardTransparentTiles() {
     for(QList<stdsptr<Tile>>& col : mColumns) {
         for(auto& tile : col) {
@@ -939,7 +950,7 @@ void AutoTilesData::moveX(const int dx, const bool extend) {
             for(int j = 0; j < mRowCount; j++) {
                 const auto& dstTile = col.at(j);
                 // move pixels inside tile
-                if(uint16_t* const dstData = dstTile->data()) {
+                if(uint16_t* const dstData = dstTile->writableData()) {
                     const int dstXDP = TILE_SIZE*4;
                     const int srcXDP = (TILE_SIZE - dpx)*4;
                     for(int y = 0; y < TILE_SIZE; y++) {
@@ -977,7 +988,7 @@ void AutoTilesData::moveX(const int dx, const bool extend) {
                 const auto& dstTile = col.at(j);
                 // move pixels inside tile
                 const int maxX = TILE_SIZE + dpx;
-                if(uint16_t* const dstData = dstTile->data()) {
+                if(uint16_t* const dstData = dstTile->writableData()) {
                     const int srcXDP = -dpx*4;
                     for(int y = 0; y < TILE_SIZE; y++) {
                         const int rowDP = y*TILE_SIZE*4;
@@ -1032,7 +1043,7 @@ void AutoTilesData::moveY(const int dy, const bool extend) {
             for(int j = mRowCount - 1; j >= 0; j--) {
                 const auto& dstTile = col.at(j);
                 // move pixels inside tile
-                if(uint16_t* const dstData = dstTile->data()) {
+                if(uint16_t* const dstData = dstTile->writableData()) {
                     for(int dstY = TILE_SIZE - 1; dstY >= dpy; dstY--) {
                         uint16_t* dst = dstData + dstY*TILE_SIZE*4;
                         uint16_t* src = dstData + (dstY - dpy)*TILE_SIZE*4;
@@ -1063,7 +1074,7 @@ void AutoTilesData::moveY(const int dy, const bool extend) {
             for(int j = 0; j < mRowCount; j++) {
                 const auto& dstTile = col.at(j);
                 // move pixels inside tile
-                if(uint16_t* const dstData = dstTile->data()) {
+                if(uint16_t* const dstData = dstTile->writableData()) {
                     const int maxY = TILE_SIZE + dpy;
                     uint16_t* dst = dstData;
                     uint16_t* src = dstData - dpy*TILE_SIZE*4;
@@ -82,6 +82,8 @@ struct CORE_EXPORT AutoTilesData {
 
     void write(eWriteStream &dst) const;
     void read(eReadStream& src);
+    //! @brief Moves past written data without reading the tiles
+    static void sSkip(eReadStream& src);
 
     void discardTransparentTiles();
     void autoCrop();
@@ -41,17 +41,23 @@ QRect BrushStroke::execute(MyPaintBrush * const brush,
     dLen = totalLength/iMax;
     const double lenFrag = 1./iMax;
 
+    // queue dabs of the whole segment in a single atomic block,
+    // libmypaint then processes all touched tiles at once
+    // (in parallel when built with OpenMP),
+    // per tile dab order stays the same so the result is deterministic
+    mypaint_surface_begin_atomic(surface);
     for(int i = 1; i <= iMax; i++) {
         const double t = fStrokePath.tAtLength(i*dLen);
-        const QRect roi = executeMove(brush, surface, t, lenFrag);
-        changedRect = changedRect.united(roi);
+        executeMove(brush, surface, t, lenFrag);
     }
-    return changedRect;
+    MyPaintRectangle roi;
+    mypaint_surface_end_atomic(surface, &roi);
+    return changedRect.united(QRect(roi.x, roi.y, roi.width, roi.height));
 }
 
-QRect BrushStroke::executeMove(MyPaintBrush * const brush,
-                               MyPaintSurface * const surface,
-                               const double t, const double lenFrag) const {
+void BrushStroke::executeMove(MyPaintBrush * const brush,
+                              MyPaintSurface * const surface,
+                              const double t, const double lenFrag) const {
     const QPointF pos = fStrokePath.posAtT(t);
     const qreal pressure = fPressure.valAtT(t);
     const qreal xTilt = fXTilt.valAtT(t);
@@ -67,12 +73,8 @@ QRect BrushStroke::executeMove(MyPaintBrush * const brush,
                                  MYPAINT_BRUSH_SETTING_RADIUS_LOGARITHMIC,
                                  qLn(width));
 
-    mypaint_surface_begin_atomic(surface);
     mypaint_brush_stroke_to(brush, surface, pos.x(), pos.y(), pressure,
                             xTilt, yTilt, time*lenFrag);
-    MyPaintRectangle roi;
-    mypaint_surface_end_atomic(surface, &roi);
-    return QRect(roi.x, roi.y, roi.width, roi.height);
 }
 
 QRect BrushStroke::executePress(MyPaintBrush * const brush,
@@ -44,10 +44,10 @@ private:
                   const bool press,
                   double dLen) const;
 
-    QRect executeMove(MyPaintBrush * const brush,
-                      MyPaintSurface * const surface,
-                      const double t,
-                      const double lenFrag) const;
+    void executeMove(MyPaintBrush * const brush,
+                     MyPaintSurface * const surface,
+                     const double t,
+                     const double lenFrag) const;
 
     QRect executePress(MyPaintBrush * const brush,
                        MyPaintSurface * const surface) const;
@@ -16,6 +16,9 @@
 
 #include "drawableautotiledsurface.h"
 #include "skia/skiahelpers.h"
+#include "ReadWrite/evformat.h"
+
+#include <QBuffer>
 
 DrawableAutoTiledSurface::DrawableAutoTiledSurface() :
     mRowCount(mTileBitmaps.fRowCount),
@@ -29,15 +32,16 @@ DrawableAutoTiledSurface::DrawableAutoTiledSurface() :
 DrawableAutoTiledSurface::DrawableAutoTiledSurface(
         const DrawableAutoTiledSurface &other) :
     DrawableAutoTiledSurface() {
-    mSurface = other.mSurface;
-    mTileBitmaps = other.mTileBitmaps;
+    *this = other;
 }
 
 DrawableAutoTiledSurface &DrawableAutoTiledSurface::operator=(
         const DrawableAutoTiledSurface &other) {
     mSurface = other.mSurface;
     mTileBitmaps = other.mTileBitmaps;
-    afterDataReplaced();
+    if(!other.storesDataInMemory() && other.mFileRegion.isValid()) {
+        setDataInFileRegion(other.mFileRegion);
+    } else afterDataReplaced();
     return *this;
 }
 
@@ -65,17 +69,46 @@ void DrawableAutoTiledSurface::drawOnCanvas(SkCanvas * const canvas,
 
 void DrawableAutoTiledSurface::pixelRectChanged(const QRect &pixRect) {
     if(mTmpFile) scheduleDeleteTmpFile();
+    if(storesDataInMemory()) discardFileRegion();
     updateTileRecBitmaps(pixRectToTileRect(pixRect));
 }
 
 void DrawableAutoTiledSurface::write(eWriteStream &dst) {
     if(!storesDataInMemory()) {
-        if(!mTmpFile) RuntimeThrow("No tmp file, and no data in memory");
-        dst.writeFile(mTmpFile.get());
+        if(mTmpFile) {
+            dst.writeFile(mTmpFile.get());
+        } else if(mFileRegion.isValid()) {
+            writeFileRegion(dst);
+        } else RuntimeThrow("No tmp file, and no data in memory");
     } else mSurface.write(dst);
 }
 
+void DrawableAutoTiledSurface::writeFileRegion(eWriteStream &dst) const {
+    QByteArray data = mFileRegion.data();
+    if(mFileRegion.fEvFileVersion == EvFormat::version) {
+        dst.write(data.data(), data.size());
+        return;
+    }
+    // written in an older format, has to be read to be converted
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadOnly);
+    eReadStream src(mFileRegion.fEvFileVersion, &buffer);
+    UndoableAutoTiledSurface surface;
+    surface.read(src);
+    buffer.close();
+    surface.write(dst);
+}
+
 void DrawableAutoTiledSurface::read(eReadStream &src) {
+    if(src.mappedFile()) {
+        // tiles are only read when the surface is needed
+        const qint64 pos = src.pos();
+        AutoTilesData::sSkip(src);
+        mSurface.clear();
+        clearBitmaps();
+        setDataInFileRegion(src.mappedRegion(pos));
+        return;
+    }
     mSurface.read(src);
     afterDataReplaced();
     updateTileBitmaps();
@@ -169,11 +202,13 @@ void DrawableAutoTiledSurface::updateTileDimensions() {
 }
 
 void DrawableAutoTiledSurface::crop(const QRect& crop) {
+    if(storesDataInMemory()) discardFileRegion();
     mSurface.crop(crop);
     updateTileBitmaps();
 }
 
 void DrawableAutoTiledSurface::move(const int dx, const int dy) {
+    if(storesDataInMemory()) discardFileRegion();
     mSurface.move(dx, dy);
     updateTileBitmaps();
 }
@@ -101,6 +101,8 @@ public:
     QPoint zeroTilePos() const
     { return zeroTile()*TILE_SIZE; }
 private:
+    void writeFileRegion(eWriteStream& dst) const;
+
     void removeFirstColumn();
     void removeLastColumn();
     void removeFirstRow();
@@ -16,10 +16,22 @@
 
 #include "onionskin.h"
 
+#include <QtMath>
+
+//! @brief Scale at which the skins are composited,
+//! rounded up to a power of two so zooming reuses the cache.
+static SkScalar compositeScale(SkCanvas * const canvas) {
+    const SkScalar scale = canvas->getTotalMatrix().getMaxScale();
+    if(scale <= 0 || scale >= 1) return 1;
+    const SkScalar minScale = 1.f/64;
+    SkScalar result = 1;
+    while(result*0.5f >= scale && result > minScale) result *= 0.5f;
+    return result;
+}
 
 void OnionSkin::draw(SkCanvas * const canvas) {
-    fPrev.draw(canvas);
-    fNext.draw(canvas);
+    fPrev.draw(canvas, mCache);
+    fNext.draw(canvas, mCache);
 }
 
 void OnionSkin::clear() {
@@ -27,6 +39,62 @@ void OnionSkin::clear() {
     fNext.clear();
 }
 
+void OnionSkin::invalidate(const DrawableAutoTiledSurface * const surface) {
+    mCache.invalidate(surface);
+    fPrev.fImage.reset();
+    fNext.fImage.reset();
+}
+
+void OnionSkin::clearCache() {
+    mCache.clear();
+    fPrev.fImage.reset();
+    fNext.fImage.reset();
+}
+
+const OnionSkin::Cache::Entry* OnionSkin::Cache::find(
+        const SkColor4f& color, const QList<Skin>& skins,
+        const SkScalar scale) {
+    for(int i = 0; i < mEntries.count(); i++) {
+        const auto& entry = mEntries.at(i);
+        if(entry.fScale != scale || entry.fColor != color) continue;
+        if(entry.fSkins != skins) continue;
+        if(i != 0) mEntries.move(i, 0);
+        return &mEntries.first();
+    }
+    return nullptr;
+}
+
+void OnionSkin::Cache::add(const Entry& entry) {
+    const qint64 bytes = sBytes(entry);
+    // the side keeps its image, a composite this big is not worth caching
+    if(bytes > sMaxBytes) return;
+    mEntries.prepend(entry);
+    mBytes += bytes;
+    while(mEntries.count() > sMaxEntries || mBytes > sMaxBytes) {
+        mBytes -= sBytes(mEntries.takeLast());
+    }
+}
+
+void OnionSkin::Cache::invalidate(
+        const DrawableAutoTiledSurface * const surface) {
+    for(int i = mEntries.count() - 1; i >= 0; i--) {
+        for(const auto& skin : mEntries.at(i).fSkins) {
+            if(skin.fSurface != surface) continue;
+            mBytes -= sBytes(mEntries.takeAt(i));
+            break;
+        }
+    }
+}
+
+void OnionSkin::Cache::clear() {
+    mEntries.clear();
+    mBytes = 0;
+}
+
+qint64 OnionSkin::Cache::sBytes(const Entry& entry) {
+    return qint64(entry.fImage->width())*entry.fImage->height()*4;
+}
+
 SkIRect OnionSkin::Skin::boundingRect() const {
     return toSkIRect(fSurface->pixelBoundingRect());
 }
@@ -43,12 +111,30 @@ SkIRect OnionSkin::SkinsSide::boundingRect() const {
     return result;
 }
 
-void OnionSkin::SkinsSide::draw(SkCanvas * const canvas) {
+void OnionSkin::SkinsSide::draw(SkCanvas * const canvas, Cache& cache) {
     if(fSkins.isEmpty()) return;
-    if(!fImage) setupImage(canvas->getGrContext());
+    const SkScalar scale = compositeScale(canvas);
+    if(fImage && fImageScale != scale) fImage.reset();
+    if(!fImage) {
+        const auto cached = cache.find(fColor, fSkins, scale);
+        if(cached) {
+            fImage = cached->fImage;
+            fImageXY = cached->fImageXY;
+            fImageScale = scale;
+        } else {
+            setupImage(canvas, scale);
+            if(!fImage) return;
+            cache.add({fColor, fSkins, scale, fImage, fImageXY});
+        }
+    }
     SkPaint paint;
     paint.setAlphaf(0.5f);
-    canvas->drawImage(fImage, fImageXY.x(), fImageXY.y(), &paint);
+    paint.setFilterQuality(kLow_SkFilterQuality);
+    canvas->save();
+    canvas->translate(fImageXY.x(), fImageXY.y());
+    canvas->scale(1/fImageScale, 1/fImageScale);
+    canvas->drawImage(fImage, 0, 0, &paint);
+    canvas->restore();
 }
 
 void OnionSkin::SkinsSide::clear() {
@@ -56,22 +142,22 @@ void OnionSkin::SkinsSide::clear() {
     fImage.reset();
 }
 
-void OnionSkin::SkinsSide::setupImage(GrContext * const grContext) {
+void OnionSkin::SkinsSide::setupImage(SkCanvas * const canvas,
+                                      const SkScalar scale) {
     const auto bRect = boundingRect();
     if(bRect.width() <= 0 || bRect.height() <= 0) return;
     fImageXY = bRect.topLeft();
-    const auto grTex = grContext->createBackendTexture(
-                bRect.width(), bRect.height(),
-                kRGBA_8888_SkColorType, GrMipMapped::kNo,
-                GrRenderable::kYes);
-
-    sk_sp<SkSurface> gpuSurface = SkSurface::MakeFromBackendTexture(
-                grContext, grTex,
-                kTopLeft_GrSurfaceOrigin, 0,
-                kRGBA_8888_SkColorType,
-                nullptr, nullptr);
-    const auto texCanvas = gpuSurface->getCanvas();
+    fImageScale = scale;
+    const int width = qCeil(bRect.width()*scale);
+    const int height = qCeil(bRect.height()*scale);
+    const auto info = SkiaHelpers::getPremulRGBAInfo(width, height);
+    // matches the hardware of the canvas, raster for cpu drawing
+    auto surface = canvas->makeSurface(info);
+    if(!surface) surface = SkSurface::MakeRaster(info);
+    if(!surface) return;
+    const auto texCanvas = surface->getCanvas();
     texCanvas->clear(SK_ColorTRANSPARENT);
+    texCanvas->scale(scale, scale);
     texCanvas->translate(-fImageXY.x(), -fImageXY.y());
     for(const auto& skin : fSkins) {
         SkPaint paint;
@@ -83,11 +169,10 @@ void OnionSkin::SkinsSide::setupImage(GrContext * const grContext) {
             0, 0, 0, fColor.fA*skin.fWeight, 0};
         const auto colF = SkColorFilters::Matrix(colM);
         paint.setColorFilter(colF);
+        paint.setFilterQuality(kLow_SkFilterQuality);
 
         skin.fSurface->drawOnCanvas(texCanvas, {0, 0}, &paint);
     }
     texCanvas->flush();
-    fImage = SkImage::MakeFromAdoptedTexture(grContext, grTex,
-                                             kTopLeft_GrSurfaceOrigin,
-                                             kRGBA_8888_SkColorType);
+    fImage = surface->makeImageSnapshot();
 }
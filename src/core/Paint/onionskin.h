@@ -24,6 +24,38 @@ struct CORE_EXPORT OnionSkin {
         float fWeight;
 
         SkIRect boundingRect() const;
+
+        bool operator==(const Skin& other) const {
+            return fSurface == other.fSurface && fWeight == other.fWeight;
+        }
+    };
+
+    //! @brief Keeps composites of recently drawn skin sets,
+    //! so scrubbing across the same keys does not redraw the surfaces.
+    class Cache {
+    public:
+        struct Entry {
+            SkColor4f fColor;
+            QList<Skin> fSkins;
+            SkScalar fScale;
+            sk_sp<SkImage> fImage;
+            SkIPoint fImageXY;
+        };
+
+        const Entry* find(const SkColor4f& color, const QList<Skin>& skins,
+                          const SkScalar scale);
+        void add(const Entry& entry);
+        void invalidate(const DrawableAutoTiledSurface* const surface);
+        void clear();
+    private:
+        static qint64 sBytes(const Entry& entry);
+
+        static const int sMaxEntries = 24;
+        //! @brief Full resolution composites of large canvases are big,
+        //! the cache is kept small as it is not seen by the memory handler
+        static const qint64 sMaxBytes = 128*1024*1024;
+        QList<Entry> mEntries;
+        qint64 mBytes = 0;
     };
 
     struct SkinsSide {
@@ -31,11 +63,12 @@ struct CORE_EXPORT OnionSkin {
         QList<Skin> fSkins;
         sk_sp<SkImage> fImage;
         SkIPoint fImageXY;
+        SkScalar fImageScale = 1;
 
         SkIRect boundingRect() const;
-        void draw(SkCanvas * const canvas);
+        void draw(SkCanvas * const canvas, Cache& cache);
         void clear();
-        void setupImage(GrContext* const grContext);
+        void setupImage(SkCanvas * const canvas, const SkScalar scale);
     };
 
     SkinsSide fPrev{{1, 0, 0, 1}, QList<Skin>(), nullptr, {0, 0}};
@@ -43,6 +76,13 @@ struct CORE_EXPORT OnionSkin {
 
     void draw(SkCanvas * const canvas);
     void clear();
+
+    //! @brief Drops cached composites including the surface,
+    //! call whenever the surface content changes or it gets removed.
+    void invalidate(const DrawableAutoTiledSurface* const surface);
+    void clearCache();
+private:
+    Cache mCache;
 };
 
 #endif // ONIONSKIN_H
@@ -76,6 +76,7 @@ void PaintTarget::setPaintBox(PaintBox * const box) {
     if(mPaintDrawableBox) {
         mPaintDrawableBox->setVisibleForScene(true);
     }
+    mPaintOnion.clearCache();
     auto& conn = mPaintDrawableBox.assign(box);
     if(mPaintDrawableBox) {
         mPaintDrawableBox->setVisibleForScene(false);
@@ -86,6 +87,25 @@ void PaintTarget::setPaintBox(PaintBox * const box) {
         conn << QObject::connect(mPaintAnimSurface,
                                  &AnimatedSurface::currentSurfaceChanged,
                                  mCanvas, setter);
+        const auto invalidateRange = [this](const FrameRange& range) {
+            const auto relRange = mPaintAnimSurface->prp_absRangeToRelRange(range);
+            const auto minId = mPaintAnimSurface->anim_getNextKeyId(relRange.fMin - 1);
+            const auto maxId = mPaintAnimSurface->anim_getPrevKeyId(relRange.fMax + 1);
+            if(minId == -1 || maxId == -1) return;
+            for(int i = minId; i <= maxId; i++) {
+                const auto iKey = mPaintAnimSurface->anim_getKeyAtIndex<ASKey>(i);
+                mPaintOnion.invalidate(&iKey->dSurface());
+            }
+        };
+        conn << QObject::connect(mPaintAnimSurface,
+                                 &Property::prp_absFrameRangeChanged,
+                                 mCanvas, invalidateRange);
+        const auto invalidateKey = [this](Key* const key) {
+            const auto asKey = static_cast<ASKey*>(key);
+            mPaintOnion.invalidate(&asKey->dSurface());
+        };
+        conn << QObject::connect(mPaintAnimSurface, &Animator::anim_removedKey,
+                                 mCanvas, invalidateKey);
         setPaintDrawable(mPaintAnimSurface->getCurrentSurface(),
                          mPaintAnimSurface->anim_getCurrentRelFrame());
     } else {
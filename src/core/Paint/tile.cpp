@@ -23,16 +23,17 @@ Tile::Tile(const Tile &other) : Tile(other.fSize) {
     copyFrom(other);
 }
 
-Tile::~Tile() { if(mData) delete[] mData; }
+Tile::~Tile() {}
 
 void Tile::swap(Tile &other) {
-    std::swap(mData, other.mData);
+    mData.swap(other.mData);
 }
 
 void Tile::allocateData() {
-    removeData();
-    mData = new uint16_t[fSize];
-    if(!mData) RuntimeThrow("Could not allocate memory for a tile.");
+    const int bytes = int(fSize*sizeof(uint16_t));
+    mData = QByteArray(bytes, Qt::Uninitialized);
+    if(mData.size() != bytes)
+        RuntimeThrow("Could not allocate memory for a tile.");
 }
 
 void Tile::zeroData() {
@@ -40,39 +41,46 @@ void Tile::zeroData() {
 }
 
 void Tile::removeData() {
-    if(mData) {
-        delete[] mData;
-        mData = nullptr;
-    }
+    mData.clear();
 }
 
 bool Tile::dataTransparent() {
-    if(!mData) return false;
+    const auto tileData = data();
+    if(!tileData) return false;
     for(size_t a = 3; a < fSize; a += 4) {
-        if(mData[a] != 0) return false;
+        if(tileData[a] != 0) return false;
     }
     return true;
 }
 
 uint16_t *Tile::requestData() {
-    if(!mData) allocateData();
-    return mData;
+    if(mData.isEmpty()) allocateData();
+    return writableData();
 }
 
 uint16_t *Tile::requestZeroedData() {
-    if(!mData) {
+    if(mData.isEmpty()) {
         allocateData();
         zeroData();
     }
-    return mData;
+    return writableData();
 }
 
-uint16_t *Tile::data() const { return mData; }
+uint16_t *Tile::writableData() {
+    if(mData.isEmpty()) return nullptr;
+    // copies the data if it is still shared with a save
+    return reinterpret_cast<uint16_t*>(mData.data());
+}
+
+const uint16_t *Tile::data() const {
+    if(mData.isEmpty()) return nullptr;
+    return reinterpret_cast<const uint16_t*>(mData.constData());
+}
 
 void Tile::write(eWriteStream &dst) const {
     dst << static_cast<uint64_t>(fSize);
-    const bool data = mData; dst << data;
-    if(data) dst.writeCompressed(mData, fSize*sizeof(uint16_t));
+    const bool data = !mData.isEmpty(); dst << data;
+    if(data) dst.writeCompressed(mData);
 }
 
 stdsptr<Tile> Tile::sRead(eReadStream &src, const TileCreator &tileCreator) {
@@ -90,12 +98,16 @@ stdsptr<Tile> Tile::sRead(eReadStream &src, const TileCreator &tileCreator) {
     return result;
 }
 
+void Tile::sSkip(eReadStream &src) {
+    uint64_t size; src >> size;
+    bool data; src >> data;
+    if(!data) return;
+    if(src.evFileVersion() >= EvFormat::dataCompression) {
+        int compressedSize; src >> compressedSize;
+        src.skip(compressedSize);
+    } else src.skip(qint64(size*sizeof(uint16_t)));
+}
+
 void Tile::copyFrom(const Tile &other) {
-    const auto otherData = other.data();
-    if(otherData) {
-        const auto thisData = requestData();
-        memcpy(thisData, otherData, fSize*sizeof(uint16_t));
-    } else {
-        removeData();
-    }
+    mData = other.mData;
 }
@@ -16,6 +16,8 @@
 
 #ifndef TILE_H
 #define TILE_H
+#include <QByteArray>
+
 #include "exceptions.h"
 #include "ReadWrite/ereadstream.h"
 #include "ReadWrite/ewritestream.h"
@@ -36,20 +38,26 @@ public:
 
     bool dataTransparent();
 
+    //! @brief Data is implicitly shared with copies taken for saving,
+    //! pointers returned by request functions are detached and writable
     uint16_t* requestData();
     uint16_t* requestZeroedData();
-    uint16_t* data() const;
+    //! @brief Returns nullptr if there is no data
+    uint16_t* writableData();
+    const uint16_t* data() const;
 
     void write(eWriteStream& dst) const;
 
     using TileCreator = std::function<stdsptr<Tile>(const size_t&)>;
     static stdsptr<Tile> sRead(eReadStream& src, const TileCreator& tileCreator);
+    //! @brief Moves past tile data without reading it
+    static void sSkip(eReadStream& src);
 
     void copyFrom(const Tile& other);
 
     const size_t fSize;
 private:
-    uint16_t* mData = nullptr;
+    QByteArray mData;
 };
 
 #endif // TILE_H
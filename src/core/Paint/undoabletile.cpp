@@ -14,7 +14,72 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+
 #include "undoabletile.h"
+#include <QHash>
+#include "Tasks/updatable.h"
+#include "CacheHandlers/tmpdeleter.h"
+
+//! @brief Stores the values that differ between the old and the new data
+//! as runs of (unchanged count, changed count, old values, new values),
+//! null data counts as zeros.
+static QByteArray diffRleEncode(const uint16_t* const oldData,
+                                const uint16_t* const newData,
+                                const size_t size) {
+    const auto oldValue = [oldData](const size_t i) {
+        return oldData ? oldData[i] : uint16_t(0);
+    };
+    const auto newValue = [newData](const size_t i) {
+        return newData ? newData[i] : uint16_t(0);
+    };
+    const auto changed = [&](const size_t i) {
+        return oldValue(i) != newValue(i);
+    };
+    QVector<uint16_t> result;
+    size_t i = 0;
+    while(i < size) {
+        uint16_t unchanged = 0;
+        while(i < size && unchanged < UINT16_MAX && !changed(i)) {
+            unchanged++;
+            i++;
+        }
+        if(i == size) break;
+        const size_t first = i;
+        uint16_t count = 0;
+        while(i < size && count < UINT16_MAX && changed(i)) {
+            count++;
+            i++;
+        }
+        result << unchanged << count;
+        for(size_t j = first; j < i; j++) result << oldValue(j);
+        for(size_t j = first; j < i; j++) result << newValue(j);
+    }
+    return QByteArray(reinterpret_cast<const char*>(result.constData()),
+                      result.count()*int(sizeof(uint16_t)));
+}
+
+//! @brief Writes the old or the new values of the changed runs,
+//! values outside of the runs are the same in both states
+static void diffRleApply(const QByteArray& delta, uint16_t* const data,
+                         const bool old) {
+    const auto runs = reinterpret_cast<const uint16_t*>(delta.constData());
+    const int count = delta.size()/int(sizeof(uint16_t));
+    size_t pos = 0;
+    int i = 0;
+    while(i + 1 < count) {
+        pos += runs[i++];
+        const int changed = runs[i++];
+        const auto values = runs + i + (old ? 0 : changed);
+        memcpy(data + pos, values, size_t(changed)*sizeof(uint16_t));
+        pos += size_t(changed);
+        i += 2*changed;
+    }
+}
+
+static uint tileChecksum(const uint16_t* const data, const size_t size) {
+    if(!data) return 0;
+    return qHashBits(data, size*sizeof(uint16_t));
+}
 
 UndoTile::UndoTile(const int tx, const int ty, const stdsptr<UndoableTile> &tile) :
     mX(tx), mY(ty), mTile(tile) {
@@ -23,7 +88,128 @@ UndoTile::UndoTile(const int tx, const int ty, const stdsptr<UndoableTile> &tile
 }
 
 void UndoTile::saveForRedoAndReset() {
-    mNewValue = std::make_shared<Tile>(*mTile);
+    const auto oldData = mOldValue->data();
+    const auto newData = mTile->data();
+    mOldData = oldData;
+    mNewData = newData;
+    mOldChecksum = tileChecksum(oldData, mTile->fSize);
+    mNewChecksum = tileChecksum(newData, mTile->fSize);
+    mDelta = diffRleEncode(oldData, newData, mTile->fSize);
+    mOldValue.reset();
     mTile->fUndo = false;
     mTile.reset();
 }
+
+void UndoTile::apply(Tile &tile, const bool undo) const {
+    // changed values are written as recorded, but a tile modified
+    // without an undo entry keeps the unrecorded unchanged values
+    const uint expected = undo ? mNewChecksum : mOldChecksum;
+    if(tileChecksum(tile.data(), tile.fSize) != expected) {
+        qWarning() << "Tile" << mX << mY <<
+                      "does not match the state recorded for undo.";
+    }
+    if(!(undo ? mOldData : mNewData)) return tile.removeData();
+    diffRleApply(mDelta, tile.requestZeroedData(), undo);
+}
+
+void UndoTile::write(eWriteStream &dst) const {
+    dst << mX << mY;
+    dst << mOldData << mNewData;
+    dst << mOldChecksum << mNewChecksum;
+    dst << mDelta;
+}
+
+void UndoTile::read(eReadStream &src) {
+    src >> mX >> mY;
+    src >> mOldData >> mNewData;
+    src >> mOldChecksum >> mNewChecksum;
+    src >> mDelta;
+}
+
+class UndoTilesSaver : public eHddTask {
+    e_OBJECT
+protected:
+    UndoTilesSaver(const QList<UndoTile>& tiles,
+                   UndoTilesData* const target) :
+        mTiles(tiles), mTarget(target) {}
+public:
+    void process() {
+        const auto tmpFile = qsptr<QTemporaryFile>(new QTemporaryFile());
+        if(!tmpFile->open()) return;
+        eWriteStream dst(tmpFile.get());
+        dst << mTiles.count();
+        for(const auto& tile : mTiles) tile.write(dst);
+        tmpFile->close();
+        mTmpFile = tmpFile;
+    }
+
+    void afterProcessing() {
+        if(!mTarget) return;
+        mTarget->setSavedToTmpFile(mTmpFile);
+    }
+private:
+    const QList<UndoTile> mTiles;
+    const stdptr<UndoTilesData> mTarget;
+    qsptr<QTemporaryFile> mTmpFile;
+};
+
+UndoTilesData::UndoTilesData(const QList<UndoTile> &tiles) :
+    mTiles(tiles) {}
+
+UndoTilesData::~UndoTilesData() {
+    if(!mTmpFile) return;
+    const auto deleter = enve::make_shared<TmpDeleter>(mTmpFile);
+    deleter->queTask();
+}
+
+int UndoTilesData::bytesInMemory() const {
+    if(!mInMemory) return 0;
+    int bytes = 0;
+    for(const auto& tile : mTiles) bytes += tile.byteCount();
+    return bytes;
+}
+
+int UndoTilesData::moveToTmpFile() {
+    if(!mInMemory) return 0;
+    if(mTmpFile) {
+        const int bytes = bytesInMemory();
+        mTiles.clear();
+        mInMemory = false;
+        return bytes;
+    }
+    if(!mSaveTask) {
+        mSaveTask = enve::make_shared<UndoTilesSaver>(mTiles, this);
+        mSaveTask->setPriority(eTaskPriority::backgroundIo);
+        mSaveTask->queTask();
+    }
+    // nothing is freed until the tiles are written
+    return 0;
+}
+
+const QList<UndoTile> &UndoTilesData::tiles() {
+    if(mInMemory) return mTiles;
+    if(!mTmpFile->open()) {
+        qDebug() << "Could not open temporary file for reading.";
+        return mTiles;
+    }
+    eReadStream src(mTmpFile.get());
+    int count; src >> count;
+    for(int i = 0; i < count; i++) {
+        UndoTile tile;
+        tile.read(src);
+        mTiles << tile;
+    }
+    mTmpFile->close();
+    mInMemory = true;
+    return mTiles;
+}
+
+int UndoTilesData::setSavedToTmpFile(const qsptr<QTemporaryFile> &file) {
+    mSaveTask.reset();
+    if(!file) return 0;
+    mTmpFile = file;
+    const int bytes = bytesInMemory();
+    mTiles.clear();
+    mInMemory = false;
+    return bytes;
+}
@@ -14,9 +14,15 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+
 #ifndef UNDOABLETILE_H
 #define UNDOABLETILE_H
+#include <QTemporaryFile>
+
 #include "tile.h"
+#include "undoredo.h"
+
+class eTask;
 
 struct CORE_EXPORT UndoableTile : public Tile {
     UndoableTile(const size_t& size) : Tile(size) {}
@@ -26,22 +32,60 @@ struct CORE_EXPORT UndoableTile : public Tile {
 
 class CORE_EXPORT UndoTile {
 public:
+    UndoTile() {}
     UndoTile(const int tx, const int ty,
              const stdsptr<UndoableTile>& tile);
 
     int tileX() const { return mX; }
     int tileY() const { return mY; }
 
+    //! @brief Replaces the copy of the old value with the RLE encoded
+    //! old and new values of the changed pixels.
     void saveForRedoAndReset();
 
-    const stdsptr<Tile>& oldValue() const { return mOldValue; }
-    const stdsptr<Tile>& newValue() const { return mNewValue; }
+    //! @brief Writes the old values to the tile for undo,
+    //! or the new values for redo.
+    void apply(Tile& tile, const bool undo) const;
+
+    int byteCount() const { return mDelta.size(); }
+
+    void write(eWriteStream& dst) const;
+    void read(eReadStream& src);
 private:
-    int mX;
-    int mY;
+    int mX = 0;
+    int mY = 0;
     stdsptr<UndoableTile> mTile;
     stdsptr<Tile> mOldValue;
-    stdsptr<Tile> mNewValue;
+    bool mOldData = false;
+    bool mNewData = false;
+    uint mOldChecksum = 0;
+    uint mNewChecksum = 0;
+    QByteArray mDelta;
+};
+
+//! @brief Tile deltas of a single paint operation,
+//! kept in a temporary file once the undo stack is over its budget.
+class CORE_EXPORT UndoTilesData : public UndoRedoData {
+    e_OBJECT
+protected:
+    UndoTilesData(const QList<UndoTile>& tiles);
+public:
+    ~UndoTilesData();
+
+    int bytesInMemory() const override;
+    int moveToTmpFile() override;
+
+    //! @brief Reads the deltas back from the temporary file if needed,
+    //! synchronously, as undo cannot wait for a task.
+    const QList<UndoTile>& tiles();
+
+    //! @brief Releases the tiles once written, returns the freed bytes
+    int setSavedToTmpFile(const qsptr<QTemporaryFile>& file);
+private:
+    bool mInMemory = true;
+    QList<UndoTile> mTiles;
+    qsptr<QTemporaryFile> mTmpFile;
+    stdsptr<eTask> mSaveTask;
 };
 
 #endif // UNDOABLETILE_H
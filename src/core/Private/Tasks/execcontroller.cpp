@@ -23,8 +23,8 @@ ExecController::ExecController(TaskExecutor* const executor, QObject* const pare
     QObject(parent),
     mExecutor(executor),
     mThread(new QThread(this)) {
-    connect(mExecutor, &TaskExecutor::finishedTask,
-            this, &ExecController::finishedTask,
+    connect(mExecutor, &TaskExecutor::finishedTasks,
+            this, &ExecController::finishedTasksSignal,
             Qt::QueuedConnection);
 }
 
@@ -45,10 +45,6 @@ void ExecController::start() {
                               Qt::QueuedConnection);
 }
 
-void ExecController::finishedTask(const stdsptr<eTask>& task) {
-    emit finishedTaskSignal(task, this);
-}
-
 CpuExecController::CpuExecController(QObject* const parent) :
     ExecController(new CpuTaskExecutor, parent) {
     start();
@@ -29,14 +29,12 @@ public:
     void stopAndWait();
 signals:
     void processTaskSignal(const stdsptr<eTask>&);
-    void finishedTaskSignal(const stdsptr<eTask>&, ExecController*);
+    void finishedTasksSignal();
 protected:
     void start();
 
     TaskExecutor * const mExecutor;
     QThread * const mThread;
-private:
-    void finishedTask(const stdsptr<eTask>& task);
 };
 
 class CORE_EXPORT CpuExecController : public ExecController {
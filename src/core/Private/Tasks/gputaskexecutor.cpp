@@ -22,14 +22,14 @@ QAtomicList<stdsptr<eTask>> GpuTaskExecutor::sTasks;
 QAtomicInt GpuTaskExecutor::sUseCount = 0;
 
 GpuTaskExecutor::GpuTaskExecutor() :
-    TaskExecutor(sUseCount, sTasks) {}
+    TaskExecutor(Hardware::gpu, sUseCount, sTasks) {}
 
 void GpuTaskExecutor::sAddTask(const stdsptr<eTask>& ready) {
-    sTasks.appendAndNotifyAll(ready);
+    sTasks.insertSortedAndNotifyAll({ready}, sMoreUrgent);
 }
 
 void GpuTaskExecutor::sAddTasks(const QList<stdsptr<eTask>>& ready) {
-    sTasks.appendAndNotifyAll(ready);
+    sTasks.insertSortedAndNotifyAll(ready, sMoreUrgent);
 }
 
 int GpuTaskExecutor::sUsageCount() {
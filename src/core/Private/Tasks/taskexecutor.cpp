@@ -17,6 +17,37 @@
 #include "taskexecutor.h"
 
 QAtomicInt TaskExecutor::sTaskFinishSignals = 0;
+std::mutex TaskExecutor::sFinishedMutex;
+QList<TaskExecutor::FinishedTask> TaskExecutor::sFinished;
+
+QList<TaskExecutor::FinishedTask> TaskExecutor::sTakeFinishedTasks() {
+    std::lock_guard<std::mutex> lock(sFinishedMutex);
+    QList<FinishedTask> result;
+    std::swap(result, sFinished);
+    return result;
+}
+
+bool TaskExecutor::sMoreUrgent(const stdsptr<eTask>& a,
+                               const stdsptr<eTask>& b) {
+    return a->moreUrgentThan(*b);
+}
+
+void TaskExecutor::finishedTask(const stdsptr<eTask>& task) {
+    // dependent tasks do not have to wait for the main thread
+    if(!task->unhandledException() && !task->waitingToCancel() &&
+       task->releasesDependentsOnWorker()) {
+        task->releaseDependent();
+    }
+    sTaskFinishSignals++;
+    bool notify;
+    {
+        std::lock_guard<std::mutex> lock(sFinishedMutex);
+        notify = sFinished.isEmpty();
+        sFinished.append({task, mHardware});
+    }
+    // the main thread collects the whole batch on the first notification
+    if(notify) emit finishedTasks();
+}
 
 void TaskExecutor::processTask(eTask& task) {
     task.process();
@@ -26,11 +57,11 @@ QAtomicList<stdsptr<eTask>> CpuTaskExecutor::sTasks;
 QAtomicInt CpuTaskExecutor::sUseCount = 0;
 
 void CpuTaskExecutor::sAddTask(const stdsptr<eTask>& ready) {
-    sTasks.appendAndNotifyAll(ready);
+    sTasks.insertSortedAndNotifyAll({ready}, sMoreUrgent);
 }
 
 void CpuTaskExecutor::sAddTasks(const QList<stdsptr<eTask>>& ready) {
-    sTasks.appendAndNotifyAll(ready);
+    sTasks.insertSortedAndNotifyAll(ready, sMoreUrgent);
 }
 
 int CpuTaskExecutor::sUsageCount() {
@@ -63,10 +94,7 @@ void TaskExecutor::processLoop() {
 
         const bool nextStep = !task->waitingToCancel() &&
                               task->nextStep();
-        if(!nextStep) {
-            sTaskFinishSignals++;
-            emit finishedTask(task);
-        }
+        if(!nextStep) finishedTask(task);
         mUseCount--;
     }
 }
@@ -75,11 +103,11 @@ QAtomicList<stdsptr<eTask>> HddTaskExecutor::sTasks;
 QAtomicInt HddTaskExecutor::sUseCount = 0;
 
 void HddTaskExecutor::sAddTask(const stdsptr<eTask>& ready) {
-    sTasks.appendAndNotifyAll(ready);
+    sTasks.insertSortedAndNotifyAll({ready}, sMoreUrgent);
 }
 
 void HddTaskExecutor::sAddTasks(const QList<stdsptr<eTask>>& ready) {
-    sTasks.appendAndNotifyAll(ready);
+    sTasks.insertSortedAndNotifyAll(ready, sMoreUrgent);
 }
 
 int HddTaskExecutor::sUsageCount() {
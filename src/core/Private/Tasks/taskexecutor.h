@@ -25,22 +25,42 @@
 class CORE_EXPORT TaskExecutor : public QObject {
     Q_OBJECT
 public:
-    TaskExecutor(QAtomicInt& count,
+    struct FinishedTask {
+        stdsptr<eTask> fTask;
+        Hardware fHardware;
+    };
+
+    TaskExecutor(const Hardware hw,
+                 QAtomicInt& count,
                  QAtomicList<stdsptr<eTask>>& tasks) :
-        mUseCount(count), mTasks(tasks) {}
+        mHardware(hw), mUseCount(count), mTasks(tasks) {}
 
     static QAtomicInt sTaskFinishSignals;
 
+    //! @brief Takes tasks finished on all executors since the last call
+    static QList<FinishedTask> sTakeFinishedTasks();
+
+    //! @brief Orders ready tasks so that the most urgent run first
+    static bool sMoreUrgent(const stdsptr<eTask>& a,
+                            const stdsptr<eTask>& b);
+
     virtual void start();
     void stop();
 signals:
-    void finishedTask(const stdsptr<eTask>&);
+    //! @brief Emitted once for a batch of finished tasks,
+    //! use sTakeFinishedTasks to collect them
+    void finishedTasks();
 protected:
     void processLoop();
 private:
     virtual void processTask(eTask& task);
+    void finishedTask(const stdsptr<eTask>& task);
+
+    static std::mutex sFinishedMutex;
+    static QList<FinishedTask> sFinished;
 
     std::atomic<bool> mStop;
+    const Hardware mHardware;
 
     QAtomicInt& mUseCount;
     QAtomicList<stdsptr<eTask>>& mTasks;
@@ -48,7 +68,7 @@ private:
 
 class CORE_EXPORT CpuTaskExecutor : public TaskExecutor {
 public:
-    CpuTaskExecutor() : TaskExecutor(sUseCount, sTasks) {}
+    CpuTaskExecutor() : TaskExecutor(Hardware::cpu, sUseCount, sTasks) {}
 
     static void sAddTask(const stdsptr<eTask>& ready);
     static void sAddTasks(const QList<stdsptr<eTask>>& ready);
@@ -61,7 +81,7 @@ private:
 
 class CORE_EXPORT HddTaskExecutor : public TaskExecutor {
 public:
-    HddTaskExecutor() : TaskExecutor(sUseCount, sTasks) {}
+    HddTaskExecutor() : TaskExecutor(Hardware::hdd, sUseCount, sTasks) {}
 
     static void sAddTask(const stdsptr<eTask>& ready);
     static void sAddTasks(const QList<stdsptr<eTask>>& ready);
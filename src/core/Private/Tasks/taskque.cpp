@@ -107,40 +107,55 @@ void TaskQue::addTask(const stdsptr<eTask> &task) {
     }
 }
 
-stdsptr<eTask> TaskQue::takeQuedForCpuProcessing() {
-    for(int i = 0; i < mCpuOnly.count(); i++) {
-        const auto& task = mCpuOnly.at(i);
-        if(task->readyToBeProcessed())
-            return mCpuOnly.takeAt(i);
+static void sDemote(const QList<stdsptr<eTask>>& list,
+                    const eTaskPriority from, const eTaskPriority to) {
+    for(const auto& task : list) {
+        if(task->priority() == from) task->setPriority(to);
     }
-    for(int i = 0; i < mCpuPreffered.count(); i++) {
-        const auto& task = mCpuPreffered.at(i);
-        if(task->readyToBeProcessed())
-            return mCpuPreffered.takeAt(i);
-    }
-    for(int i = 0; i < mGpuPreffered.count(); i++) {
-        const auto& task = mGpuPreffered.at(i);
-        if(task->readyToBeProcessed())
-            return mGpuPreffered.takeAt(i);
-    }
-    return nullptr;
 }
 
-stdsptr<eTask> TaskQue::takeQuedForGpuProcessing() {
-    for(int i = 0; i < mGpuOnly.count(); i++) {
-        const auto& task = mGpuOnly.at(i);
-        if(task->readyToBeProcessed())
-            return mGpuOnly.takeAt(i);
-    }
-    for(int i = 0; i < mGpuPreffered.count(); i++) {
-        const auto& task = mGpuPreffered.at(i);
-        if(task->readyToBeProcessed())
-            return mGpuPreffered.takeAt(i);
+void TaskQue::demoteTasks(const eTaskPriority from, const eTaskPriority to) {
+    sDemote(mCpuOnly, from, to);
+    sDemote(mCpuPreffered, from, to);
+    sDemote(mGpuPreffered, from, to);
+    sDemote(mGpuOnly, from, to);
+}
+
+//! @brief Earlier lists and earlier tasks win on equal urgency
+static void sBestReady(const QList<stdsptr<eTask>>& list, eTask*& best) {
+    for(const auto& task : list) {
+        if(!task->readyToBeProcessed()) continue;
+        if(!best || task->moreUrgentThan(*best)) best = task.get();
     }
-    for(int i = 0; i < mCpuPreffered.count(); i++) {
-        const auto& task = mCpuPreffered.at(i);
-        if(task->readyToBeProcessed())
-            return mCpuPreffered.takeAt(i);
+}
+
+eTask* TaskQue::bestQuedForCpuProcessing() const {
+    eTask* best = nullptr;
+    sBestReady(mCpuOnly, best);
+    sBestReady(mCpuPreffered, best);
+    sBestReady(mGpuPreffered, best);
+    return best;
+}
+
+eTask* TaskQue::bestQuedForGpuProcessing() const {
+    eTask* best = nullptr;
+    sBestReady(mGpuOnly, best);
+    sBestReady(mGpuPreffered, best);
+    sBestReady(mCpuPreffered, best);
+    return best;
+}
+
+static stdsptr<eTask> sTakeTask(QList<stdsptr<eTask>>& list,
+                                eTask* const task) {
+    for(int i = 0; i < list.count(); i++) {
+        if(list.at(i).get() == task) return list.takeAt(i);
     }
     return nullptr;
 }
+
+stdsptr<eTask> TaskQue::takeTask(eTask* const task) {
+    if(const auto result = sTakeTask(mCpuOnly, task)) return result;
+    if(const auto result = sTakeTask(mCpuPreffered, task)) return result;
+    if(const auto result = sTakeTask(mGpuPreffered, task)) return result;
+    return sTakeTask(mGpuOnly, task);
+}
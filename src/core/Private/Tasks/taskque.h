@@ -30,9 +30,13 @@ protected:
     int countQued() const;
     bool allDone() const;
     void addTask(const stdsptr<eTask>& task);
+    void demoteTasks(const eTaskPriority from, const eTaskPriority to);
 
-    stdsptr<eTask> takeQuedForCpuProcessing();
-    stdsptr<eTask> takeQuedForGpuProcessing();
+    //! @brief Most urgent task ready for the cpu, nullptr if none
+    eTask* bestQuedForCpuProcessing() const;
+    //! @brief Most urgent task ready for the gpu, nullptr if none
+    eTask* bestQuedForGpuProcessing() const;
+    stdsptr<eTask> takeTask(eTask* const task);
 private:
     QList<stdsptr<eTask>> mGpuOnly;
     QList<stdsptr<eTask>> mGpuPreffered;
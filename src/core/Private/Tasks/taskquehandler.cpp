@@ -26,32 +26,48 @@ void TaskQueHandler::clear() {
     mTaskCount = 0;
 }
 
+void TaskQueHandler::demoteTasks(const eTaskPriority from,
+                                 const eTaskPriority to) {
+    for(const auto& que : mQues) que->demoteTasks(from, to);
+}
+
 stdsptr<eTask> TaskQueHandler::takeQuedForGpuProcessing() {
-    int queId = 0;
-    for(const auto& que : mQues) {
-        const auto task = que->takeQuedForGpuProcessing();
-        if(task) {
-            if(que->allDone()) queDone(que.get(), queId);
-            mTaskCount--;
-            return task;
-        }
-        queId++;
-    }
-    return nullptr;
+    return takeMostUrgent([](const TaskQue& que) {
+        return que.bestQuedForGpuProcessing();
+    });
 }
 
 stdsptr<eTask> TaskQueHandler::takeQuedForCpuProcessing() {
-    int queId = 0;
-    for(const auto& que : mQues) {
-        const auto task = que->takeQuedForCpuProcessing();
-        if(task) {
-            if(que->allDone()) queDone(que.get(), queId);
-            mTaskCount--;
-            return task;
+    return takeMostUrgent([](const TaskQue& que) {
+        return que.bestQuedForCpuProcessing();
+    });
+}
+
+stdsptr<eTask> TaskQueHandler::takeMostUrgent(
+        const std::function<eTask*(const TaskQue&)>& bestInQue) {
+    eTask* best = nullptr;
+    int bestQueId = -1;
+    const int nQues = mQues.count();
+    for(int queId = 0; queId < nQues; queId++) {
+        const auto task = bestInQue(*mQues.at(queId));
+        if(!task) continue;
+        bool better = !best || task->moreUrgentThan(*best);
+        if(!better && task->priority() == eTaskPriority::interactive) {
+            // newer ques hold the frame under the playhead,
+            // older interactive work is for frames already left behind
+            better = !best->moreUrgentThan(*task);
+        }
+        if(better) {
+            best = task;
+            bestQueId = queId;
         }
-        queId++;
     }
-    return nullptr;
+    if(!best) return nullptr;
+    const auto que = mQues.at(bestQueId);
+    const auto task = que->takeTask(best);
+    if(que->allDone()) queDone(que.get(), bestQueId);
+    mTaskCount--;
+    return task;
 }
 
 void TaskQueHandler::beginQue() {
@@ -18,12 +18,15 @@
 #define TASKQUEHANDLER_H
 #include "taskque.h"
 
+#include <functional>
+
 class CORE_EXPORT TaskQueHandler {
 public:
     int countQues() const;
     bool isEmpty() const;
 
     void clear();
+    void demoteTasks(const eTaskPriority from, const eTaskPriority to);
 
     stdsptr<eTask> takeQuedForGpuProcessing();
     stdsptr<eTask> takeQuedForCpuProcessing();
@@ -36,6 +39,8 @@ public:
 
     int taskCount() const { return mTaskCount; }
 private:
+    stdsptr<eTask> takeMostUrgent(
+            const std::function<eTask*(const TaskQue&)>& bestInQue);
     void queDone(const TaskQue * const que, const int queId);
 
     int mTaskCount = 0;
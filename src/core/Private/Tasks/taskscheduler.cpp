@@ -24,6 +24,8 @@
 #include "Private/document.h"
 #include "Boxes/boxrenderdata.h"
 
+#include <algorithm>
+
 TaskScheduler *TaskScheduler::sInstance = nullptr;
 
 TaskScheduler::TaskScheduler() {
@@ -33,19 +35,19 @@ TaskScheduler::TaskScheduler() {
     const int numberThreads = qMax(1, QThread::idealThreadCount());
     for(int i = 0; i < numberThreads; i++) {
         const auto taskExecutor = std::make_shared<CpuExecController>(this);
-        connect(taskExecutor.get(), &ExecController::finishedTaskSignal,
-                this, &TaskScheduler::afterCpuGpuTaskFinished);
+        connect(taskExecutor.get(), &ExecController::finishedTasksSignal,
+                this, &TaskScheduler::processFinishedTasks);
 
         mCpuExecs << taskExecutor;
     }
 
     mHddExec = std::make_shared<HddExecController>(this);
-    connect(mHddExec.get(), &ExecController::finishedTaskSignal,
-            this, &TaskScheduler::afterHddTaskFinished);
+    connect(mHddExec.get(), &ExecController::finishedTasksSignal,
+            this, &TaskScheduler::processFinishedTasks);
 
     mGpuExec = std::make_shared<GpuExecController>(this);
-    connect(mGpuExec.get(), &ExecController::finishedTaskSignal,
-            this, &TaskScheduler::afterCpuGpuTaskFinished);
+    connect(mGpuExec.get(), &ExecController::finishedTasksSignal,
+            this, &TaskScheduler::processFinishedTasks);
 }
 
 TaskScheduler::~TaskScheduler() {
@@ -90,11 +92,20 @@ void TaskScheduler::initializeGpu() {
 }
 
 void TaskScheduler::queHddTask(const stdsptr<eTask>& task) {
+    if(!task->hasPriority()) task->setPriority(mQuePriority);
+    if(task->deadline() < 0) task->setDeadline(mQueDeadline);
+    task->passUrgencyToDependencies();
+    if(parkTask(task, Hardware::hdd)) return;
     mQuedHddTasks << task;
     processNextQuedHddTask();
 }
 
 void TaskScheduler::queCpuTask(const stdsptr<eTask>& task) {
+    if(!task->hasPriority()) task->setPriority(mQuePriority);
+    if(task->deadline() < 0) task->setDeadline(mQueDeadline);
+    task->passUrgencyToDependencies();
+    const bool gpuOnly = task->hardwareSupport() == HardwareSupport::gpuOnly;
+    if(parkTask(task, gpuOnly ? Hardware::gpu : Hardware::cpu)) return;
     mQuedCGTasks.addTask(task);
     if(task->readyToBeProcessed()) {
         if(task->hardwareSupport() == HardwareSupport::cpuOnly ||
@@ -104,9 +115,67 @@ void TaskScheduler::queCpuTask(const stdsptr<eTask>& task) {
     }
 }
 
+bool TaskScheduler::parkTask(const stdsptr<eTask>& task, const Hardware hw) {
+    if(!task->startableOnWorker()) return false;
+    std::lock_guard<std::mutex> lock(mParkedMutex);
+    // checked under the lock, dependencies finish on worker threads
+    if(task->readyToBeProcessed()) return false;
+    mParkedTasks.append({task, hw});
+    return true;
+}
+
+void TaskScheduler::dependenciesFinished(eTask* const task) {
+    ParkedTask parked;
+    {
+        std::lock_guard<std::mutex> lock(mParkedMutex);
+        const auto it = std::find_if(mParkedTasks.begin(), mParkedTasks.end(),
+                                     [task](const ParkedTask& parked) {
+            return parked.fTask.get() == task;
+        });
+        if(it == mParkedTasks.end()) return;
+        // started once the critical memory state is over
+        if(mCriticalMemoryState) return;
+        parked = *it;
+        mParkedTasks.erase(it);
+    }
+    startParkedTask(parked);
+}
+
+void TaskScheduler::startParkedTask(const ParkedTask& parked) {
+    const auto& task = parked.fTask;
+    if(!task->claimForProcessing()) return;
+    task->aboutToProcess(parked.fHardware);
+    switch(parked.fHardware) {
+    case Hardware::cpu: CpuTaskExecutor::sAddTask(task); break;
+    case Hardware::gpu: GpuTaskExecutor::sAddTask(task); break;
+    case Hardware::hdd: HddTaskExecutor::sAddTask(task); break;
+    }
+}
+
+void TaskScheduler::removeCanceledParkedTasks() {
+    std::lock_guard<std::mutex> lock(mParkedMutex);
+    for(int i = mParkedTasks.count() - 1; i >= 0; i--) {
+        const auto& task = mParkedTasks.at(i).fTask;
+        if(task->getState() == eTaskState::canceled)
+            mParkedTasks.removeAt(i);
+    }
+}
+
+bool TaskScheduler::hasParkedTasks() const {
+    std::lock_guard<std::mutex> lock(mParkedMutex);
+    return !mParkedTasks.isEmpty();
+}
+
 void TaskScheduler::clearTasks() {
     mQuedCGTasks.clear();
 
+    QList<ParkedTask> parked;
+    {
+        std::lock_guard<std::mutex> lock(mParkedMutex);
+        std::swap(parked, mParkedTasks);
+    }
+    for(const auto& task : parked) task.fTask->cancel();
+
     for(const auto& hddTask : mQuedHddTasks)
         hddTask->cancel();
     mQuedHddTasks.clear();
@@ -114,6 +183,14 @@ void TaskScheduler::clearTasks() {
     callAllTasksFinishedFunc();
 }
 
+void TaskScheduler::demoteQuedTasks(const eTaskPriority from,
+                                    const eTaskPriority to) {
+    mQuedCGTasks.demoteTasks(from, to);
+    for(const auto& hddTask : mQuedHddTasks) {
+        if(hddTask->priority() == from) hddTask->setPriority(to);
+    }
+}
+
 bool TaskScheduler::overflowed() const {
     const int nQues = mQuedCGTasks.countQues();
     const int maxQues = mAlwaysQue ? mCpuExecs.count() : 1;
@@ -143,25 +220,44 @@ void TaskScheduler::queTasks() {
     processNextQuedHddTask();
 }
 
+eTaskPriority TaskScheduler::sScenePriority(const Canvas& scene) {
+    if(scene.isRenderingOutput()) return eTaskPriority::output;
+    if(scene.isRenderingPreview()) return eTaskPriority::lookahead;
+    return eTaskPriority::interactive;
+}
+
 void TaskScheduler::queScheduledCpuTasks() {
     if(!mAlwaysQue && !shouldQueMoreCpuTasks()) return;
     mCpuQueing = true;
     mQuedCGTasks.beginQue();
     for(const auto& it : Document::sInstance->fVisibleScenes) {
         const auto scene = it.first;
+        mQuePriority = sScenePriority(*scene);
+        mQueDeadline = scene->frameDeadline();
         scene->queTasks();
     }
+    mQuePriority = eTaskPriority::interactive;
+    mQueDeadline = -1;
     mQuedCGTasks.endQue();
     mCpuQueing = false;
 
     if(!mQuedCGTasks.isEmpty()) processNextTasks();
 }
 
-void TaskScheduler::afterHddTaskFinished(const stdsptr<eTask>& finishedTask) {
-    TaskExecutor::sTaskFinishSignals--;
-    finishedTask->finishedProcessing();
+void TaskScheduler::processFinishedTasks() {
+    const auto finished = TaskExecutor::sTakeFinishedTasks();
+    if(finished.isEmpty()) return;
+    bool hdd = false;
+    bool cpuGpu = false;
+    for(const auto& task : finished) {
+        TaskExecutor::sTaskFinishSignals--;
+        task.fTask->finishedProcessing();
+        if(task.fHardware == Hardware::hdd) hdd = true;
+        else cpuGpu = true;
+    }
     processNextTasks();
-    if(!hddTaskBeingProcessed()) queTasks();
+    if((cpuGpu && !cpuTasksBeingProcessed()) ||
+       (hdd && !hddTaskBeingProcessed())) queTasks();
     callAllTasksFinishedFunc();
 }
 
@@ -184,6 +280,7 @@ void TaskScheduler::processNextQuedHddTask() {
 }
 
 void TaskScheduler::processNextTasks() {
+    removeCanceledParkedTasks();
     if(mCriticalMemoryState) return;
     processNextQuedHddTask();
     processNextQuedGpuTask();
@@ -216,14 +313,6 @@ bool TaskScheduler::processNextQuedGpuTask() {
     return !tasks.isEmpty();
 }
 
-void TaskScheduler::afterCpuGpuTaskFinished(const stdsptr<eTask>& task) {
-    TaskExecutor::sTaskFinishSignals--;
-    task->finishedProcessing();
-    processNextTasks();
-    if(!cpuTasksBeingProcessed()) queTasks();
-    callAllTasksFinishedFunc();
-}
-
 void TaskScheduler::setTaskUnderflowFunc(const Func& func) {
     mTaskUnderflowFunc = func;
 }
@@ -244,7 +333,8 @@ bool TaskScheduler::allQuedGpuTasksFinished() const {
 }
 
 bool TaskScheduler::allQuedCpuTasksFinished() const {
-    return mQuedCGTasks.isEmpty() && !cpuTasksBeingProcessed();
+    return mQuedCGTasks.isEmpty() && !cpuTasksBeingProcessed() &&
+           !hasParkedTasks();
 }
 
 bool TaskScheduler::allQuedHddTasksFinished() const {
@@ -298,6 +388,17 @@ void TaskScheduler::enterCriticalMemoryState() {
 void TaskScheduler::finishCriticalMemoryState() {
     if(!mCriticalMemoryState) return;
     mCriticalMemoryState = false;
+    QList<ParkedTask> ready;
+    {
+        std::lock_guard<std::mutex> lock(mParkedMutex);
+        for(int i = mParkedTasks.count() - 1; i >= 0; i--) {
+            const auto& parked = mParkedTasks.at(i);
+            if(!parked.fTask->readyToBeProcessed()) continue;
+            ready.prepend(parked);
+            mParkedTasks.removeAt(i);
+        }
+    }
+    for(const auto& parked : ready) startParkedTask(parked);
     queTasks();
     processNextTasks();
 }
@@ -54,9 +54,15 @@ public:
     void queCpuTask(const stdsptr<eTask> &task);
 
     void clearTasks();
+    //! @brief Lowers the priority of qued tasks, used for work that
+    //! became stale but is still awaited
+    void demoteQuedTasks(const eTaskPriority from, const eTaskPriority to);
 
-    void afterHddTaskFinished(const stdsptr<eTask>& finishedTask);
-    void afterCpuGpuTaskFinished(const stdsptr<eTask>& task);
+    //! @brief Finishes a batch of tasks processed by the executors
+    void processFinishedTasks();
+    //! @brief Starts the task if it waits for dependencies outside of
+    //! the task ques, can be called from any thread.
+    void dependenciesFinished(eTask* const task);
 
     void setTaskUnderflowFunc(const Func& func);
     void setAllTasksFinishedFunc(const Func& func);
@@ -90,6 +96,20 @@ signals:
     void cpuUsageChanged(int);
     void complexTaskAdded(ComplexTask*);
 private:
+    struct ParkedTask {
+        stdsptr<eTask> fTask;
+        Hardware fHardware;
+    };
+
+    //! @brief Keeps the task outside of the ques until its dependencies
+    //! finish, returns false if it is already ready to be processed.
+    bool parkTask(const stdsptr<eTask>& task, const Hardware hw);
+    void startParkedTask(const ParkedTask& parked);
+    void removeCanceledParkedTasks();
+    bool hasParkedTasks() const;
+
+    //! @brief Priority of tasks qued for the scene
+    static eTaskPriority sScenePriority(const Canvas& scene);
     void queScheduledCpuTasks();
 
     void processNextQuedHddTask();
@@ -105,16 +125,23 @@ private:
 
     static TaskScheduler* sInstance;
 
-    bool mCriticalMemoryState = false;
+    std::atomic<bool> mCriticalMemoryState{false};
 
     bool mAlwaysQue = false;
     bool mCpuQueing = false;
+    //! @brief Assigned to tasks qued without an explicit priority
+    eTaskPriority mQuePriority = eTaskPriority::interactive;
+    //! @brief Assigned to tasks qued without an explicit deadline
+    qint64 mQueDeadline = -1;
 
     QList<qsptr<ComplexTask>> mComplexTasks;
 
     TaskQueHandler mQuedCGTasks;
     QList<stdsptr<eTask>> mQuedHddTasks;
 
+    mutable std::mutex mParkedMutex;
+    QList<ParkedTask> mParkedTasks;
+
     QList<stdsptr<CpuExecController>> mCpuExecs;
     stdsptr<GpuExecController> mGpuExec;
     stdsptr<HddExecController> mHddExec;
@@ -0,0 +1,61 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "workqueue.h"
+
+#include "taskexecutor.h"
+
+struct JobsPass {
+    JobsPass(const int count) : fQueue(count) {}
+
+    WorkQueue fQueue;
+    std::mutex fMutex;
+    std::exception_ptr fException;
+};
+
+void gRunJobs(const int count, const int nThreads,
+              const eTaskPriority priority, const qint64 deadline,
+              const std::function<void(int)>& job) {
+    if(count <= 0) return;
+    const auto pass = std::make_shared<JobsPass>(count);
+    // helpers that start after all jobs were taken do not call job
+    const auto runTaken = [pass, job]() {
+        for(int id; (id = pass->fQueue.take()) != -1;) {
+            try {
+                job(id);
+            } catch(...) {
+                std::lock_guard<std::mutex> lock(pass->fMutex);
+                if(!pass->fException)
+                    pass->fException = std::current_exception();
+            }
+            pass->fQueue.finished();
+        }
+    };
+    QList<stdsptr<eTask>> helpers;
+    const int nHelpers = qMin(count, nThreads) - 1;
+    for(int i = 0; i < nHelpers; i++) {
+        const auto helper = enve::make_shared<eCustomCpuTask>(
+                    nullptr, runTaken, nullptr, nullptr);
+        helper->setPriority(priority);
+        helper->setDeadline(deadline);
+        helpers << helper;
+    }
+    if(!helpers.isEmpty()) CpuTaskExecutor::sAddTasks(helpers);
+    // never waits for jobs that were not started by someone
+    runTaken();
+    pass->fQueue.waitAllFinished();
+    if(pass->fException) std::rethrow_exception(pass->fException);
+}
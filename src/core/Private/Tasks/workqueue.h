@@ -0,0 +1,66 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef WORKQUEUE_H
+#define WORKQUEUE_H
+
+#include <atomic>
+#include <mutex>
+#include <functional>
+#include <condition_variable>
+
+#include "Tasks/etaskbase.h"
+
+//! @brief Hands out job ids to the threads sharing a piece of work.
+//! The owner takes jobs too before waiting, so helper tasks started late
+//! find nothing left to do and never have to be waited for.
+class WorkQueue {
+public:
+    WorkQueue(const int count) : mCount(count) {}
+
+    //! @brief Returns the next job to process or -1 if all were taken
+    int take() {
+        const int job = mNext++;
+        return job < mCount ? job : -1;
+    }
+
+    void finished() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if(++mFinished == mCount) mAllFinished.notify_all();
+    }
+
+    void waitAllFinished() {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mAllFinished.wait(lock, [this]() { return mFinished == mCount; });
+    }
+private:
+    const int mCount;
+    std::atomic<int> mNext{0};
+    int mFinished = 0;
+    std::mutex mMutex;
+    std::condition_variable mAllFinished;
+};
+
+//! @brief Runs job for every id below count on at most nThreads threads,
+//! the calling one included. Helper cpu tasks get the priority and
+//! deadline of the work they help with. Returns once every job finished
+//! and rethrows the first exception thrown by a job.
+CORE_EXPORT
+extern void gRunJobs(const int count, const int nThreads,
+                     const eTaskPriority priority, const qint64 deadline,
+                     const std::function<void(int)>& job);
+
+#endif // WORKQUEUE_H
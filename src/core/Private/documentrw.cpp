@@ -44,8 +44,11 @@ void Document::writeScenes(eWriteStream& dst) const {
     const int nScenes = fScenes.count();
     dst.write(&nScenes, sizeof(int));
     for(const auto &scene : fScenes) {
+        const int chunk = dst.beginChunk(eChunkType::scene,
+                                         scene->prp_getName());
         scene->writeBoundingBox(dst);
         dst.writeCheckpoint();
+        dst.endChunk(chunk);
     }
 }
 
@@ -82,6 +85,9 @@ void Document::readScenes(eReadStream& src) {
 
     int nScenes;
     src.read(&nScenes, sizeof(int));
+    // with a table of contents a broken scene can be skipped
+    const auto sceneChunks = src.chunkIds(eChunkType::scene);
+    const bool chunked = sceneChunks.count() == nScenes;
     for(int i = 0; i < nScenes; i++) {
         Canvas* scene;
         if(src.evFileVersion() < EvFormat::betterSWTAbsReadWrite) {
@@ -90,8 +96,20 @@ void Document::readScenes(eReadStream& src) {
             scene = fScenes.at(fScenes.count() - nScenes + i).get();
         }
         const auto block = scene->blockUndoRedo();
-        scene->readBoundingBox(src);
-        src.readCheckpoint("Error reading scene");
+        if(chunked) {
+            const int chunk = sceneChunks.at(i);
+            try {
+                src.seekChunk(chunk);
+                scene->readBoundingBox(src);
+                src.readCheckpoint("Error reading scene");
+            } catch(const std::exception& e) {
+                gPrintExceptionCritical(e);
+            }
+            src.seekChunkEnd(chunk);
+        } else {
+            scene->readBoundingBox(src);
+            src.readCheckpoint("Error reading scene");
+        }
     }
 
     SimpleTask::sProcessAll();
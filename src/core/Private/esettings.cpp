@@ -153,6 +153,9 @@ eSettings::eSettings(const int cpuThreads, const intKB ramKB,
     gSettings << std::make_shared<eIntSetting>(
                      fCpuThreadsCap,
                      "cpuThreadsCap", 0);
+    gSettings << std::make_shared<eIntSetting>(
+                     fRenderSegments,
+                     "renderSegments", 0);
     gSettings << std::make_shared<eIntSetting>(
                      reinterpret_cast<int&>(fRamMBCap),
                      "ramMBCap", 0);
@@ -170,6 +173,28 @@ eSettings::eSettings(const int cpuThreads, const intKB ramKB,
                      reinterpret_cast<int&>(fHddCacheMBCap),
                      "hddCacheMBCap", 0);
 
+    gSettings << std::make_shared<eIntSetting>(
+                     fUndoCap,
+                     "undoCap", 25);
+    gSettings << std::make_shared<eIntSetting>(
+                     reinterpret_cast<int&>(fUndoRamMBCap),
+                     "undoRamMBCap", 256);
+
+    gSettings << std::make_shared<eIntSetting>(
+                     fPreviewLeadFrames,
+                     "previewLeadFrames", 24);
+
+    gSettings << std::make_shared<eIntSetting>(
+                     fQuickSaveCap,
+                     "quickSaveCap", 5);
+    gSettings << std::make_shared<eIntSetting>(
+                     fAutoQuickSaveMin,
+                     "autoQuickSaveMin", 0);
+    gSettings << std::make_shared<eIntSetting>(
+                     reinterpret_cast<int&>(fQuickSaveTarget),
+                     "quickSaveTarget",
+                     static_cast<int>(AutosaveTarget::same_folder));
+
     gSettings << std::make_shared<eQrealSetting>(
                      fInterfaceScaling,
                      "interfaceScaling", 1.);
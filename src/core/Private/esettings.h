@@ -68,6 +68,7 @@ public:
     // performance settings
     const int fCpuThreads;
     int fCpuThreadsCap = 0; // <= 0 - use all available threads
+    int fRenderSegments = 0; // <= 1 - render output in this process
 
     const intKB fRamKB;
     intMB fRamMBCap = intMB(0); // <= 0 - cap at 80 %
@@ -82,6 +83,10 @@ public:
 
     // history
     int fUndoCap = 25; // <= 0 - no cap
+    intMB fUndoRamMBCap = intMB(256); // <= 0 - no cap, older steps go to hdd
+
+    // preview
+    int fPreviewLeadFrames = 24; // <= 0 - render whole range before playing
 
     enum class AutosaveTarget {
         dedicated_folder,
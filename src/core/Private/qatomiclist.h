@@ -4,6 +4,7 @@
 #include <QList>
 #include <mutex>
 #include <condition_variable>
+#include <algorithm>
 
 using namespace std::chrono_literals;
 
@@ -61,6 +62,19 @@ public:
         mCv.notify_all();
     }
 
+    //! @brief Inserts after all elements not greater than the inserted one
+    template <typename LessThan>
+    void insertSortedAndNotifyAll(const QList<T>& list,
+                                  const LessThan& lessThan) {
+        std::lock_guard<std::mutex> lk(mMutex);
+        for(const auto& t : list) {
+            const auto it = std::upper_bound(QList<T>::begin(),
+                                             QList<T>::end(), t, lessThan);
+            QList<T>::insert(it, t);
+        }
+        mCv.notify_all();
+    }
+
     void appendAndNotifyOne(const QList<T>& list) {
         std::lock_guard<std::mutex> lk(mMutex);
         QList<T>::append(list);
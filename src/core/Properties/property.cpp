@@ -324,7 +324,8 @@ void Property::prp_addUndoRedo(const UndoRedo& undoRedo) {
     auto redo = undoRedo.fRedo;
     undo = [thisQPtr, undo]() { if(thisQPtr) undo(); };
     redo = [thisQPtr, redo]() { if(thisQPtr) redo(); };
-    parentScene->addUndoRedo(prp_getName() + " Change", undo, redo);
+    parentScene->addUndoRedo(prp_getName() + " Change", undo, redo,
+                             undoRedo.fData);
 }
 
 void Property::prp_pushUndoRedoName(const QString& name) {
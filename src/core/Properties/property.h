@@ -32,6 +32,7 @@ class ComplexAnimator;
 class Key;
 class QPainter;
 class UndoRedoStack;
+class UndoRedoData;
 class BasicTransformAnimator;
 class BoxTransformAnimator;
 
@@ -58,6 +59,8 @@ enum class UpdateReason {
 struct CORE_EXPORT UndoRedo {
     std::function<void()> fUndo;
     std::function<void()> fRedo;
+    //! @brief Optional, lets the undo stack account for the memory used
+    stdsptr<UndoRedoData> fData;
 };
 
 class Property;
@@ -76,7 +76,8 @@ void OilSimulator::setImage(const SkBitmap& imagePixels, bool clearCanvas) {
 		// Initialize the canvas where the image will be painted
         if(mUseGpu) mCpuDst.allocPixels(imgInfo);
         else mCanvas = std::make_shared<SkCanvas>(mCpuDst);
-        mCanvas->clear(BACKGROUND_COLOR);
+        // keep what is already painted on the destination if requested
+        if(clearCanvas) mCanvas->clear(BACKGROUND_COLOR);
         mCanvasWidth = imgWidth;
         mCanvasHeight = imgHeight;
 
@@ -167,21 +168,31 @@ void OilSimulator::updatePixelArrays() {
     const int bgGreen = SkColorGetG(BACKGROUND_COLOR);
     const int bgBlue = SkColorGetB(BACKGROUND_COLOR);
 
-    for (unsigned int pixel = 0, nPixels = mImg.width() * mImg.height(); pixel < nPixels; ++pixel) {
-		unsigned int imgPix = pixel * imgNumChannels;
-		unsigned int canvasPix = pixel * canvasNumChannels;
+    // traces start only inside of the start rect
+    const int width = mImg.width();
+    SkIRect startRect = SkIRect::MakeWH(width, mImg.height());
+    if (!mStartRect.isEmpty() && !startRect.intersect(mStartRect)) {
+        return;
+    }
 
-		// Check if the pixel is well painted
-        if (paintedPixels[canvasPix] != bgRed && paintedPixels[canvasPix + 1] != bgGreen
-                && paintedPixels[canvasPix + 2] != bgBlue
-                && abs(imgPixels[imgPix] - paintedPixels[canvasPix]) < MAX_COLOR_DIFFERENCE[0]
-                && abs(imgPixels[imgPix + 1] - paintedPixels[canvasPix + 1]) < MAX_COLOR_DIFFERENCE[1]
-                && abs(imgPixels[imgPix + 2] - paintedPixels[canvasPix + 2]) < MAX_COLOR_DIFFERENCE[2]) {
-		} else {
-			badPaintedPixels[nBadPaintedPixels] = pixel;
-			++nBadPaintedPixels;
-		}
-	}
+    for (int y = startRect.top(); y < startRect.bottom(); ++y) {
+        for (int x = startRect.left(); x < startRect.right(); ++x) {
+            unsigned int pixel = y * width + x;
+            unsigned int imgPix = pixel * imgNumChannels;
+            unsigned int canvasPix = pixel * canvasNumChannels;
+
+            // Check if the pixel is well painted
+            if (paintedPixels[canvasPix] != bgRed && paintedPixels[canvasPix + 1] != bgGreen
+                    && paintedPixels[canvasPix + 2] != bgBlue
+                    && abs(imgPixels[imgPix] - paintedPixels[canvasPix]) < MAX_COLOR_DIFFERENCE[0]
+                    && abs(imgPixels[imgPix + 1] - paintedPixels[canvasPix + 1]) < MAX_COLOR_DIFFERENCE[1]
+                    && abs(imgPixels[imgPix + 2] - paintedPixels[canvasPix + 2]) < MAX_COLOR_DIFFERENCE[2]) {
+            } else {
+                badPaintedPixels[nBadPaintedPixels] = pixel;
+                ++nBadPaintedPixels;
+            }
+        }
+    }
 }
 
 void OilSimulator::updateVisitedPixels() {
@@ -220,7 +231,11 @@ void OilSimulator::getNewTrace() {
 
 	while (true) {
 		// Check if we should stop the painting simulation
-		if (averageBrushSize == SMALLER_BRUSH_SIZE
+        if (nBadPaintedPixels == 0) {
+            // Everything is painted well already
+            paintingIsFinised = true;
+            break;
+        } else if (averageBrushSize == SMALLER_BRUSH_SIZE
 				&& (invalidTrajectoriesCounter > MAX_INVALID_TRAJECTORIES_FOR_SMALLER_SIZE
 						|| invalidTracesCounter > MAX_INVALID_TRACES_FOR_SMALLER_SIZE)) {
 			// Print some debug information if necessary
@@ -555,6 +570,10 @@ void OilSimulator::paintTraceStep() {
 	++traceStep;
 }
 
+void OilSimulator::setStartRect(const SkIRect& rect) {
+    mStartRect = rect;
+}
+
 bool OilSimulator::isFinished() const {
 	return paintingIsFinised;
 }
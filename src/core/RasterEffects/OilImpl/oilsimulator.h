@@ -150,6 +150,15 @@ public:
 	 */
     void setImage(const SkBitmap& image, bool clearCanvas);
 
+	/**
+	 * @brief Limits the pixels traces can start from, the whole image is used if the rect is empty
+	 *
+	 * Traces can still extend outside of the rect.
+	 *
+	 * @param rect the rect in image coordinates
+	 */
+    void setStartRect(const SkIRect& rect);
+
 	/**
 	 * @brief Updates the simulation
 	 *
@@ -253,6 +262,11 @@ protected:
 	 */
     std::shared_ptr<SkCanvas> mCanvasBuffer;
 
+	/**
+	 * @brief The pixels traces can start from, the whole image if empty
+	 */
+    SkIRect mStartRect = SkIRect::MakeEmpty();
+
 	/**
 	 * @brief Container indicating which canvas pixels have been visited by previous traces
 	 */
@@ -3,6 +3,8 @@
 #include "Animators/qrealanimator.h"
 #include "OilImpl/oilsimulator.h"
 #include "ReadWrite/evformat.h"
+#include "Private/esettings.h"
+#include "Private/Tasks/workqueue.h"
 
 #define TIME_BEGIN const auto t1 = std::chrono::high_resolution_clock::now();
 #define TIME_END(name) const auto t2 = std::chrono::high_resolution_clock::now(); \
@@ -11,6 +13,9 @@
 
 //#define OilEffect_TIMING
 
+// smaller regions spend most of the time on the overlap
+#define OIL_MIN_REGION_SIZE 256
+
 OilEffect::OilEffect() :
     RasterEffect("oil painting", HardwareSupport::cpuPreffered,
                  true, RasterEffectType::OIL) {
@@ -84,6 +89,7 @@ public:
         mBristleThickness(bristleThickness),
         mBristleDensity(bristleDensity) {}
 
+    //! @brief Regions are distributed between threads by processCpu
     int cpuThreads(const int available, const int area) const {
         Q_UNUSED(available) Q_UNUSED(area)
         return 1;
@@ -102,19 +108,51 @@ public:
 
     void processCpu(CpuRenderTools& renderTools,
                     const CpuRenderData &data) {
-        Q_UNUSED(data);
         if(mMaxStrokes <= 0) return;
 #ifdef OilEffect_TIMING
         TIME_BEGIN
 #endif
-        OilSimulator simulator(renderTools.fDstBtmp, false, false);
-        setupSimulator(simulator);
+        const auto& src = renderTools.fSrcBtmp;
+        auto& dst = renderTools.fDstBtmp;
+        dst.eraseColor(OilSimulator::BACKGROUND_COLOR);
 
-        simulator.setImage(renderTools.fSrcBtmp, true);
+        // the image is divided into regions independent of the thread count,
+        // regions are painted in four passes, regions painted in the same
+        // pass are a region apart, so their strokes can not overlap
+        const int reach = strokeReach();
+        const int size = qMax(OIL_MIN_REGION_SIZE, 2*reach);
+        const int width = src.width();
+        const int height = src.height();
+        const int nCols = (width + size - 1)/size;
+        const int nRows = (height + size - 1)/size;
 
-        for(int i = 0; i < mMaxStrokes; i++) {
-            simulator.update(false);
-            if(simulator.isFinished()) break;
+        // strokes are shared between regions proportionally to their area
+        const qint64 area = qint64(width)*height;
+        QVector<SkIRect> regions;
+        QVector<int> strokes;
+        qint64 areaSum = 0;
+        int strokesSum = 0;
+        for(int row = 0; row < nRows; row++) {
+            for(int col = 0; col < nCols; col++) {
+                auto region = SkIRect::MakeXYWH(col*size, row*size, size, size);
+                region.intersect(SkIRect::MakeWH(width, height));
+                areaSum += qint64(region.width())*region.height();
+                const int strokesTo = int(mMaxStrokes*areaSum/area);
+                regions << region;
+                strokes << strokesTo - strokesSum;
+                strokesSum = strokesTo;
+            }
+        }
+
+        for(int pass = 0; pass < 4; pass++) {
+            QVector<int> passRegions;
+            for(int row = pass/2; row < nRows; row += 2) {
+                for(int col = pass % 2; col < nCols; col += 2) {
+                    passRegions << row*nCols + col;
+                }
+            }
+            paintRegions(src, dst, regions, strokes, passRegions, reach,
+                         data.fPriority, data.fDeadline);
         }
 #ifdef OilEffect_TIMING
         TIME_END("CPU Oil Painting")
@@ -163,6 +201,56 @@ public:
 #endif
     }
 private:
+    //! @brief Maximum distance of painted pixels from the trace start
+    int strokeReach() const {
+        const qreal traceLength = qMax(16*mResolution,
+                                       1.2*mStrokeLength*mMaxBrushSize);
+        return qCeil(traceLength + 1.1*mMaxBrushSize) + 1;
+    }
+
+    void paintRegions(const SkBitmap& src, const SkBitmap& dst,
+                      const QVector<SkIRect>& regions,
+                      const QVector<int>& strokes,
+                      const QVector<int>& passRegions,
+                      const int reach, const eTaskPriority priority,
+                      const qint64 deadline) {
+        const int nRegions = passRegions.count();
+        const int nThreads = eSettings::sCpuThreadsCapped();
+        gRunJobs(nRegions, nThreads, priority, deadline, [&](const int i) {
+            const int id = passRegions.at(i);
+            paintRegion(src, dst, regions.at(id), reach,
+                        strokes.at(id), uint(id) + 1);
+        });
+    }
+
+    void paintRegion(const SkBitmap& src, SkBitmap dst,
+                     const SkIRect& region, const int reach,
+                     const int maxStrokes, const uint seed) {
+        if(maxStrokes <= 0) return;
+        auto work = region.makeOutset(reach, reach);
+        if(!work.intersect(SkIRect::MakeWH(src.width(), src.height()))) return;
+        const auto info = src.info().makeWH(work.width(), work.height());
+        SkBitmap img;
+        img.allocPixels(info);
+        src.readPixels(img.pixmap(), work.x(), work.y());
+        SkBitmap painted;
+        painted.allocPixels(info);
+        dst.readPixels(painted.pixmap(), work.x(), work.y());
+
+        OilSimulator simulator(painted, false, false);
+        setupSimulator(simulator);
+        simulator.setStartRect(region.makeOffset(-work.x(), -work.y()));
+        // the result depends only on the region and the earlier passes
+        qsrand(seed);
+        simulator.setImage(img, false);
+
+        for(int i = 0; i < maxStrokes; i++) {
+            simulator.update(false);
+            if(simulator.isFinished()) break;
+        }
+        dst.writePixels(painted.pixmap(), work.x(), work.y());
+    }
+
     const qreal mMinBrushSize;
     const qreal mMaxBrushSize;
     const qreal mAccuracy;
@@ -0,0 +1,48 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ECHUNKINFO_H
+#define ECHUNKINFO_H
+
+#include <QString>
+
+#include "../core_global.h"
+
+enum class eChunkType : int {
+    scene, contained
+};
+
+//! @brief Table of contents entry for an independently readable
+//! part of an .ev file.
+//! Chunks are not compressed as a whole, only the blobs inside them are.
+//! Chunks are still parsed in order on the main thread, and every scene
+//! is opened. The table is used to seek to scenes and to skip broken ones.
+struct CORE_EXPORT eChunkInfo {
+    eChunkType fType;
+    QString fName;
+    //! @brief Position of the first byte of the chunk
+    qint64 fPos;
+    //! @brief Position right after the last byte of the chunk
+    qint64 fEnd;
+    //! @brief Next future table id at the beginning of the chunk
+    int fFutureId;
+    //! @brief Next future table id at the end of the chunk
+    int fEndFutureId;
+    //! @brief Id of the enclosing chunk, -1 for top level chunks
+    int fParent;
+};
+
+#endif // ECHUNKINFO_H
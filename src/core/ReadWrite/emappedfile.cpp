@@ -0,0 +1,41 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "emappedfile.h"
+
+stdsptr<eMappedFile> eMappedFile::sMap(const QString& path) {
+    const auto result = stdsptr<eMappedFile>(new eMappedFile(path));
+    if(!result->mData) return nullptr;
+    return result;
+}
+
+eMappedFile::eMappedFile(const QString& path) :
+    mPath(path), mFile(path) {
+    if(!mFile.open(QIODevice::ReadOnly)) return;
+    mSize = mFile.size();
+    mData = mFile.map(0, mSize);
+}
+
+eMappedFile::~eMappedFile() {
+    if(mData) mFile.unmap(mData);
+}
+
+QByteArray eMappedFile::data(const qint64 pos, const qint64 len) const {
+    if(pos < 0 || len < 0 || pos + len > mSize || len > INT_MAX)
+        RuntimeThrow("Invalid mapped file region");
+    const auto charData = reinterpret_cast<const char*>(mData + pos);
+    return QByteArray::fromRawData(charData, static_cast<int>(len));
+}
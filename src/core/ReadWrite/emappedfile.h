@@ -0,0 +1,60 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EMAPPEDFILE_H
+#define EMAPPEDFILE_H
+
+#include <QFile>
+
+#include "../smartPointers/stdselfref.h"
+
+//! @brief Read-only memory mapping of a file,
+//! shared by all the objects that load their data from it on demand.
+class CORE_EXPORT eMappedFile {
+public:
+    //! @brief Returns nullptr if the file could not be mapped
+    static stdsptr<eMappedFile> sMap(const QString& path);
+
+    ~eMappedFile();
+
+    const QString& path() const { return mPath; }
+    qint64 size() const { return mSize; }
+
+    //! @brief Returns the mapped data without copying it,
+    //! valid only as long as this eMappedFile exists.
+    QByteArray data(const qint64 pos, const qint64 len) const;
+private:
+    eMappedFile(const QString& path);
+
+    const QString mPath;
+    QFile mFile;
+    uchar* mData = nullptr;
+    qint64 mSize = 0;
+};
+
+//! @brief Serialized object data stored in a mapped file.
+struct CORE_EXPORT eFileRegion {
+    bool isValid() const { return static_cast<bool>(fFile); }
+
+    QByteArray data() const { return fFile->data(fPos, fSize); }
+
+    stdsptr<eMappedFile> fFile;
+    int fEvFileVersion = 0;
+    qint64 fPos = 0;
+    qint64 fSize = 0;
+};
+
+#endif // EMAPPEDFILE_H
@@ -67,11 +67,67 @@ void eReadStream::readCheckpoint(const QString &errMsg) {
                      QString::number(pos) + "'.\n" + errMsg);
 }
 
+void eReadStream::readTableOfContents(const qint64 tocPos) {
+    mChunks.clear();
+    mChunkAt.clear();
+    if(tocPos < 0) return;
+    const qint64 savedPos = mSrc->pos();
+    if(!mSrc->seek(tocPos))
+        RuntimeThrow("Failed to seek to table of contents");
+    int nChunks; *this >> nChunks;
+    for(int i = 0; i < nChunks; i++) {
+        eChunkInfo chunk;
+        int type; *this >> type;
+        chunk.fType = static_cast<eChunkType>(type);
+        *this >> chunk.fName;
+        read(&chunk.fPos, sizeof(qint64));
+        read(&chunk.fEnd, sizeof(qint64));
+        *this >> chunk.fFutureId;
+        *this >> chunk.fEndFutureId;
+        *this >> chunk.fParent;
+        mChunkAt.insert(chunk.fPos, i);
+        mChunks << chunk;
+    }
+    if(!mSrc->seek(savedPos))
+        RuntimeThrow("Could not restore current position for QIODevice.");
+}
+
+QList<int> eReadStream::chunkIds(const eChunkType type,
+                                 const int parent) const {
+    QList<int> result;
+    for(int i = 0; i < mChunks.count(); i++) {
+        const auto& chunk = mChunks.at(i);
+        if(chunk.fType == type && chunk.fParent == parent) result << i;
+    }
+    return result;
+}
+
+bool eReadStream::seekChunk(const int id) {
+    const auto& chunk = mChunks.at(id);
+    mFutureTable.setNextFutureId(chunk.fFutureId);
+    return mSrc->seek(chunk.fPos);
+}
+
+bool eReadStream::seekChunkEnd(const int id) {
+    const auto& chunk = mChunks.at(id);
+    mFutureTable.setNextFutureId(chunk.fEndFutureId);
+    return mSrc->seek(chunk.fEnd);
+}
+
 QByteArray eReadStream::readCompressed() {
     QByteArray compressed; *this >> compressed;
     return qUncompress(compressed);
 }
 
+eFileRegion eReadStream::mappedRegion(const qint64 pos) const {
+    eFileRegion region;
+    region.fFile = mMappedFile;
+    region.fEvFileVersion = mEvFileVersion;
+    region.fPos = pos;
+    region.fSize = mSrc->pos() - pos;
+    return region;
+}
+
 QString eReadStream::readFilePath() {
     QString readAbsPath; *this >> readAbsPath;
     if(mEvFileVersion < EvFormat::relativeFilePathSave) {
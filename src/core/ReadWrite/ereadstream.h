@@ -3,10 +3,13 @@
 
 #include "../core_global.h"
 #include "efuturepos.h"
+#include "echunkinfo.h"
 #include "../XML/runtimewriteid.h"
+#include "emappedfile.h"
 
 #include <QIODevice>
 #include <QDir>
+#include <QHash>
 
 class SimpleBrushWrapper;
 struct iValueRange;
@@ -25,6 +28,8 @@ class CORE_EXPORT eReadFutureTable {
         return mFutures.at(mFutureId++);
     }
 
+    void setNextFutureId(const int id) { mFutureId = id; }
+
     void read();
 private:
     int mFutureId = 0;
@@ -56,12 +61,35 @@ public:
 
     void readCheckpoint(const QString& errMsg);
 
+    //! @brief Reads the table of contents found at tocPos, does nothing
+    //! for negative positions (no table of contents in the file).
+    void readTableOfContents(const qint64 tocPos);
+    bool hasTableOfContents() const { return !mChunks.isEmpty(); }
+    const QList<eChunkInfo>& chunks() const { return mChunks; }
+    //! @brief Returns ids of chunks of the given type inside parent
+    QList<int> chunkIds(const eChunkType type, const int parent = -1) const;
+    //! @brief Returns id of the chunk beginning at pos, -1 if none
+    int chunkAt(const qint64 pos) const { return mChunkAt.value(pos, -1); }
+    //! @brief Moves to the beginning of the chunk
+    bool seekChunk(const int id);
+    //! @brief Moves past the chunk, skipping all of its content
+    bool seekChunkEnd(const int id);
+
     inline qint64 read(void* const data, const qint64 len) {
         return mSrc->read(reinterpret_cast<char*>(data), len);
     }
 
     QByteArray readCompressed();
 
+    qint64 pos() const { return mSrc->pos(); }
+    bool skip(const qint64 len) { return mSrc->seek(mSrc->pos() + len); }
+
+    //! @brief Mapped source file, lets heavy data be loaded on demand
+    void setMappedFile(const stdsptr<eMappedFile>& file) { mMappedFile = file; }
+    const stdsptr<eMappedFile>& mappedFile() const { return mMappedFile; }
+    //! @brief Region of the mapped file between pos and the current position
+    eFileRegion mappedRegion(const qint64 pos) const;
+
     eReadStream& operator>>(bool &val);
     eReadStream& operator>>(int &val);
     eReadStream& operator>>(uint& val);
@@ -94,6 +122,9 @@ private:
     QDir mDir;
     eReadFutureTable mFutureTable;
     RuntimeIdToWriteId mObjectListIdConv;
+    stdsptr<eMappedFile> mMappedFile;
+    QList<eChunkInfo> mChunks;
+    QHash<qint64, int> mChunkAt;
 };
 
 #endif // EREADSTREAM_H
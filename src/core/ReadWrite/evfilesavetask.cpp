@@ -0,0 +1,80 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "evfilesavetask.h"
+
+#include <QSaveFile>
+
+#include "Private/esettings.h"
+
+class EvFileWriter : public eHddTask {
+    e_OBJECT
+protected:
+    EvFileWriter(const QString& path,
+                 const stdsptr<eDeferredWriteData>& data) :
+        mPath(path), mData(data) {}
+public:
+    void process() {
+        // QSaveFile keeps the old file intact until commit
+        QSaveFile file(mPath);
+        if(!file.open(QIODevice::WriteOnly))
+            RuntimeThrow("Could not open file for writing " + mPath + ".");
+        mData->write(&file);
+        if(!file.commit())
+            RuntimeThrow("Error while writing to file " + mPath);
+    }
+private:
+    const QString mPath;
+    const stdsptr<eDeferredWriteData> mData;
+};
+
+static int compressorCount(const eDeferredWriteData& data) {
+    const int nBlobs = data.fBlobs.count();
+    if(nBlobs == 0) return 0;
+    return qBound(1, eSettings::sCpuThreadsCapped(), nBlobs);
+}
+
+EvFileSaveTask::EvFileSaveTask(const QString& path,
+                               const stdsptr<eDeferredWriteData>& data) :
+    ComplexTask(compressorCount(*data) + 1,
+                "Saving " + QFileInfo(path).fileName()),
+    mPath(path), mData(data) {}
+
+void EvFileSaveTask::nextStep() {
+    if(!mQued) return queTasks();
+    setValue(++mFinished);
+}
+
+void EvFileSaveTask::queTasks() {
+    mQued = true;
+    const auto writer = enve::make_shared<EvFileWriter>(mPath, mData);
+    writer->setPriority(eTaskPriority::backgroundIo);
+    const int nCompressors = finishValue() - 1;
+    for(int i = 0; i < nCompressors; i++) {
+        const auto data = mData;
+        const auto compress = [data, i, nCompressors]() {
+            data->compress(i, nCompressors);
+        };
+        const auto compressor = enve::make_shared<eCustomCpuTask>(
+                    nullptr, compress, nullptr, nullptr);
+        compressor->setPriority(eTaskPriority::backgroundIo);
+        compressor->addDependent(writer.get());
+        compressor->queTask();
+        addTask(compressor);
+    }
+    writer->queTask();
+    addTask(writer);
+}
@@ -0,0 +1,43 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EVFILESAVETASK_H
+#define EVFILESAVETASK_H
+
+#include "Private/Tasks/complextask.h"
+#include "ewritestream.h"
+
+//! @brief Compresses deferred blobs on the CPU threads
+//! and writes the .ev file on the HDD thread.
+class CORE_EXPORT EvFileSaveTask : public ComplexTask {
+public:
+    EvFileSaveTask(const QString& path,
+                   const stdsptr<eDeferredWriteData>& data);
+
+    void nextStep() override;
+
+    const QString& path() const { return mPath; }
+private:
+    void queTasks();
+
+    const QString mPath;
+    const stdsptr<eDeferredWriteData> mData;
+
+    bool mQued = false;
+    int mFinished = 0;
+};
+
+#endif // EVFILESAVETASK_H
@@ -1,5 +1,7 @@
 #include "ewritestream.h"
 
+#include <QBuffer>
+
 #include "exceptions.h"
 #include "Paint/simplebrushwrapper.h"
 #include "Paint/brushescontext.h"
@@ -20,6 +22,17 @@ void eWriteStream::setPath(const QString& path) {
 }
 
 void eWriteStream::writeFutureTable() {
+    if(mDeferred) {
+        const qint64 tablePos = mDst->pos();
+        const auto& futures = mFutureTable.mFutures;
+        for(int i = 0; i < futures.count(); i++) {
+            const auto it = mFutureBlobsBefore.find(i);
+            if(it == mFutureBlobsBefore.end()) continue;
+            const qint64 offset = tablePos + i*qint64(sizeof(eFuturePos)) +
+                                  qint64(offsetof(eFuturePos, fMain));
+            addPosFixup(offset, it.value());
+        }
+    }
     mFutureTable.write(*this);
 }
 
@@ -29,13 +42,71 @@ eWriteStream::FuturePosId eWriteStream::planFuturePos() {
 
 void eWriteStream::assignFuturePos(const eWriteStream::FuturePosId id) {
     mFutureTable.assignFuturePos(id.fId);
+    if(mDeferred) mFutureBlobsBefore[id.fId] = mDeferred->fBlobs.count();
 }
 
 void eWriteStream::writeCheckpoint() {
     const qint64 pos = mDst->pos();
+    if(mDeferred) addPosFixup(pos, mDeferred->fBlobs.count());
     write(&pos, sizeof(qint64));
 }
 
+int eWriteStream::beginChunk(const eChunkType type, const QString& name) {
+    const int id = mChunks.count();
+    const int parent = mOpenChunks.isEmpty() ? -1 : mOpenChunks.last();
+    const int futureId = mFutureTable.mFutures.count();
+    mChunks.append({type, name, mDst->pos(), -1, futureId, -1, parent});
+    const int blobsBefore = mDeferred ? mDeferred->fBlobs.count() : 0;
+    mChunkBlobsBefore.append({blobsBefore, blobsBefore});
+    mOpenChunks.append(id);
+    return id;
+}
+
+void eWriteStream::endChunk(const int id) {
+    if(mOpenChunks.isEmpty() || mOpenChunks.last() != id)
+        RuntimeThrow("Chunks have to be ended in reverse order");
+    mOpenChunks.removeLast();
+    auto& chunk = mChunks[id];
+    chunk.fEnd = mDst->pos();
+    chunk.fEndFutureId = mFutureTable.mFutures.count();
+    if(mDeferred) mChunkBlobsBefore[id].second = mDeferred->fBlobs.count();
+}
+
+void eWriteStream::writeTableOfContents() {
+    if(!mOpenChunks.isEmpty())
+        RuntimeThrow("Cannot write table of contents with unfinished chunks");
+    mTocPos = mDst->pos();
+    if(mDeferred) mTocBlobsBefore = mDeferred->fBlobs.count();
+    const int nChunks = mChunks.count();
+    *this << nChunks;
+    for(int i = 0; i < nChunks; i++) {
+        const auto& chunk = mChunks.at(i);
+        *this << static_cast<int>(chunk.fType);
+        *this << chunk.fName;
+        if(mDeferred) {
+            const auto& blobsBefore = mChunkBlobsBefore.at(i);
+            const qint64 pos = mDst->pos();
+            addPosFixup(pos, blobsBefore.first);
+            addPosFixup(pos + qint64(sizeof(qint64)), blobsBefore.second);
+        }
+        write(&chunk.fPos, sizeof(qint64));
+        write(&chunk.fEnd, sizeof(qint64));
+        *this << chunk.fFutureId;
+        *this << chunk.fEndFutureId;
+        *this << chunk.fParent;
+    }
+}
+
+void eWriteStream::writeTableOfContentsPos() {
+    if(mDeferred && mTocPos != -1)
+        addPosFixup(mDst->pos(), mTocBlobsBefore);
+    write(&mTocPos, sizeof(qint64));
+}
+
+void eWriteStream::addPosFixup(const qint64 offset, const int blobsBefore) {
+    mDeferred->fFixups.append({offset, blobsBefore});
+}
+
 qint64 eWriteStream::writeFile(QFile * const file) {
     if(!file) RuntimeThrow("No file to write");
     const bool openRes = file->open(QIODevice::ReadOnly);
@@ -59,12 +130,87 @@ qint64 eWriteStream::writeFile(QFile * const file) {
 
 qint64 eWriteStream::writeCompressed(const void* const data, const qint64 len) {
     const auto charData = reinterpret_cast<const char*>(data);
+    if(mDeferred) {
+        // deep copy, the source can change before it gets compressed
+        mDeferred->fBlobs.append({mDst->pos(), QByteArray(charData, int(len))});
+        return len;
+    }
     const auto ba = QByteArray::fromRawData(charData, len);
     const auto compressed = qCompress(ba);
     *this << compressed;
     return compressed.size();
 }
 
+qint64 eWriteStream::writeCompressed(const QByteArray& data) {
+    if(mDeferred) {
+        mDeferred->fBlobs.append({mDst->pos(), data});
+        return data.size();
+    }
+    const auto compressed = qCompress(data);
+    *this << compressed;
+    return compressed.size();
+}
+
+void eWriteStream::setDeferredCompression(const bool defer) {
+    if(defer == static_cast<bool>(mDeferred)) return;
+    if(defer) {
+        if(!qobject_cast<QBuffer*>(mDst))
+            RuntimeThrow("Deferred compression requires a QBuffer");
+        mDeferred = std::make_shared<eDeferredWriteData>();
+    } else {
+        mDeferred.reset();
+        mFutureBlobsBefore.clear();
+    }
+}
+
+stdsptr<eDeferredWriteData> eWriteStream::takeDeferredData() {
+    if(!mDeferred) return nullptr;
+    const auto buffer = static_cast<QBuffer*>(mDst);
+    mDeferred->fData = buffer->data();
+    const auto result = mDeferred;
+    setDeferredCompression(false);
+    return result;
+}
+
+void eDeferredWriteData::compress(const int first, const int step) {
+    const int nBlobs = fBlobs.count();
+    for(int i = first; i < nBlobs; i += step) {
+        auto& blob = fBlobs[i];
+        blob.fData = qCompress(blob.fData);
+    }
+}
+
+void eDeferredWriteData::write(QIODevice * const dst) {
+    const int nBlobs = fBlobs.count();
+    QVector<qint64> shift(nBlobs + 1);
+    shift[0] = 0;
+    for(int i = 0; i < nBlobs; i++) {
+        const qint64 blobSize = sizeof(int) + fBlobs.at(i).fData.size();
+        shift[i + 1] = shift[i] + blobSize;
+    }
+    const auto data = fData.data();
+    for(const auto& fixup : fFixups) {
+        qint64 pos;
+        memcpy(&pos, data + fixup.fOffset, sizeof(qint64));
+        pos += shift.at(fixup.fBlobsBefore);
+        memcpy(data + fixup.fOffset, &pos, sizeof(qint64));
+    }
+
+    const auto writeAll = [dst](const char* const src, const qint64 len) {
+        if(dst->write(src, len) != len)
+            RuntimeThrow("Failed to write data " + dst->errorString());
+    };
+    qint64 pos = 0;
+    for(const auto& blob : fBlobs) {
+        writeAll(data + pos, blob.fPos - pos);
+        pos = blob.fPos;
+        const int size = blob.fData.size();
+        writeAll(reinterpret_cast<const char*>(&size), sizeof(int));
+        writeAll(blob.fData.data(), size);
+    }
+    writeAll(data + pos, fData.size() - pos);
+}
+
 void eWriteStream::writeFilePath(const QString& absPath) {
     const QString relPath = mDir.relativeFilePath(absPath);
     *this << absPath;
@@ -5,12 +5,43 @@
 #include <QDir>
 
 #include "efuturepos.h"
+#include "echunkinfo.h"
 #include "../XML/runtimewriteid.h"
+#include "../smartPointers/stdselfref.h"
 
 class SimpleBrushWrapper;
 struct iValueRange;
 class eWriteStream;
 
+//! @brief Serialized data with the compression of heavy blobs postponed,
+//! see eWriteStream::setDeferredCompression.
+struct CORE_EXPORT eDeferredWriteData {
+    struct Blob {
+        //! @brief Position in fData the blob is inserted at
+        qint64 fPos;
+        //! @brief Raw data, replaced with compressed data by compress
+        QByteArray fData;
+    };
+
+    struct PosFixup {
+        //! @brief Offset of a written stream position in fData
+        qint64 fOffset;
+        //! @brief Number of blobs written before the position
+        int fBlobsBefore;
+    };
+
+    //! @brief Compresses every step-th blob starting from first,
+    //! calls with disjoint blob subsets can run concurrently.
+    void compress(const int first, const int step);
+    //! @brief Writes data with compressed blobs inserted
+    //! and stream positions adjusted to match.
+    void write(QIODevice* const dst);
+
+    QByteArray fData;
+    QList<Blob> fBlobs;
+    QList<PosFixup> fFixups;
+};
+
 class CORE_EXPORT eWriteFutureTable {
     friend class eWriteStream;
     eWriteFutureTable(QIODevice * const main) :
@@ -57,6 +88,16 @@ public:
 
     void writeCheckpoint();
 
+    //! @brief Starts a chunk listed in the table of contents,
+    //! returns id to be used with endChunk
+    int beginChunk(const eChunkType type, const QString& name);
+    void endChunk(const int id);
+
+    //! @brief Writes the table of contents, all chunks have to be ended
+    void writeTableOfContents();
+    //! @brief Writes the table of contents position, -1 if not written
+    void writeTableOfContentsPos();
+
     qint64 writeFile(QFile* const file);
 
     inline qint64 write(const void* const data, const qint64 len) {
@@ -64,6 +105,14 @@ public:
     }
 
     qint64 writeCompressed(const void* const data, const qint64 len);
+    //! @brief Deferred compression keeps a shallow copy of data,
+    //! changes made to the source later detach it
+    qint64 writeCompressed(const QByteArray& data);
+
+    //! @brief When enabled writeCompressed only stores a copy of the data,
+    //! QIODevice has to be a QBuffer.
+    void setDeferredCompression(const bool defer);
+    stdsptr<eDeferredWriteData> takeDeferredData();
 
     eWriteStream& operator<<(const bool val);
     eWriteStream& operator<<(const int val);
@@ -88,9 +137,18 @@ public:
     }
 
 private:
+    void addPosFixup(const qint64 offset, const int blobsBefore);
+
     QIODevice* const mDst;
     QDir mDir;
     eWriteFutureTable mFutureTable;
+    stdsptr<eDeferredWriteData> mDeferred;
+    QMap<int, int> mFutureBlobsBefore;
+    QList<eChunkInfo> mChunks;
+    QList<QPair<int, int>> mChunkBlobsBefore;
+    QList<int> mOpenChunks;
+    qint64 mTocPos = -1;
+    int mTocBlobsBefore = 0;
     RuntimeIdToWriteId mObjectListIdConv;
 };
 
@@ -8,6 +8,7 @@ char FileFooter::sAppName[15] = "enve";
 char FileFooter::sAppVersion[15] = ENVE_VERSION;
 
 void FileFooter::sWrite(eWriteStream& dst) {
+    dst.writeTableOfContentsPos();
     dst << EvFormat::version;
     dst.write(&sEVFormat[0], sizeof(char[15]));
     dst.write(&sAppName[0], sizeof(char[15]));
@@ -15,6 +16,9 @@ void FileFooter::sWrite(eWriteStream& dst) {
 }
 
 qint64 FileFooter::sSize(const int evVersion) {
+    if(evVersion >= EvFormat::tableOfContents)
+        return static_cast<qint64>(3*sizeof(char[15])) + sizeof(int) +
+               sizeof(qint64);
     if(evVersion > 1) return static_cast<qint64>(3*sizeof(char[15])) + sizeof(int);
     else return static_cast<qint64>(3*sizeof(char[15]));
 }
@@ -51,3 +55,16 @@ int FileFooter::sReadEvFileVersion(QIODevice * const src) {
         RuntimeThrow("Could not restore current position for QIODevice.");
     return evFormatVersion;
 }
+
+qint64 FileFooter::sReadTableOfContentsPos(QIODevice * const src,
+                                          const int evVersion) {
+    if(evVersion < EvFormat::tableOfContents) return -1;
+    const qint64 savedPos = src->pos();
+    if(!src->seek(src->size() - sSize(evVersion)))
+        RuntimeThrow("Failed to seek to table of contents position");
+    qint64 tocPos;
+    src->read(reinterpret_cast<char*>(&tocPos), sizeof(qint64));
+    if(!src->seek(savedPos))
+        RuntimeThrow("Could not restore current position for QIODevice.");
+    return tocPos;
+}
@@ -14,6 +14,9 @@ public:
     static qint64 sSize(const int evVersion);
 
     static int sReadEvFileVersion(QIODevice * const src);
+    //! @brief Returns -1 for files without a table of contents
+    static qint64 sReadTableOfContentsPos(QIODevice * const src,
+                                          const int evVersion);
 private:
     static char sEVFormat[15];
     static char sAppName[15];
@@ -0,0 +1,1730 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "cpushaderprogram.h"
+
+#include "exceptions.h"
+
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <functional>
+#include <map>
+
+// the shader source is parsed and translated directly into a tree of
+// closures, every closure knows the static types of its operands
+
+namespace CpuShader {
+
+typedef CpuShaderProgram::Value Val;
+typedef CpuShaderProgram::Image Image;
+
+enum class Base : char { Void, Bool, Int, Float, Sampler };
+
+struct Type {
+    Base fBase = Base::Void;
+    int fN = 1;
+
+    bool operator==(const Type& other) const {
+        return fBase == other.fBase && fN == other.fN;
+    }
+    bool operator!=(const Type& other) const {
+        return !(*this == other);
+    }
+    bool numeric() const {
+        return fBase == Base::Int || fBase == Base::Float;
+    }
+    bool scalar() const {
+        return fN == 1 && fBase != Base::Void && fBase != Base::Sampler;
+    }
+};
+
+static std::string typeName(const Type& type) {
+    const std::string n = std::to_string(type.fN);
+    switch(type.fBase) {
+    case Base::Void: return "void";
+    case Base::Sampler: return "sampler2D";
+    case Base::Bool: return type.fN == 1 ? "bool" : "bvec" + n;
+    case Base::Int: return type.fN == 1 ? "int" : "ivec" + n;
+    case Base::Float: return type.fN == 1 ? "float" : "vec" + n;
+    }
+    return "";
+}
+
+static bool typeFromName(const std::string& name, Type& type) {
+    static const std::map<std::string, Type> types = {
+        {"void", {Base::Void, 1}},
+        {"bool", {Base::Bool, 1}}, {"int", {Base::Int, 1}},
+        {"uint", {Base::Int, 1}}, {"float", {Base::Float, 1}},
+        {"vec2", {Base::Float, 2}}, {"vec3", {Base::Float, 3}},
+        {"vec4", {Base::Float, 4}}, {"ivec2", {Base::Int, 2}},
+        {"ivec3", {Base::Int, 3}}, {"ivec4", {Base::Int, 4}},
+        {"uvec2", {Base::Int, 2}}, {"uvec3", {Base::Int, 3}},
+        {"uvec4", {Base::Int, 4}}, {"bvec2", {Base::Bool, 2}},
+        {"bvec3", {Base::Bool, 3}}, {"bvec4", {Base::Bool, 4}},
+        {"sampler2D", {Base::Sampler, 1}}
+    };
+    const auto it = types.find(name);
+    if(it == types.end()) return false;
+    type = it->second;
+    return true;
+}
+
+enum class Flow : char { none, breakLoop, continueLoop, returnCall, discard };
+
+struct Ctx {
+    const CpuShaderProgram::Uniforms* fUniforms = nullptr;
+    const Image* fSrc = nullptr;
+    std::vector<Val> fGlobals;
+    std::vector<std::vector<Val>> fFrames;
+    Val fTexCoord;
+    Val fFragCoord;
+    Val fReturn;
+    Flow fFlow = Flow::none;
+};
+
+typedef std::function<Val(Ctx&)> Eval;
+typedef std::function<Val&(Ctx&)> Ref;
+typedef std::function<void(Ctx&)> Stmt;
+typedef std::array<int, 4> Comps;
+
+struct Node {
+    Type fType;
+    Eval fEval;
+    //! @brief Set for assignable nodes, fComps are the assigned components
+    Ref fRef;
+    Comps fComps = {0, 1, 2, 3};
+    bool fLiteral = false;
+    Val fValue;
+};
+
+struct Function {
+    std::string fName;
+    Type fReturn;
+    std::vector<Type> fParams;
+    int fId = 0;
+    int fSlots = 0;
+    Stmt fBody;
+};
+
+struct Program {
+    std::vector<std::unique_ptr<Function>> fFunctions;
+    std::vector<Stmt> fGlobalInit;
+    int fGlobalSlots = 0;
+    std::vector<std::string> fUniforms;
+    int fOutput = -1;
+    const Function* fMain = nullptr;
+    float fFragCoordOffset = 0.5f;
+    bool fFragCoordUpperLeft = false;
+};
+
+static Val sampleTexel(const Image& img, int x, int y) {
+    x = x < 0 ? 0 : (x >= img.fWidth ? img.fWidth - 1 : x);
+    y = y < 0 ? 0 : (y >= img.fHeight ? img.fHeight - 1 : y);
+    const unsigned char* const p = img.fPixels + y*img.fRowBytes + 4*x;
+    const float mult = 1.f/255;
+    Val result;
+    result.fV[0] = p[img.fBGRA ? 2 : 0]*mult;
+    result.fV[1] = p[1]*mult;
+    result.fV[2] = p[img.fBGRA ? 0 : 2]*mult;
+    result.fV[3] = p[3]*mult;
+    return result;
+}
+
+//! @brief Bilinear sampling with edge clamping
+static Val sampleLinear(const Image& img, const float u, const float v) {
+    const float x = u*img.fWidth - 0.5f;
+    const float y = v*img.fHeight - 0.5f;
+    const float x0f = std::floor(x);
+    const float y0f = std::floor(y);
+    const float fx = x - x0f;
+    const float fy = y - y0f;
+    const int x0 = static_cast<int>(x0f);
+    const int y0 = static_cast<int>(y0f);
+    const Val c00 = sampleTexel(img, x0, y0);
+    const Val c10 = sampleTexel(img, x0 + 1, y0);
+    const Val c01 = sampleTexel(img, x0, y0 + 1);
+    const Val c11 = sampleTexel(img, x0 + 1, y0 + 1);
+    Val result;
+    for(int i = 0; i < 4; i++) {
+        const float top = c00.fV[i] + (c10.fV[i] - c00.fV[i])*fx;
+        const float bottom = c01.fV[i] + (c11.fV[i] - c01.fV[i])*fx;
+        result.fV[i] = top + (bottom - top)*fy;
+    }
+    return result;
+}
+
+enum class Tok : char { end, ident, intNum, floatNum, punct };
+
+struct Token {
+    Tok fType;
+    std::string fText;
+    double fNum;
+    int fLine;
+};
+
+static std::vector<Token> tokenize(const std::string& src) {
+    static const char* const puncts[] = {
+        "++", "--", "+=", "-=", "*=", "/=", "%=", "==", "!=", "<=", ">=",
+        "&&", "||", "^^", "<<", ">>"
+    };
+    std::vector<Token> tokens;
+    const int len = static_cast<int>(src.size());
+    int line = 1;
+    bool lineStart = true;
+    int i = 0;
+    while(i < len) {
+        const char c = src[i];
+        if(c == '\n') {
+            line++;
+            lineStart = true;
+            i++;
+            continue;
+        }
+        if(std::isspace(static_cast<unsigned char>(c))) {
+            i++;
+            continue;
+        }
+        if(c == '/' && i + 1 < len && src[i + 1] == '/') {
+            while(i < len && src[i] != '\n') i++;
+            continue;
+        }
+        if(c == '/' && i + 1 < len && src[i + 1] == '*') {
+            i += 2;
+            while(i + 1 < len && !(src[i] == '*' && src[i + 1] == '/')) {
+                if(src[i] == '\n') line++;
+                i++;
+            }
+            i += 2;
+            continue;
+        }
+        if(c == '#' && lineStart) {
+            int end = i;
+            while(end < len && src[end] != '\n') end++;
+            const std::string directive = src.substr(i, end - i);
+            if(directive.compare(0, 8, "#version") != 0 &&
+               directive.compare(0, 10, "#extension") != 0) {
+                PrettyRuntimeThrow("line " + std::to_string(line) +
+                             ": unsupported preprocessor directive '" +
+                             directive + "'");
+            }
+            i = end;
+            continue;
+        }
+        lineStart = false;
+        if(std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            int end = i;
+            while(end < len && (std::isalnum(static_cast<unsigned char>(src[end])) ||
+                                src[end] == '_')) end++;
+            tokens.push_back({Tok::ident, src.substr(i, end - i), 0, line});
+            i = end;
+            continue;
+        }
+        const bool digit = std::isdigit(static_cast<unsigned char>(c));
+        if(digit || (c == '.' && i + 1 < len &&
+                     std::isdigit(static_cast<unsigned char>(src[i + 1])))) {
+            int end = i;
+            bool isFloat = false;
+            double value;
+            if(c == '0' && i + 1 < len && (src[i + 1] == 'x' || src[i + 1] == 'X')) {
+                end += 2;
+                while(end < len && std::isxdigit(static_cast<unsigned char>(src[end]))) end++;
+                value = static_cast<double>(std::stoll(src.substr(i + 2, end - i - 2), nullptr, 16));
+            } else {
+                while(end < len && std::isdigit(static_cast<unsigned char>(src[end]))) end++;
+                if(end < len && src[end] == '.') {
+                    isFloat = true;
+                    end++;
+                    while(end < len && std::isdigit(static_cast<unsigned char>(src[end]))) end++;
+                }
+                if(end < len && (src[end] == 'e' || src[end] == 'E')) {
+                    int expEnd = end + 1;
+                    if(expEnd < len && (src[expEnd] == '+' || src[expEnd] == '-')) expEnd++;
+                    if(expEnd < len && std::isdigit(static_cast<unsigned char>(src[expEnd]))) {
+                        isFloat = true;
+                        end = expEnd;
+                        while(end < len && std::isdigit(static_cast<unsigned char>(src[end]))) end++;
+                    }
+                }
+                value = std::stod(src.substr(i, end - i));
+            }
+            if(end < len && (src[end] == 'f' || src[end] == 'F')) {
+                isFloat = true;
+                end++;
+            } else if(end < len && (src[end] == 'u' || src[end] == 'U')) {
+                end++;
+            }
+            tokens.push_back({isFloat ? Tok::floatNum : Tok::intNum,
+                              src.substr(i, end - i), value, line});
+            i = end;
+            continue;
+        }
+        std::string punct(1, c);
+        for(const auto p : puncts) {
+            if(src.compare(i, 2, p) == 0) {
+                punct = p;
+                break;
+            }
+        }
+        tokens.push_back({Tok::punct, punct, 0, line});
+        i += static_cast<int>(punct.size());
+    }
+    tokens.push_back({Tok::end, "", 0, line});
+    return tokens;
+}
+
+static Node constant(const Type& type, const Val& value) {
+    Node node;
+    node.fType = type;
+    node.fEval = [value](Ctx&) { return value; };
+    node.fLiteral = true;
+    node.fValue = value;
+    return node;
+}
+
+static Val scalarVal(const float value) {
+    Val val;
+    val.fV[0] = value;
+    return val;
+}
+
+static float glslMod(const float x, const float y) {
+    return x - y*std::floor(x/y);
+}
+
+static float glslSign(const float x) {
+    return x > 0 ? 1.f : (x < 0 ? -1.f : 0.f);
+}
+
+static float glslFract(const float x) {
+    return x - std::floor(x);
+}
+
+static float glslClamp(const float x, const float lo, const float hi) {
+    return std::min(std::max(x, lo), hi);
+}
+
+static float glslMix(const float x, const float y, const float a) {
+    return x*(1 - a) + y*a;
+}
+
+static float glslStep(const float edge, const float x) {
+    return x < edge ? 0.f : 1.f;
+}
+
+static float glslSmoothstep(const float e0, const float e1, const float x) {
+    const float t = glslClamp((x - e0)/(e1 - e0), 0, 1);
+    return t*t*(3 - 2*t);
+}
+
+class Compiler {
+public:
+    Compiler(const std::string& source) :
+        mTokens(tokenize(source)),
+        mProgram(new Program) {}
+
+    std::unique_ptr<Program> compile() {
+        mScopes.emplace_back();
+        while(peek().fType != Tok::end) parseTopLevel();
+        for(const auto& function : mProgram->fFunctions) {
+            if(!function->fBody) error("'" + function->fName + "' is declared, "
+                                       "but not defined");
+            if(function->fName == "main" && function->fParams.empty())
+                mProgram->fMain = function.get();
+        }
+        if(!mProgram->fMain) error("'void main()' is not defined");
+        if(mProgram->fOutput == -1) error("No output color");
+        return std::move(mProgram);
+    }
+private:
+    enum class VarKind { global, local, uniform, texCoord, fragCoord, sampler };
+
+    struct Var {
+        VarKind fKind;
+        Type fType;
+        int fSlot;
+        int fFunction;
+        bool fConst;
+    };
+
+    [[noreturn]] void error(const std::string& msg) const {
+        PrettyRuntimeThrow("line " + std::to_string(peek().fLine) + ": " + msg);
+    }
+
+    const Token& peek(const int offset = 0) const {
+        const size_t id = std::min(mPos + offset, mTokens.size() - 1);
+        return mTokens[id];
+    }
+
+    const Token& next() {
+        const Token& token = peek();
+        if(mPos < mTokens.size() - 1) mPos++;
+        return token;
+    }
+
+    bool isPunct(const char* const punct, const int offset = 0) const {
+        const Token& token = peek(offset);
+        return token.fType == Tok::punct && token.fText == punct;
+    }
+
+    bool isIdent(const char* const ident, const int offset = 0) const {
+        const Token& token = peek(offset);
+        return token.fType == Tok::ident && token.fText == ident;
+    }
+
+    bool accept(const char* const punct) {
+        if(!isPunct(punct)) return false;
+        next();
+        return true;
+    }
+
+    void expect(const char* const punct) {
+        if(!accept(punct)) error("expected '" + std::string(punct) +
+                                 "' before '" + peek().fText + "'");
+    }
+
+    std::string expectIdent() {
+        if(peek().fType != Tok::ident)
+            error("expected identifier before '" + peek().fText + "'");
+        return next().fText;
+    }
+
+    static bool isPrecision(const std::string& word) {
+        return word == "highp" || word == "mediump" || word == "lowp";
+    }
+
+    //! @brief Returns true if a type starts at offset, skips precision
+    bool isTypeAt(int offset) const {
+        while(peek(offset).fType == Tok::ident &&
+              isPrecision(peek(offset).fText)) offset++;
+        Type type;
+        return peek(offset).fType == Tok::ident &&
+               typeFromName(peek(offset).fText, type);
+    }
+
+    Type parseType() {
+        while(peek().fType == Tok::ident && isPrecision(peek().fText)) next();
+        Type type;
+        const std::string name = expectIdent();
+        if(!typeFromName(name, type)) error("unsupported type '" + name + "'");
+        return type;
+    }
+
+    void skipParens() {
+        expect("(");
+        int depth = 1;
+        while(depth > 0) {
+            if(peek().fType == Tok::end) error("unexpected end of source");
+            const Token& token = next();
+            if(token.fType != Tok::punct) continue;
+            if(token.fText == "(") depth++;
+            else if(token.fText == ")") depth--;
+        }
+    }
+
+    // top level
+
+    void parseTopLevel() {
+        if(accept(";")) return;
+        if(isIdent("precision")) {
+            while(!accept(";")) next();
+            return;
+        }
+        if(isIdent("struct")) error("structs are not supported");
+        bool isConst = false;
+        std::string storage;
+        while(true) {
+            if(isIdent("layout")) {
+                next();
+                const size_t start = mPos;
+                skipParens();
+                for(size_t i = start; i < mPos; i++) {
+                    const auto& text = mTokens[i].fText;
+                    if(text == "pixel_center_integer")
+                        mProgram->fFragCoordOffset = 0;
+                    else if(text == "origin_upper_left")
+                        mProgram->fFragCoordUpperLeft = true;
+                }
+            } else if(isIdent("const")) {
+                next();
+                isConst = true;
+            } else if(isIdent("uniform") || isIdent("in") || isIdent("out") ||
+                      isIdent("varying") || isIdent("attribute")) {
+                storage = next().fText;
+            } else if(isIdent("flat") || isIdent("smooth") ||
+                      isIdent("noperspective") || isIdent("invariant")) {
+                next();
+            } else break;
+        }
+        const Type type = parseType();
+        const std::string name = expectIdent();
+        if(isPunct("(")) {
+            if(!storage.empty() || isConst) error("unexpected function qualifier");
+            return parseFunction(type, name);
+        }
+        if(storage == "uniform") return parseUniform(type, name);
+        if(storage == "in" || storage == "varying") return parseInput(type, name);
+        if(storage == "out") return parseOutput(type, name);
+        if(!storage.empty()) error("unsupported storage '" + storage + "'");
+        parseGlobals(type, name, isConst);
+    }
+
+    void parseUniform(const Type& type, const std::string& name) {
+        if(isPunct("[")) error("uniform arrays are not supported");
+        Var var;
+        var.fType = type;
+        var.fFunction = -1;
+        var.fConst = true;
+        if(type.fBase == Base::Sampler) {
+            var.fKind = VarKind::sampler;
+            var.fSlot = -1;
+        } else {
+            if(type.fBase == Base::Void) error("void uniform");
+            var.fKind = VarKind::uniform;
+            var.fSlot = static_cast<int>(mProgram->fUniforms.size());
+            mProgram->fUniforms.push_back(name);
+        }
+        declare(name, var);
+        expect(";");
+    }
+
+    void parseInput(const Type& type, const std::string& name) {
+        if(name == "gl_FragCoord") {
+            // redeclaration with layout qualifiers
+        } else if(type == Type{Base::Float, 2}) {
+            declare(name, {VarKind::texCoord, type, -1, -1, true});
+        } else error("unsupported input '" + name + "'");
+        expect(";");
+    }
+
+    void parseOutput(const Type& type, const std::string& name) {
+        if(type != Type{Base::Float, 4}) error("output has to be a vec4");
+        if(mProgram->fOutput != -1) error("multiple outputs are not supported");
+        const int slot = mProgram->fGlobalSlots++;
+        mProgram->fOutput = slot;
+        declare(name, {VarKind::global, type, slot, -1, false});
+        expect(";");
+    }
+
+    void parseGlobals(const Type& type, std::string name, const bool isConst) {
+        if(type.fBase == Base::Void || type.fBase == Base::Sampler)
+            error("invalid variable type");
+        while(true) {
+            if(isPunct("[")) error("arrays are not supported");
+            const int slot = mProgram->fGlobalSlots++;
+            if(accept("=")) {
+                const Node init = convert(parseAssignment(), type);
+                const auto eval = init.fEval;
+                mProgram->fGlobalInit.push_back([slot, eval](Ctx& ctx) {
+                    ctx.fGlobals[slot] = eval(ctx);
+                });
+            } else if(isConst) error("const variable without initializer");
+            declare(name, {VarKind::global, type, slot, -1, isConst});
+            if(accept(";")) break;
+            expect(",");
+            name = expectIdent();
+        }
+    }
+
+    void parseFunction(const Type& returnType, const std::string& name) {
+        expect("(");
+        std::vector<Type> params;
+        std::vector<std::string> names;
+        if(isIdent("void") && isPunct(")", 1)) next();
+        while(!accept(")")) {
+            if(!params.empty()) expect(",");
+            while(isIdent("const") || isIdent("in")) next();
+            if(isIdent("out") || isIdent("inout"))
+                error("out parameters are not supported");
+            const Type type = parseType();
+            if(type.fBase == Base::Sampler)
+                error("sampler parameters are not supported");
+            params.push_back(type);
+            names.push_back(peek().fType == Tok::ident ? next().fText : "");
+            if(isPunct("[")) error("array parameters are not supported");
+        }
+        Function* function = findExact(name, params);
+        if(function) {
+            if(function->fReturn != returnType)
+                error("'" + name + "' redeclared with a different return type");
+        } else {
+            mProgram->fFunctions.emplace_back(new Function);
+            function = mProgram->fFunctions.back().get();
+            function->fName = name;
+            function->fReturn = returnType;
+            function->fParams = params;
+            function->fId = static_cast<int>(mProgram->fFunctions.size()) - 1;
+        }
+        if(accept(";")) return;
+        if(function->fBody) error("'" + name + "' redefined");
+        mFunction = function;
+        mScopes.emplace_back();
+        for(size_t i = 0; i < params.size(); i++) {
+            if(names[i].empty()) continue;
+            declare(names[i], {VarKind::local, params[i], static_cast<int>(i),
+                               function->fId, false});
+        }
+        function->fSlots = static_cast<int>(params.size());
+        function->fBody = parseBlock(false);
+        mScopes.pop_back();
+        mFunction = nullptr;
+    }
+
+    // scopes
+
+    void declare(const std::string& name, const Var& var) {
+        auto& scope = mScopes.back();
+        if(scope.find(name) != scope.end()) error("'" + name + "' redefined");
+        scope[name] = var;
+    }
+
+    bool lookup(const std::string& name, Var& var) {
+        for(auto it = mScopes.rbegin(); it != mScopes.rend(); it++) {
+            const auto found = it->find(name);
+            if(found == it->end()) continue;
+            var = found->second;
+            return true;
+        }
+        if(name == "gl_FragCoord") {
+            var = {VarKind::fragCoord, {Base::Float, 4}, -1, -1, true};
+            return true;
+        }
+        if(name == "gl_FragColor" && mProgram->fOutput == -1) {
+            const int slot = mProgram->fGlobalSlots++;
+            mProgram->fOutput = slot;
+            var = {VarKind::global, {Base::Float, 4}, slot, -1, false};
+            mScopes.front()[name] = var;
+            return true;
+        }
+        return false;
+    }
+
+    int newLocal() {
+        if(!mFunction) error("local variable outside of a function");
+        return mFunction->fSlots++;
+    }
+
+    Node varNode(const Var& var) {
+        Node node;
+        node.fType = var.fType;
+        const int slot = var.fSlot;
+        switch(var.fKind) {
+        case VarKind::global:
+            node.fEval = [slot](Ctx& ctx) { return ctx.fGlobals[slot]; };
+            if(!var.fConst) {
+                node.fRef = [slot](Ctx& ctx) -> Val& {
+                    return ctx.fGlobals[slot];
+                };
+            }
+            break;
+        case VarKind::local: {
+            const int function = var.fFunction;
+            node.fEval = [function, slot](Ctx& ctx) {
+                return ctx.fFrames[function][slot];
+            };
+            if(!var.fConst) {
+                node.fRef = [function, slot](Ctx& ctx) -> Val& {
+                    return ctx.fFrames[function][slot];
+                };
+            }
+        } break;
+        case VarKind::uniform:
+            node.fEval = [slot](Ctx& ctx) { return (*ctx.fUniforms)[slot]; };
+            break;
+        case VarKind::texCoord:
+            node.fEval = [](Ctx& ctx) { return ctx.fTexCoord; };
+            break;
+        case VarKind::fragCoord:
+            node.fEval = [](Ctx& ctx) { return ctx.fFragCoord; };
+            break;
+        case VarKind::sampler:
+            node.fEval = [](Ctx&) { return Val(); };
+            break;
+        }
+        return node;
+    }
+
+    // statements
+
+    Stmt parseBlock(const bool newScope = true) {
+        expect("{");
+        if(newScope) mScopes.emplace_back();
+        std::vector<Stmt> stmts;
+        while(!accept("}")) {
+            if(peek().fType == Tok::end) error("unexpected end of source");
+            const Stmt stmt = parseStatement();
+            if(stmt) stmts.push_back(stmt);
+        }
+        if(newScope) mScopes.pop_back();
+        if(stmts.size() == 1) return stmts.front();
+        return [stmts](Ctx& ctx) {
+            for(const auto& stmt : stmts) {
+                stmt(ctx);
+                if(ctx.fFlow != Flow::none) return;
+            }
+        };
+    }
+
+    //! @brief Statement in its own scope, as the body of if or for
+    Stmt parseScopedStatement() {
+        mScopes.emplace_back();
+        const Stmt stmt = parseStatement();
+        mScopes.pop_back();
+        return stmt;
+    }
+
+    Stmt parseStatement() {
+        if(isPunct("{")) return parseBlock();
+        if(accept(";")) return nullptr;
+        if(isIdent("if")) return parseIf();
+        if(isIdent("for")) return parseFor();
+        if(isIdent("while")) return parseWhile();
+        if(isIdent("do")) return parseDoWhile();
+        if(isIdent("return")) return parseReturn();
+        if(isIdent("break") || isIdent("continue") || isIdent("discard")) {
+            const std::string word = next().fText;
+            expect(";");
+            const Flow flow = word == "break" ? Flow::breakLoop :
+                              word == "continue" ? Flow::continueLoop :
+                                                   Flow::discard;
+            if(flow != Flow::discard && mLoopDepth == 0)
+                error("'" + word + "' outside of a loop");
+            return [flow](Ctx& ctx) { ctx.fFlow = flow; };
+        }
+        if(isIdent("switch")) error("switch is not supported");
+        const Stmt decl = parseDeclarationIf();
+        if(decl || mDeclared) {
+            mDeclared = false;
+            expect(";");
+            return decl;
+        }
+        const Node expr = parseExpression();
+        expect(";");
+        const auto eval = expr.fEval;
+        return [eval](Ctx& ctx) { eval(ctx); };
+    }
+
+    //! @brief Parses a local declaration if there is one,
+    //! mDeclared is set if a declaration without any initializer was parsed
+    Stmt parseDeclarationIf() {
+        int offset = 0;
+        const bool isConst = isIdent("const");
+        if(isConst) offset++;
+        if(!isTypeAt(offset)) return nullptr;
+        // constructor calls start expressions
+        int typeEnd = offset;
+        while(isPrecision(peek(typeEnd).fText)) typeEnd++;
+        if(peek(typeEnd + 1).fType != Tok::ident) return nullptr;
+        if(isConst) next();
+        const Type type = parseType();
+        if(type.fBase == Base::Void || type.fBase == Base::Sampler)
+            error("invalid variable type");
+        std::vector<Stmt> stmts;
+        while(true) {
+            const std::string name = expectIdent();
+            if(isPunct("[")) error("arrays are not supported");
+            const int slot = newLocal();
+            const int function = mFunction->fId;
+            if(accept("=")) {
+                const auto eval = convert(parseAssignment(), type).fEval;
+                stmts.push_back([function, slot, eval](Ctx& ctx) {
+                    ctx.fFrames[function][slot] = eval(ctx);
+                });
+            } else {
+                if(isConst) error("const variable without initializer");
+                stmts.push_back([function, slot](Ctx& ctx) {
+                    ctx.fFrames[function][slot] = Val();
+                });
+            }
+            // declared after the initializer, as in 'float x = x;'
+            declare(name, {VarKind::local, type, slot, function, isConst});
+            if(!accept(",")) break;
+        }
+        mDeclared = true;
+        if(stmts.size() == 1) return stmts.front();
+        return [stmts](Ctx& ctx) {
+            for(const auto& stmt : stmts) stmt(ctx);
+        };
+    }
+
+    Eval parseCondition() {
+        const Node cond = parseExpression();
+        if(cond.fType != Type{Base::Bool, 1})
+            error("condition has to be a bool, not " + typeName(cond.fType));
+        return cond.fEval;
+    }
+
+    Stmt parseIf() {
+        next();
+        expect("(");
+        const Eval cond = parseCondition();
+        expect(")");
+        const Stmt ifStmt = parseScopedStatement();
+        Stmt elseStmt;
+        if(isIdent("else")) {
+            next();
+            elseStmt = parseScopedStatement();
+        }
+        return [cond, ifStmt, elseStmt](Ctx& ctx) {
+            if(cond(ctx).fV[0] != 0) {
+                if(ifStmt) ifStmt(ctx);
+            } else if(elseStmt) elseStmt(ctx);
+        };
+    }
+
+    //! @brief Returns true if the loop has to stop
+    static bool afterLoopBody(Ctx& ctx) {
+        if(ctx.fFlow == Flow::none) return false;
+        if(ctx.fFlow == Flow::continueLoop) {
+            ctx.fFlow = Flow::none;
+            return false;
+        }
+        if(ctx.fFlow == Flow::breakLoop) ctx.fFlow = Flow::none;
+        return true;
+    }
+
+    Stmt parseLoopBody() {
+        mLoopDepth++;
+        const Stmt body = parseScopedStatement();
+        mLoopDepth--;
+        return body;
+    }
+
+    Stmt parseFor() {
+        next();
+        expect("(");
+        mScopes.emplace_back();
+        Stmt init = parseDeclarationIf();
+        if(init || mDeclared) {
+            mDeclared = false;
+            expect(";");
+        } else if(!accept(";")) {
+            const auto eval = parseExpression().fEval;
+            init = [eval](Ctx& ctx) { eval(ctx); };
+            expect(";");
+        }
+        Eval cond;
+        if(!isPunct(";")) cond = parseCondition();
+        expect(";");
+        Eval step;
+        if(!isPunct(")")) step = parseExpression().fEval;
+        expect(")");
+        const Stmt body = parseLoopBody();
+        mScopes.pop_back();
+        return [init, cond, step, body](Ctx& ctx) {
+            if(init) init(ctx);
+            while(!cond || cond(ctx).fV[0] != 0) {
+                if(body) {
+                    body(ctx);
+                    if(afterLoopBody(ctx)) return;
+                }
+                if(step) step(ctx);
+            }
+        };
+    }
+
+    Stmt parseWhile() {
+        next();
+        expect("(");
+        const Eval cond = parseCondition();
+        expect(")");
+        const Stmt body = parseLoopBody();
+        return [cond, body](Ctx& ctx) {
+            while(cond(ctx).fV[0] != 0) {
+                if(!body) continue;
+                body(ctx);
+                if(afterLoopBody(ctx)) return;
+            }
+        };
+    }
+
+    Stmt parseDoWhile() {
+        next();
+        const Stmt body = parseLoopBody();
+        if(!isIdent("while")) error("expected 'while'");
+        next();
+        expect("(");
+        const Eval cond = parseCondition();
+        expect(")");
+        expect(";");
+        return [cond, body](Ctx& ctx) {
+            do {
+                if(!body) continue;
+                body(ctx);
+                if(afterLoopBody(ctx)) return;
+            } while(cond(ctx).fV[0] != 0);
+        };
+    }
+
+    Stmt parseReturn() {
+        next();
+        if(!mFunction) error("return outside of a function");
+        if(accept(";")) {
+            if(mFunction->fReturn.fBase != Base::Void)
+                error("missing return value");
+            return [](Ctx& ctx) { ctx.fFlow = Flow::returnCall; };
+        }
+        const auto eval = convert(parseExpression(), mFunction->fReturn).fEval;
+        expect(";");
+        return [eval](Ctx& ctx) {
+            ctx.fReturn = eval(ctx);
+            ctx.fFlow = Flow::returnCall;
+        };
+    }
+
+    // expressions
+
+    Node parseExpression() {
+        return parseAssignment();
+    }
+
+    Node parseAssignment() {
+        const Node lhs = parseTernary();
+        static const char* const ops[] = {"=", "+=", "-=", "*=", "/=", "%="};
+        for(const auto op : ops) {
+            if(!isPunct(op)) continue;
+            next();
+            const Node rhs = parseAssignment();
+            if(op[0] == '=') return assign(lhs, rhs);
+            return assign(lhs, binary(std::string(1, op[0]), lhs, rhs));
+        }
+        return lhs;
+    }
+
+    Node parseTernary() {
+        const Node cond = parseBinary(1);
+        if(!accept("?")) return cond;
+        if(cond.fType != Type{Base::Bool, 1})
+            error("condition has to be a bool, not " + typeName(cond.fType));
+        Node a = parseAssignment();
+        expect(":");
+        Node b = parseAssignment();
+        promote(a, b);
+        if(a.fType != b.fType) error("mismatched types in conditional");
+        Node node;
+        node.fType = a.fType;
+        const auto c = cond.fEval;
+        const auto ea = a.fEval;
+        const auto eb = b.fEval;
+        node.fEval = [c, ea, eb](Ctx& ctx) {
+            return c(ctx).fV[0] != 0 ? ea(ctx) : eb(ctx);
+        };
+        return node;
+    }
+
+    static int precedence(const Token& token) {
+        if(token.fType != Tok::punct) return -1;
+        static const std::map<std::string, int> precs = {
+            {"||", 1}, {"^^", 2}, {"&&", 3},
+            {"==", 6}, {"!=", 6},
+            {"<", 7}, {">", 7}, {"<=", 7}, {">=", 7},
+            {"+", 9}, {"-", 9},
+            {"*", 10}, {"/", 10}, {"%", 10}
+        };
+        const auto it = precs.find(token.fText);
+        return it == precs.end() ? -1 : it->second;
+    }
+
+    Node parseBinary(const int minPrec) {
+        Node lhs = parseUnary();
+        while(true) {
+            const int prec = precedence(peek());
+            if(prec < minPrec) break;
+            const std::string op = next().fText;
+            const Node rhs = parseBinary(prec + 1);
+            lhs = binary(op, lhs, rhs);
+        }
+        return lhs;
+    }
+
+    Node parseUnary() {
+        if(accept("+")) return parseUnary();
+        if(accept("-")) {
+            const Node arg = parseUnary();
+            if(!arg.fType.numeric()) error("invalid operand for '-'");
+            return binary("-", constant(arg.fType, Val()), arg);
+        }
+        if(accept("!")) {
+            const Node arg = parseUnary();
+            if(arg.fType != Type{Base::Bool, 1}) error("invalid operand for '!'");
+            Node node;
+            node.fType = arg.fType;
+            const auto eval = arg.fEval;
+            node.fEval = [eval](Ctx& ctx) {
+                return scalarVal(eval(ctx).fV[0] == 0 ? 1 : 0);
+            };
+            return node;
+        }
+        if(isPunct("++") || isPunct("--")) {
+            const std::string op(1, next().fText[0]);
+            const Node arg = parseUnary();
+            return assign(arg, binary(op, arg, one(arg.fType)));
+        }
+        if(isPunct("~")) error("bitwise operators are not supported");
+        return parsePostfix(parsePrimary());
+    }
+
+    Node one(const Type& type) {
+        Val val;
+        for(int i = 0; i < type.fN; i++) val.fV[i] = 1;
+        return constant(type, val);
+    }
+
+    Node parsePostfix(Node node) {
+        while(true) {
+            if(accept(".")) {
+                node = swizzle(node, expectIdent());
+            } else if(accept("[")) {
+                const Node index = parseExpression();
+                expect("]");
+                node = indexed(node, index);
+            } else if(isPunct("++") || isPunct("--")) {
+                const std::string op(1, next().fText[0]);
+                const Node updated = assign(node, binary(op, node, one(node.fType)));
+                const auto old = node.fEval;
+                const auto update = updated.fEval;
+                Node result;
+                result.fType = node.fType;
+                result.fEval = [old, update](Ctx& ctx) {
+                    const Val val = old(ctx);
+                    update(ctx);
+                    return val;
+                };
+                node = result;
+            } else break;
+        }
+        return node;
+    }
+
+    Node parsePrimary() {
+        const Token& token = peek();
+        if(token.fType == Tok::intNum) {
+            next();
+            return constant({Base::Int, 1}, scalarVal(static_cast<float>(token.fNum)));
+        }
+        if(token.fType == Tok::floatNum) {
+            next();
+            return constant({Base::Float, 1}, scalarVal(static_cast<float>(token.fNum)));
+        }
+        if(accept("(")) {
+            const Node node = parseExpression();
+            expect(")");
+            return node;
+        }
+        if(token.fType != Tok::ident)
+            error("unexpected '" + token.fText + "'");
+        if(token.fText == "true" || token.fText == "false") {
+            next();
+            return constant({Base::Bool, 1}, scalarVal(token.fText == "true"));
+        }
+        const std::string name = next().fText;
+        Type type;
+        if(typeFromName(name, type)) {
+            if(type.fBase == Base::Void || type.fBase == Base::Sampler)
+                error("invalid constructor '" + name + "'");
+            return construct(type, parseArgs());
+        }
+        if(isPunct("(")) return call(name, parseArgs());
+        Var var;
+        if(!lookup(name, var)) error("undeclared identifier '" + name + "'");
+        return varNode(var);
+    }
+
+    std::vector<Node> parseArgs() {
+        expect("(");
+        std::vector<Node> args;
+        if(isIdent("void") && isPunct(")", 1)) next();
+        while(!accept(")")) {
+            if(!args.empty()) expect(",");
+            args.push_back(parseAssignment());
+        }
+        return args;
+    }
+
+    // operations
+
+    Node swizzle(const Node& node, const std::string& fields) {
+        if(node.fType.fBase == Base::Void || node.fType.fBase == Base::Sampler)
+            error("invalid swizzle base");
+        const int n = static_cast<int>(fields.size());
+        if(n < 1 || n > 4) error("invalid swizzle '" + fields + "'");
+        static const std::string sets[] = {"xyzw", "rgba", "stpq"};
+        Comps comps = {0, 0, 0, 0};
+        int set = -1;
+        for(int i = 0; i < n; i++) {
+            int comp = -1;
+            for(int s = 0; s < 3 && comp == -1; s++) {
+                const auto pos = sets[s].find(fields[i]);
+                if(pos == std::string::npos) continue;
+                if(set != -1 && set != s) error("mixed swizzle sets '" + fields + "'");
+                set = s;
+                comp = static_cast<int>(pos);
+            }
+            if(comp == -1 || comp >= node.fType.fN)
+                error("invalid swizzle '" + fields + "'");
+            comps[i] = comp;
+        }
+        return selected(node, comps, n);
+    }
+
+    Node indexed(const Node& node, const Node& index) {
+        if(node.fType.fN == 1) error("only vectors can be indexed");
+        if(index.fType != Type{Base::Int, 1}) error("index has to be an int");
+        // constant indices keep the node assignable
+        if(index.fLiteral) {
+            const int comp = static_cast<int>(index.fValue.fV[0]);
+            if(comp < 0 || comp >= node.fType.fN) error("index out of range");
+            return selected(node, {comp, 0, 0, 0}, 1);
+        }
+        Node result;
+        result.fType = {node.fType.fBase, 1};
+        const auto eval = node.fEval;
+        const auto evalIndex = index.fEval;
+        const int n = node.fType.fN;
+        result.fEval = [eval, evalIndex, n](Ctx& ctx) {
+            const Val val = eval(ctx);
+            int comp = static_cast<int>(evalIndex(ctx).fV[0]);
+            comp = comp < 0 ? 0 : (comp >= n ? n - 1 : comp);
+            return scalarVal(val.fV[comp]);
+        };
+        return result;
+    }
+
+    Node selected(const Node& node, const Comps& comps, const int n) {
+        Node result;
+        result.fType = {node.fType.fBase, n};
+        const auto eval = node.fEval;
+        result.fEval = [eval, comps, n](Ctx& ctx) {
+            const Val val = eval(ctx);
+            Val sel;
+            for(int i = 0; i < n; i++) sel.fV[i] = val.fV[comps[i]];
+            return sel;
+        };
+        if(node.fRef) {
+            result.fRef = node.fRef;
+            for(int i = 0; i < n; i++) result.fComps[i] = node.fComps[comps[i]];
+            for(int i = 0; i < n; i++) {
+                for(int j = 0; j < i; j++) {
+                    // duplicated components can not be assigned
+                    if(result.fComps[i] == result.fComps[j]) result.fRef = nullptr;
+                }
+            }
+        }
+        return result;
+    }
+
+    Node assign(const Node& lhs, const Node& rhs) {
+        if(!lhs.fRef) error("assignment to a read-only expression");
+        const Node value = convert(rhs, lhs.fType);
+        const auto ref = lhs.fRef;
+        const auto eval = value.fEval;
+        const Comps comps = lhs.fComps;
+        const int n = lhs.fType.fN;
+        Node node;
+        node.fType = lhs.fType;
+        node.fEval = [ref, eval, comps, n](Ctx& ctx) {
+            const Val val = eval(ctx);
+            Val& dst = ref(ctx);
+            for(int i = 0; i < n; i++) dst.fV[comps[i]] = val.fV[i];
+            return val;
+        };
+        return node;
+    }
+
+    //! @brief Implicit conversion of int operands to float
+    void promote(Node& a, Node& b) {
+        if(a.fType.fBase == Base::Int && b.fType.fBase == Base::Float)
+            a.fType.fBase = Base::Float;
+        else if(a.fType.fBase == Base::Float && b.fType.fBase == Base::Int)
+            b.fType.fBase = Base::Float;
+    }
+
+    //! @brief Implicit conversion, ints can be used as floats
+    Node convert(Node node, const Type& type) {
+        if(node.fType == type) return node;
+        if(node.fType.fBase == Base::Int && type.fBase == Base::Float &&
+           node.fType.fN == type.fN) {
+            node.fType = type;
+            return node;
+        }
+        error("can not convert " + typeName(node.fType) +
+              " to " + typeName(type));
+    }
+
+    Node binary(const std::string& op, Node a, Node b) {
+        if(op == "&&" || op == "||" || op == "^^") return logical(op, a, b);
+        if(a.fType.fBase == Base::Sampler || b.fType.fBase == Base::Sampler ||
+           a.fType.fBase == Base::Void || b.fType.fBase == Base::Void)
+            error("invalid operands for '" + op + "'");
+        if(op == "==" || op == "!=") {
+            promote(a, b);
+            if(a.fType != b.fType) error("mismatched types for '" + op + "'");
+            const auto ea = a.fEval;
+            const auto eb = b.fEval;
+            const int n = a.fType.fN;
+            const bool equal = op == "==";
+            Node node;
+            node.fType = {Base::Bool, 1};
+            node.fEval = [ea, eb, n, equal](Ctx& ctx) {
+                const Val va = ea(ctx);
+                const Val vb = eb(ctx);
+                bool same = true;
+                for(int i = 0; i < n; i++) same = same && va.fV[i] == vb.fV[i];
+                return scalarVal(same == equal ? 1 : 0);
+            };
+            return node;
+        }
+        if(!a.fType.numeric() || !b.fType.numeric())
+            error("invalid operands for '" + op + "'");
+        if(op == "<" || op == ">" || op == "<=" || op == ">=") {
+            if(a.fType.fN != 1 || b.fType.fN != 1)
+                error("'" + op + "' requires scalars");
+            const auto ea = a.fEval;
+            const auto eb = b.fEval;
+            Node node;
+            node.fType = {Base::Bool, 1};
+            if(op == "<") node.fEval = [ea, eb](Ctx& ctx) {
+                return scalarVal(ea(ctx).fV[0] < eb(ctx).fV[0] ? 1 : 0);
+            };
+            else if(op == ">") node.fEval = [ea, eb](Ctx& ctx) {
+                return scalarVal(ea(ctx).fV[0] > eb(ctx).fV[0] ? 1 : 0);
+            };
+            else if(op == "<=") node.fEval = [ea, eb](Ctx& ctx) {
+                return scalarVal(ea(ctx).fV[0] <= eb(ctx).fV[0] ? 1 : 0);
+            };
+            else node.fEval = [ea, eb](Ctx& ctx) {
+                return scalarVal(ea(ctx).fV[0] >= eb(ctx).fV[0] ? 1 : 0);
+            };
+            return node;
+        }
+        promote(a, b);
+        const int na = a.fType.fN;
+        const int nb = b.fType.fN;
+        if(na != nb && na != 1 && nb != 1)
+            error("mismatched vector sizes for '" + op + "'");
+        const Base base = a.fType.fBase;
+        const int n = std::max(na, nb);
+        const int sa = na == 1 ? 0 : 1;
+        const int sb = nb == 1 ? 0 : 1;
+        const auto ea = a.fEval;
+        const auto eb = b.fEval;
+        Node node;
+        node.fType = {base, n};
+        if(op == "+") {
+            node.fEval = [ea, eb, n, sa, sb](Ctx& ctx) {
+                const Val va = ea(ctx);
+                const Val vb = eb(ctx);
+                Val r;
+                for(int i = 0; i < n; i++) r.fV[i] = va.fV[i*sa] + vb.fV[i*sb];
+                return r;
+            };
+        } else if(op == "-") {
+            node.fEval = [ea, eb, n, sa, sb](Ctx& ctx) {
+                const Val va = ea(ctx);
+                const Val vb = eb(ctx);
+                Val r;
+                for(int i = 0; i < n; i++) r.fV[i] = va.fV[i*sa] - vb.fV[i*sb];
+                return r;
+            };
+        } else if(op == "*") {
+            node.fEval = [ea, eb, n, sa, sb](Ctx& ctx) {
+                const Val va = ea(ctx);
+                const Val vb = eb(ctx);
+                Val r;
+                for(int i = 0; i < n; i++) r.fV[i] = va.fV[i*sa]*vb.fV[i*sb];
+                return r;
+            };
+        } else if(op == "/" && base == Base::Float) {
+            node.fEval = [ea, eb, n, sa, sb](Ctx& ctx) {
+                const Val va = ea(ctx);
+                const Val vb = eb(ctx);
+                Val r;
+                for(int i = 0; i < n; i++) r.fV[i] = va.fV[i*sa]/vb.fV[i*sb];
+                return r;
+            };
+        } else if(op == "/" || op == "%") {
+            if(base != Base::Int) error("'%' requires integer operands");
+            const bool mod = op == "%";
+            node.fEval = [ea, eb, n, sa, sb, mod](Ctx& ctx) {
+                const Val va = ea(ctx);
+                const Val vb = eb(ctx);
+                Val r;
+                for(int i = 0; i < n; i++) {
+                    const float x = va.fV[i*sa];
+                    const float y = vb.fV[i*sb];
+                    const float div = y == 0 ? 0 : std::trunc(x/y);
+                    r.fV[i] = mod ? x - y*div : div;
+                }
+                return r;
+            };
+        } else error("unsupported operator '" + op + "'");
+        return node;
+    }
+
+    Node logical(const std::string& op, const Node& a, const Node& b) {
+        const Type boolType{Base::Bool, 1};
+        if(a.fType != boolType || b.fType != boolType)
+            error("'" + op + "' requires bool operands");
+        const auto ea = a.fEval;
+        const auto eb = b.fEval;
+        Node node;
+        node.fType = boolType;
+        if(op == "&&") node.fEval = [ea, eb](Ctx& ctx) {
+            return scalarVal(ea(ctx).fV[0] != 0 && eb(ctx).fV[0] != 0 ? 1 : 0);
+        };
+        else if(op == "||") node.fEval = [ea, eb](Ctx& ctx) {
+            return scalarVal(ea(ctx).fV[0] != 0 || eb(ctx).fV[0] != 0 ? 1 : 0);
+        };
+        else node.fEval = [ea, eb](Ctx& ctx) {
+            return scalarVal((ea(ctx).fV[0] != 0) != (eb(ctx).fV[0] != 0) ? 1 : 0);
+        };
+        return node;
+    }
+
+    Node construct(const Type& type, const std::vector<Node>& args) {
+        if(args.empty()) error("constructor without arguments");
+        int nComps = 0;
+        for(const auto& arg : args) {
+            if(arg.fType.fBase == Base::Void || arg.fType.fBase == Base::Sampler)
+                error("invalid constructor argument");
+            nComps += arg.fType.fN;
+        }
+        const bool broadcast = args.size() == 1 && args.front().fType.fN == 1;
+        if(!broadcast && nComps < type.fN)
+            error("not enough data for " + typeName(type) + " constructor");
+        std::vector<Eval> evals;
+        std::vector<int> sizes;
+        for(const auto& arg : args) {
+            evals.push_back(arg.fEval);
+            sizes.push_back(arg.fType.fN);
+        }
+        const Base base = type.fBase;
+        const int n = type.fN;
+        Node node;
+        node.fType = type;
+        node.fEval = [evals, sizes, base, n, broadcast](Ctx& ctx) {
+            Val r;
+            int comp = 0;
+            for(size_t i = 0; i < evals.size() && comp < n; i++) {
+                const Val val = evals[i](ctx);
+                for(int j = 0; j < sizes[i] && comp < n; j++) {
+                    r.fV[comp++] = val.fV[j];
+                }
+            }
+            if(broadcast) for(int i = 1; i < n; i++) r.fV[i] = r.fV[0];
+            for(int i = 0; i < n; i++) {
+                if(base == Base::Int) r.fV[i] = std::trunc(r.fV[i]);
+                else if(base == Base::Bool) r.fV[i] = r.fV[i] != 0 ? 1 : 0;
+            }
+            return r;
+        };
+        return node;
+    }
+
+    Function* findExact(const std::string& name, const std::vector<Type>& params) {
+        for(const auto& function : mProgram->fFunctions) {
+            if(function->fName != name) continue;
+            if(function->fParams == params) return function.get();
+        }
+        return nullptr;
+    }
+
+    Node call(const std::string& name, std::vector<Node> args) {
+        std::vector<Type> types;
+        for(const auto& arg : args) types.push_back(arg.fType);
+        Function* function = findExact(name, types);
+        if(!function) {
+            // ints can be passed as floats
+            for(const auto& candidate : mProgram->fFunctions) {
+                if(candidate->fName != name) continue;
+                if(candidate->fParams.size() != types.size()) continue;
+                bool compatible = true;
+                for(size_t i = 0; i < types.size() && compatible; i++) {
+                    const Type& param = candidate->fParams[i];
+                    compatible = types[i] == param ||
+                                 (types[i].fBase == Base::Int &&
+                                  param.fBase == Base::Float &&
+                                  types[i].fN == param.fN);
+                }
+                if(compatible) {
+                    function = candidate.get();
+                    break;
+                }
+            }
+        }
+        if(!function) {
+            Node node;
+            if(builtin(name, args, node)) return node;
+            error("no matching function '" + name + "'");
+        }
+        if(function == mFunction) error("recursion is not supported");
+        std::vector<Eval> evals;
+        for(size_t i = 0; i < args.size(); i++) {
+            evals.push_back(convert(args[i], function->fParams[i]).fEval);
+        }
+        if(evals.size() > 16) error("too many function parameters");
+        const Function* const func = function;
+        Node node;
+        node.fType = function->fReturn;
+        node.fEval = [func, evals](Ctx& ctx) {
+            std::array<Val, 16> params;
+            const size_t n = evals.size();
+            for(size_t i = 0; i < n; i++) params[i] = evals[i](ctx);
+            auto& frame = ctx.fFrames[func->fId];
+            for(size_t i = 0; i < n; i++) frame[i] = params[i];
+            func->fBody(ctx);
+            if(ctx.fFlow == Flow::returnCall) ctx.fFlow = Flow::none;
+            return ctx.fReturn;
+        };
+        return node;
+    }
+
+    void checkArgs(const std::string& name, const std::vector<Node>& args,
+                   const size_t count) {
+        if(args.size() != count) error("wrong number of arguments for '" + name + "'");
+        for(const auto& arg : args) {
+            if(!arg.fType.numeric() || arg.fType.fN > 4)
+                error("invalid argument for '" + name + "'");
+        }
+    }
+
+    //! @brief Component-wise function, scalar arguments are broadcast
+    template <typename F>
+    Node componentWise(const std::string& name, const std::vector<Node>& args,
+                       const size_t count, const F func,
+                       const bool intOverload = false) {
+        checkArgs(name, args, count);
+        int n = 1;
+        bool allInt = true;
+        for(const auto& arg : args) {
+            if(arg.fType.fN != 1 && n != 1 && arg.fType.fN != n)
+                error("mismatched arguments for '" + name + "'");
+            n = std::max(n, arg.fType.fN);
+            allInt = allInt && arg.fType.fBase == Base::Int;
+        }
+        std::array<Eval, 3> evals;
+        std::array<int, 3> steps = {0, 0, 0};
+        for(size_t i = 0; i < count; i++) {
+            evals[i] = args[i].fEval;
+            steps[i] = args[i].fType.fN == 1 ? 0 : 1;
+        }
+        Node node;
+        node.fType = {intOverload && allInt ? Base::Int : Base::Float, n};
+        node.fEval = [evals, steps, n, func](Ctx& ctx) {
+            std::array<Val, 3> vals;
+            for(int i = 0; i < 3; i++) if(evals[i]) vals[i] = evals[i](ctx);
+            Val r;
+            for(int i = 0; i < n; i++) {
+                r.fV[i] = func(vals[0].fV[i*steps[0]],
+                               vals[1].fV[i*steps[1]],
+                               vals[2].fV[i*steps[2]]);
+            }
+            return r;
+        };
+        return node;
+    }
+
+    //! @brief Function of whole vectors returning a float
+    template <typename F>
+    Node reduce(const std::string& name, const std::vector<Node>& args,
+                const size_t count, const F func) {
+        checkArgs(name, args, count);
+        const int n = args.front().fType.fN;
+        for(const auto& arg : args) {
+            if(arg.fType.fN != n) error("mismatched arguments for '" + name + "'");
+        }
+        const auto ea = args.front().fEval;
+        const auto eb = count > 1 ? args.back().fEval : Eval();
+        Node node;
+        node.fType = {Base::Float, 1};
+        node.fEval = [ea, eb, n, func](Ctx& ctx) {
+            const Val va = ea(ctx);
+            const Val vb = eb ? eb(ctx) : Val();
+            return scalarVal(func(va, vb, n));
+        };
+        return node;
+    }
+
+    bool builtin(const std::string& name, const std::vector<Node>& args, Node& node) {
+        typedef float (*F1)(float);
+        static const std::map<std::string, F1> unary = {
+            {"radians", [](float x) { return x*0.017453292519943295f; }},
+            {"degrees", [](float x) { return x*57.29577951308232f; }},
+            {"sin", [](float x) { return std::sin(x); }},
+            {"cos", [](float x) { return std::cos(x); }},
+            {"tan", [](float x) { return std::tan(x); }},
+            {"asin", [](float x) { return std::asin(x); }},
+            {"acos", [](float x) { return std::acos(x); }},
+            {"exp", [](float x) { return std::exp(x); }},
+            {"log", [](float x) { return std::log(x); }},
+            {"exp2", [](float x) { return std::exp2(x); }},
+            {"log2", [](float x) { return std::log2(x); }},
+            {"sqrt", [](float x) { return std::sqrt(x); }},
+            {"inversesqrt", [](float x) { return 1/std::sqrt(x); }},
+            {"floor", [](float x) { return std::floor(x); }},
+            {"ceil", [](float x) { return std::ceil(x); }},
+            {"trunc", [](float x) { return std::trunc(x); }},
+            {"round", [](float x) { return std::round(x); }},
+            {"roundEven", [](float x) { return std::nearbyint(x); }},
+            {"fract", glslFract}
+        };
+        const auto un = unary.find(name);
+        if(un != unary.end() || (name == "atan" && args.size() == 1)) {
+            const F1 func = name == "atan" ? [](float x) { return std::atan(x); } :
+                                             un->second;
+            node = componentWise(name, args, 1, [func](float x, float, float) {
+                return func(x);
+            });
+            return true;
+        }
+        if(name == "abs" || name == "sign") {
+            const F1 func = name == "abs" ? [](float x) { return std::abs(x); } :
+                                            glslSign;
+            node = componentWise(name, args, 1, [func](float x, float, float) {
+                return func(x);
+            }, true);
+            return true;
+        }
+        if(name == "atan") {
+            node = componentWise(name, args, 2, [](float y, float x, float) {
+                return std::atan2(y, x);
+            });
+            return true;
+        }
+        if(name == "pow") {
+            node = componentWise(name, args, 2, [](float x, float y, float) {
+                return std::pow(x, y);
+            });
+            return true;
+        }
+        if(name == "mod") {
+            node = componentWise(name, args, 2, [](float x, float y, float) {
+                return glslMod(x, y);
+            });
+            return true;
+        }
+        if(name == "min" || name == "max") {
+            const bool min = name == "min";
+            node = componentWise(name, args, 2, [min](float x, float y, float) {
+                return min ? std::min(x, y) : std::max(x, y);
+            }, true);
+            return true;
+        }
+        if(name == "step") {
+            node = componentWise(name, args, 2, [](float edge, float x, float) {
+                return glslStep(edge, x);
+            });
+            return true;
+        }
+        if(name == "clamp") {
+            node = componentWise(name, args, 3, glslClamp, true);
+            return true;
+        }
+        if(name == "mix") {
+            node = componentWise(name, args, 3, glslMix);
+            return true;
+        }
+        if(name == "smoothstep") {
+            node = componentWise(name, args, 3, glslSmoothstep);
+            return true;
+        }
+        if(name == "length") {
+            node = reduce(name, args, 1, [](const Val& a, const Val&, int n) {
+                float sum = 0;
+                for(int i = 0; i < n; i++) sum += a.fV[i]*a.fV[i];
+                return std::sqrt(sum);
+            });
+            return true;
+        }
+        if(name == "distance") {
+            node = reduce(name, args, 2, [](const Val& a, const Val& b, int n) {
+                float sum = 0;
+                for(int i = 0; i < n; i++) {
+                    const float d = a.fV[i] - b.fV[i];
+                    sum += d*d;
+                }
+                return std::sqrt(sum);
+            });
+            return true;
+        }
+        if(name == "dot") {
+            node = reduce(name, args, 2, [](const Val& a, const Val& b, int n) {
+                float sum = 0;
+                for(int i = 0; i < n; i++) sum += a.fV[i]*b.fV[i];
+                return sum;
+            });
+            return true;
+        }
+        if(name == "normalize") {
+            checkArgs(name, args, 1);
+            const auto eval = args.front().fEval;
+            const int n = args.front().fType.fN;
+            node.fType = {Base::Float, n};
+            node.fEval = [eval, n](Ctx& ctx) {
+                Val v = eval(ctx);
+                float sum = 0;
+                for(int i = 0; i < n; i++) sum += v.fV[i]*v.fV[i];
+                const float inv = 1/std::sqrt(sum);
+                for(int i = 0; i < n; i++) v.fV[i] *= inv;
+                return v;
+            };
+            return true;
+        }
+        if(name == "cross") {
+            checkArgs(name, args, 2);
+            for(const auto& arg : args) {
+                if(arg.fType.fN != 3) error("'cross' requires vec3 arguments");
+            }
+            const auto ea = args.front().fEval;
+            const auto eb = args.back().fEval;
+            node.fType = {Base::Float, 3};
+            node.fEval = [ea, eb](Ctx& ctx) {
+                const Val a = ea(ctx);
+                const Val b = eb(ctx);
+                Val r;
+                r.fV[0] = a.fV[1]*b.fV[2] - a.fV[2]*b.fV[1];
+                r.fV[1] = a.fV[2]*b.fV[0] - a.fV[0]*b.fV[2];
+                r.fV[2] = a.fV[0]*b.fV[1] - a.fV[1]*b.fV[0];
+                return r;
+            };
+            return true;
+        }
+        if(name == "texture2D" || name == "texture" ||
+           name == "textureSize" || name == "texelFetch") {
+            const size_t count = name == "texelFetch" ? 3 : 2;
+            if(args.size() != count || args.front().fType.fBase != Base::Sampler)
+                error("invalid arguments for '" + name + "'");
+            const Type& coordType = args[1].fType;
+            if(name == "textureSize") {
+                node.fType = {Base::Int, 2};
+                node.fEval = [](Ctx& ctx) {
+                    Val r;
+                    r.fV[0] = ctx.fSrc->fWidth;
+                    r.fV[1] = ctx.fSrc->fHeight;
+                    return r;
+                };
+                return true;
+            }
+            const auto coord = args[1].fEval;
+            node.fType = {Base::Float, 4};
+            if(name == "texelFetch") {
+                if(coordType != Type{Base::Int, 2})
+                    error("'texelFetch' requires ivec2 coordinates");
+                node.fEval = [coord](Ctx& ctx) {
+                    const Val c = coord(ctx);
+                    return sampleTexel(*ctx.fSrc, static_cast<int>(c.fV[0]),
+                                       static_cast<int>(c.fV[1]));
+                };
+                return true;
+            }
+            if(coordType != Type{Base::Float, 2})
+                error("'" + name + "' requires vec2 coordinates");
+            node.fEval = [coord](Ctx& ctx) {
+                const Val c = coord(ctx);
+                return sampleLinear(*ctx.fSrc, c.fV[0], c.fV[1]);
+            };
+            return true;
+        }
+        return false;
+    }
+
+    const std::vector<Token> mTokens;
+    size_t mPos = 0;
+    std::unique_ptr<Program> mProgram;
+    std::vector<std::map<std::string, Var>> mScopes;
+    Function* mFunction = nullptr;
+    int mLoopDepth = 0;
+    bool mDeclared = false;
+};
+
+}
+
+using namespace CpuShader;
+
+CpuShaderProgram::CpuShaderProgram(std::unique_ptr<Program>&& program) :
+    mProgram(std::move(program)) {}
+
+CpuShaderProgram::~CpuShaderProgram() {}
+
+std::unique_ptr<CpuShaderProgram> CpuShaderProgram::sCompile(
+        const std::string& source) {
+    Compiler compiler(source);
+    auto program = compiler.compile();
+    return std::unique_ptr<CpuShaderProgram>(
+                new CpuShaderProgram(std::move(program)));
+}
+
+int CpuShaderProgram::uniformIndex(const std::string& name) const {
+    const auto& uniforms = mProgram->fUniforms;
+    for(size_t i = 0; i < uniforms.size(); i++) {
+        if(uniforms[i] == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+int CpuShaderProgram::uniformCount() const {
+    return static_cast<int>(mProgram->fUniforms.size());
+}
+
+static unsigned char toByte(const float value) {
+    const float clamped = value < 0 ? 0 : (value > 1 ? 1 : value);
+    return static_cast<unsigned char>(clamped*255 + 0.5f);
+}
+
+void CpuShaderProgram::process(const Uniforms& uniforms, const Image& src,
+                               const Image& dst, const int left,
+                               const int top) const {
+    const auto& program = *mProgram;
+    if(uniforms.size() < program.fUniforms.size())
+        RuntimeThrow("Missing uniform values");
+    Ctx ctx;
+    ctx.fUniforms = &uniforms;
+    ctx.fSrc = &src;
+    ctx.fGlobals.resize(program.fGlobalSlots);
+    ctx.fFrames.resize(program.fFunctions.size());
+    for(const auto& function : program.fFunctions) {
+        ctx.fFrames[function->fId].resize(function->fSlots);
+    }
+    const auto& main = *program.fMain;
+    const float offset = program.fFragCoordOffset;
+    const float invWidth = 1.f/src.fWidth;
+    const float invHeight = 1.f/src.fHeight;
+    ctx.fFragCoord.fV[2] = 0.5f;
+    ctx.fFragCoord.fV[3] = 1;
+    for(int y = 0; y < dst.fHeight; y++) {
+        const int texY = top + y;
+        // texture rows are uploaded top first and end up at the bottom
+        ctx.fTexCoord.fV[1] = (texY + 0.5f)*invHeight;
+        ctx.fFragCoord.fV[1] = program.fFragCoordUpperLeft ?
+                    src.fHeight - texY - 1 + offset : texY + offset;
+        unsigned char* dstPix = dst.fPixels + y*dst.fRowBytes;
+        for(int x = 0; x < dst.fWidth; x++, dstPix += 4) {
+            const int texX = left + x;
+            ctx.fTexCoord.fV[0] = (texX + 0.5f)*invWidth;
+            ctx.fFragCoord.fV[0] = texX + offset;
+            for(auto& global : ctx.fGlobals) global = Val();
+            ctx.fFlow = Flow::none;
+            for(const auto& init : program.fGlobalInit) init(ctx);
+            main.fBody(ctx);
+            const Val color = ctx.fFlow == Flow::discard ?
+                        Val() : ctx.fGlobals[program.fOutput];
+            dstPix[dst.fBGRA ? 2 : 0] = toByte(color.fV[0]);
+            dstPix[1] = toByte(color.fV[1]);
+            dstPix[dst.fBGRA ? 0 : 2] = toByte(color.fV[2]);
+            dstPix[3] = toByte(color.fV[3]);
+        }
+    }
+}
@@ -0,0 +1,69 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CPUSHADERPROGRAM_H
+#define CPUSHADERPROGRAM_H
+
+#include "../core_global.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace CpuShader { struct Program; }
+
+//! @brief Fragment shader translated for execution on the cpu.
+//! Supports the subset of GLSL used by shader effects: scalar and vector
+//! types, user functions, control flow, math built-ins and sampling
+//! of the source texture.
+class CORE_EXPORT CpuShaderProgram {
+public:
+    //! @brief Value of a uniform, ints and bools are stored as floats
+    struct Value {
+        float fV[4] = {0, 0, 0, 0};
+    };
+    typedef std::vector<Value> Uniforms;
+
+    //! @brief 8-bit premultiplied RGBA or BGRA pixels
+    struct Image {
+        unsigned char* fPixels;
+        int fWidth;
+        int fHeight;
+        size_t fRowBytes;
+        bool fBGRA;
+    };
+
+    ~CpuShaderProgram();
+
+    //! @brief Throws if the source uses features without cpu support
+    static std::unique_ptr<CpuShaderProgram> sCompile(const std::string& source);
+
+    //! @brief Returns the index of the uniform in Uniforms,
+    //! -1 if it is not declared
+    int uniformIndex(const std::string& name) const;
+    int uniformCount() const;
+
+    //! @brief Runs the shader for every pixel of dst,
+    //! dst pixel {0, 0} corresponds to src pixel {left, top}
+    void process(const Uniforms& uniforms, const Image& src,
+                 const Image& dst, const int left, const int top) const;
+private:
+    CpuShaderProgram(std::unique_ptr<CpuShader::Program>&& program);
+
+    const std::unique_ptr<CpuShader::Program> mProgram;
+};
+
+#endif // CPUSHADERPROGRAM_H
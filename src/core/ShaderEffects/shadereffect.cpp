@@ -22,7 +22,9 @@ ShaderEffect::ShaderEffect(const QString& name,
                            const ShaderEffectCreator * const creator,
                            const ShaderEffectProgram * const program,
                            const QList<stdsptr<ShaderPropertyCreator>> &props) :
-    RasterEffect(name, HardwareSupport::gpuOnly, false,
+    RasterEffect(name, program->fCpuProgram ? HardwareSupport::gpuPreffered :
+                                              HardwareSupport::gpuOnly,
+                 program->fCpuProgram != nullptr,
                  RasterEffectType::CUSTOM_SHADER),
     mProgram(program), mCreator(creator) {
     for(const auto& propC : props)
@@ -47,25 +49,34 @@ stdsptr<RasterEffectCaller> ShaderEffect::getEffectCaller(
     takeJSEngine(engineUPtr);
     ShaderEffectJS& engine = *engineUPtr;
     const auto effect = enve::make_shared<ShaderEffectCaller>(
-                            std::move(engineUPtr), *mProgram);
+                            std::move(engineUPtr), *mProgram,
+                            instanceHwSupport());
 
+    const bool cpu = mProgram->fCpuProgram != nullptr;
     QJSValueList setterArgs;
     UniformSpecifiers& uniSpecs = effect->mUniformSpecifiers;
+    CpuUniformSpecifiers& cpuUniSpecs = effect->mCpuUniformSpecifiers;
     const int argsCount = mProgram->fPropUniLocs.count();
     for(int i = 0; i < argsCount; i++) {
         const GLint loc = mProgram->fPropUniLocs.at(i);
+        const int cpuLoc = cpu ? mProgram->fPropCpuLocs.at(i) : -1;
         const auto prop = ca_getChildAt(i);
         const auto& uniformC = mProgram->fPropUniCreators.at(i);
-        uniformC->create(engine, loc, prop, relFrame,
+        uniformC->create(engine, loc, cpuLoc, prop, relFrame,
                          resolution, influence,
-                         setterArgs, uniSpecs);
+                         setterArgs, uniSpecs, cpuUniSpecs);
     }
     engine.setValues(setterArgs);
     const int valsCount = mProgram->fValueHandlers.count();
     for(int i = 0; i < valsCount; i++) {
         const GLint loc = mProgram->fValueLocs.at(i);
         const auto& value = mProgram->fValueHandlers.at(i);
-        uniSpecs << value->create(loc, &engine.getGlValueGetter(i));
+        auto& getter = engine.getGlValueGetter(i);
+        uniSpecs << value->create(loc, &getter);
+        if(cpu) {
+            const int cpuLoc = mProgram->fValueCpuLocs.at(i);
+            cpuUniSpecs << value->createCpu(cpuLoc, &getter);
+        }
     }
     return effect;
 }
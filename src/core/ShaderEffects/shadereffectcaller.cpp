@@ -19,9 +19,13 @@
 #include "shadereffectprogram.h"
 
 ShaderEffectCaller::ShaderEffectCaller(std::unique_ptr<ShaderEffectJS>&& engine,
-                                       const ShaderEffectProgram &program) :
-    RasterEffectCaller(HardwareSupport::gpuOnly, false, QMargins()),
-    mEngine(std::move(engine)), mProgramId(program.fId), mProgram(program) {
+                                       const ShaderEffectProgram &program,
+                                       const HardwareSupport hwSupport) :
+    RasterEffectCaller(program.fCpuProgram ? hwSupport :
+                                             HardwareSupport::gpuOnly,
+                       false, QMargins()),
+    mEngine(std::move(engine)), mProgramId(program.fId), mProgram(program),
+    mCpuProgram(program.fCpuProgram) {
     Q_ASSERT(mEngine.get());
 }
 
@@ -48,9 +52,32 @@ void ShaderEffectCaller::processGpu(QGL33 * const gl,
     renderTools.swapTextures();
 }
 
+void ShaderEffectCaller::processCpu(CpuRenderTools &renderTools,
+                                    const CpuRenderData &data) {
+    Q_ASSERT(mCpuProgram);
+    const auto toImage = [](const SkBitmap& btmp) {
+        CpuShaderProgram::Image img;
+        img.fPixels = static_cast<unsigned char*>(btmp.getPixels());
+        img.fWidth = btmp.width();
+        img.fHeight = btmp.height();
+        img.fRowBytes = btmp.rowBytes();
+        img.fBGRA = btmp.colorType() == kBGRA_8888_SkColorType;
+        return img;
+    };
+    const auto src = toImage(renderTools.fSrcBtmp);
+    const auto dst = toImage(renderTools.fDstBtmp);
+    const auto& texTile = data.fTexTile;
+    mCpuProgram->process(mCpuUniforms, src, dst,
+                         texTile.left(), texTile.top());
+}
+
 QMargins ShaderEffectCaller::getMargin(const SkIRect &srcRect) {
     mEngine->setSceneRect(srcRect);
     mEngine->evaluate();
+    if(mCpuProgram && hardwareSupport() != HardwareSupport::gpuOnly) {
+        mCpuUniforms.resize(static_cast<size_t>(mCpuProgram->uniformCount()));
+        for(const auto& uni : mCpuUniformSpecifiers) uni(mCpuUniforms);
+    }
     const auto jsVal = mEngine->getMarginValue();
     if(jsVal.isNumber()) {
         return QMargins() + qCeil(jsVal.toNumber());
@@ -25,16 +25,20 @@ class CORE_EXPORT ShaderEffectCaller : public RasterEffectCaller {
     e_OBJECT
 public:
     ShaderEffectCaller(std::unique_ptr<ShaderEffectJS>&& engine,
-                       const ShaderEffectProgram& program);
+                       const ShaderEffectProgram& program,
+                       const HardwareSupport hwSupport);
     ~ShaderEffectCaller();
 
     void processGpu(QGL33 * const gl,
                     GpuRenderTools& renderTools);
+    void processCpu(CpuRenderTools& renderTools,
+                    const CpuRenderData& data);
 
     ShaderEffectJS& getJSEngine()
     { return *mEngine; }
 
     UniformSpecifiers mUniformSpecifiers;
+    CpuUniformSpecifiers mCpuUniformSpecifiers;
 protected:
     QMargins getMargin(const SkIRect &srcRect);
 private:
@@ -43,6 +47,10 @@ private:
     std::unique_ptr<ShaderEffectJS> mEngine;
     const GLuint mProgramId;
     const ShaderEffectProgram &mProgram;
+    const std::shared_ptr<CpuShaderProgram> mCpuProgram;
+    //! @brief Evaluated together with the margin,
+    //! the JS engine is not used from the cpu threads
+    CpuShaderProgram::Uniforms mCpuUniforms;
 };
 
 
@@ -68,6 +68,44 @@ void ShaderEffectProgram::reloadFragmentShader(
     fPropUniLocs = propUniLocs;
     fValueLocs = valueLocs;
     fTexLocation = texLocation;
+
+    reloadCpuProgram(fragPath);
+}
+
+void ShaderEffectProgram::reloadCpuProgram(const QString &fragPath) {
+    fCpuProgram.reset();
+    fPropCpuLocs.clear();
+    fValueCpuLocs.clear();
+
+    QFile file(fragPath);
+    if(!file.open(QIODevice::ReadOnly | QIODevice::Text)) return;
+    std::shared_ptr<CpuShaderProgram> cpuProgram;
+    try {
+        cpuProgram = CpuShaderProgram::sCompile(file.readAll().toStdString());
+    } catch(const std::exception& e) {
+        qDebug() << "'" + fragPath + "' will only run on the GPU:";
+        qDebug() << gAllTextFromException(e);
+        return;
+    }
+
+    QList<int> propCpuLocs;
+    for(const auto& propC : fProperties) {
+        if(propC->fGLValue) {
+            const int loc = cpuProgram->uniformIndex(propC->fName.toStdString());
+            if(loc < 0) return;
+            propCpuLocs.append(loc);
+        } else propCpuLocs.append(-1);
+    }
+    QList<int> valueCpuLocs;
+    for(const auto& value : fValueHandlers) {
+        const int loc = cpuProgram->uniformIndex(value->fName.toStdString());
+        if(loc < 0) return;
+        valueCpuLocs.append(loc);
+    }
+
+    fCpuProgram = cpuProgram;
+    fPropCpuLocs = propCpuLocs;
+    fValueCpuLocs = valueCpuLocs;
 }
 
 std::unique_ptr<ShaderEffectProgram>
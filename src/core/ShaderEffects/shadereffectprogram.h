@@ -19,6 +19,7 @@
 #include "uniformspecifiercreator.h"
 #include "shadervaluehandler.h"
 #include "shadereffectjs.h"
+#include "cpushaderprogram.h"
 
 typedef QList<stdsptr<UniformSpecifierCreator>> UniformSpecifierCreators;
 struct CORE_EXPORT ShaderEffectProgram {
@@ -33,11 +34,17 @@ struct CORE_EXPORT ShaderEffectProgram {
     UniformSpecifierCreators fPropUniCreators;
     QList<stdsptr<ShaderValueHandler>> fValueHandlers;
     QList<GLint> fValueLocs;
+    //! @brief Translation of the fragment shader used for cpu rendering,
+    //! null if the shader uses unsupported features
+    std::shared_ptr<CpuShaderProgram> fCpuProgram;
+    QList<int> fPropCpuLocs;
+    QList<int> fValueCpuLocs;
     std::shared_ptr<ShaderEffectJS::Blueprint> fJSBlueprint;
     mutable std::vector<std::unique_ptr<ShaderEffectJS>> fEngines;
     const QList<stdsptr<ShaderPropertyCreator>> fProperties;
 
     void reloadFragmentShader(QGL33 * const gl, const QString &fragPath);
+    void reloadCpuProgram(const QString &fragPath);
 
     static std::unique_ptr<ShaderEffectProgram> sCreateProgram(
             QGL33 * const gl, const QString &fragPath,
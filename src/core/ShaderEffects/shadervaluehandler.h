@@ -20,8 +20,10 @@
 
 #include "glhelpers.h"
 #include "smartPointers/ememory.h"
+#include "cpushaderprogram.h"
 
 typedef std::function<void(QGL33 * const)> UniformSpecifier;
+typedef std::function<void(CpuShaderProgram::Uniforms&)> CpuUniformSpecifier;
 
 enum class GLValueType {
     Float, Vec2, Vec3, Vec4,
@@ -35,6 +37,7 @@ public:
                        const QString& script);
 
     UniformSpecifier create(const GLint loc, QJSValue* getter) const;
+    CpuUniformSpecifier createCpu(const int loc, QJSValue* getter) const;
 
     const QString fName;
     const QString fScript;
@@ -21,12 +21,14 @@
 void qrealAnimatorCreate(
         const bool glValue,
         const GLint loc,
+        const int cpuLoc,
         Property * const property,
         const qreal relFrame,
         const qreal resolution,
         const qreal influence,
         QJSValueList& setterArgs,
-        UniformSpecifiers& uniSpec) {
+        UniformSpecifiers& uniSpec,
+        CpuUniformSpecifiers& cpuUniSpec) {
     const auto anim = static_cast<QrealAnimator*>(property);
     const qreal val = anim->getEffectiveValue(relFrame)*resolution*influence;
     const QString propName = anim->prp_getName();
@@ -34,6 +36,11 @@ void qrealAnimatorCreate(
     setterArgs << val;
 
     if(!glValue) return;
+    if(cpuLoc >= 0) {
+        cpuUniSpec << [cpuLoc, val](CpuShaderProgram::Uniforms& unis) {
+            unis[cpuLoc].fV[0] = static_cast<float>(val);
+        };
+    }
     Q_ASSERT(loc >= 0);
     uniSpec << [loc, val, valScript](QGL33 * const gl) {
         gl->glUniform1f(loc, static_cast<GLfloat>(val));
@@ -43,18 +50,25 @@ void qrealAnimatorCreate(
 void intAnimatorCreate(
         const bool glValue,
         const GLint loc,
+        const int cpuLoc,
         Property * const property,
         const qreal relFrame,
         const qreal resolution,
         const qreal influence,
         QJSValueList& setterArgs,
-        UniformSpecifiers& uniSpec) {
+        UniformSpecifiers& uniSpec,
+        CpuUniformSpecifiers& cpuUniSpec) {
     const auto anim = static_cast<IntAnimator*>(property);
     const int val = qRound(anim->getEffectiveIntValue(relFrame)*resolution*influence);
     const QString valScript = anim->prp_getName() + " = " + QString::number(val);
     setterArgs << val;
 
     if(!glValue) return;
+    if(cpuLoc >= 0) {
+        cpuUniSpec << [cpuLoc, val](CpuShaderProgram::Uniforms& unis) {
+            unis[cpuLoc].fV[0] = static_cast<float>(val);
+        };
+    }
     Q_ASSERT(loc >= 0);
     uniSpec << [loc, val, valScript](QGL33 * const gl) {
         gl->glUniform1i(loc, val);
@@ -70,18 +84,26 @@ void qPointFAnimatorCreate(
         ShaderEffectJS &engine,
         const bool glValue,
         const GLint loc,
+        const int cpuLoc,
         Property * const property,
         const qreal relFrame,
         const qreal resolution,
         const qreal influence,
         QJSValueList& setterArgs,
-        UniformSpecifiers& uniSpec) {
+        UniformSpecifiers& uniSpec,
+        CpuUniformSpecifiers& cpuUniSpec) {
     const auto anim = static_cast<QPointFAnimator*>(property);
     const QPointF val = anim->getEffectiveValue(relFrame)*resolution*influence;
     const QString valScript = vec2ValScript(anim->prp_getName(), val);
     setterArgs << engine.toValue(val);
 
     if(!glValue) return;
+    if(cpuLoc >= 0) {
+        cpuUniSpec << [cpuLoc, val](CpuShaderProgram::Uniforms& unis) {
+            unis[cpuLoc].fV[0] = static_cast<float>(val.x());
+            unis[cpuLoc].fV[1] = static_cast<float>(val.y());
+        };
+    }
     Q_ASSERT(loc >= 0);
     uniSpec << [loc, val, valScript](QGL33 * const gl) {
         gl->glUniform2f(loc, val.x(), val.y());
@@ -99,16 +121,26 @@ void colorAnimatorCreate(
         ShaderEffectJS &engine,
         const bool glValue,
         const GLint loc,
+        const int cpuLoc,
         Property * const property,
         const qreal relFrame,
         QJSValueList& setterArgs,
-        UniformSpecifiers& uniSpec) {
+        UniformSpecifiers& uniSpec,
+        CpuUniformSpecifiers& cpuUniSpec) {
     const auto anim = static_cast<ColorAnimator*>(property);
     const QColor val = anim->getColor(relFrame);
     const QString valScript = colorValScript(anim->prp_getName(), val);
     setterArgs << engine.toValue(val);
 
     if(!glValue) return;
+    if(cpuLoc >= 0) {
+        cpuUniSpec << [cpuLoc, val](CpuShaderProgram::Uniforms& unis) {
+            unis[cpuLoc].fV[0] = static_cast<float>(val.redF());
+            unis[cpuLoc].fV[1] = static_cast<float>(val.greenF());
+            unis[cpuLoc].fV[2] = static_cast<float>(val.blueF());
+            unis[cpuLoc].fV[3] = static_cast<float>(val.alphaF());
+        };
+    }
     Q_ASSERT(loc >= 0);
     uniSpec << [loc, val, valScript](QGL33 * const gl) {
         gl->glUniform4f(loc, val.redF(), val.greenF(), val.blueF(),
@@ -118,31 +150,33 @@ void colorAnimatorCreate(
 
 void UniformSpecifierCreator::create(ShaderEffectJS &engine,
                                      const GLint loc,
+                                     const int cpuLoc,
                                      Property * const property,
                                      const qreal relFrame,
                                      const qreal resolution,
                                      const qreal influence,
                                      QJSValueList& setterArgs,
-                                     UniformSpecifiers& uniSpec) const {
+                                     UniformSpecifiers& uniSpec,
+                                     CpuUniformSpecifiers& cpuUniSpec) const {
     switch(mType) {
     case ShaderPropertyType::floatProperty:
-        return qrealAnimatorCreate(fGLValue, loc, property, relFrame,
+        return qrealAnimatorCreate(fGLValue, loc, cpuLoc, property, relFrame,
                                    mResolutionScaled ? resolution : 1,
                                    mInfluenceScaled ? influence : 1,
-                                   setterArgs, uniSpec);
+                                   setterArgs, uniSpec, cpuUniSpec);
     case ShaderPropertyType::intProperty:
-        return intAnimatorCreate(fGLValue, loc, property, relFrame,
+        return intAnimatorCreate(fGLValue, loc, cpuLoc, property, relFrame,
                                  mResolutionScaled ? resolution : 1,
                                  mInfluenceScaled ? influence : 1,
-                                 setterArgs, uniSpec);
+                                 setterArgs, uniSpec, cpuUniSpec);
     case ShaderPropertyType::vec2Property:
-        return qPointFAnimatorCreate(engine, fGLValue, loc, property, relFrame,
+        return qPointFAnimatorCreate(engine, fGLValue, loc, cpuLoc, property, relFrame,
                                      mResolutionScaled ? resolution : 1,
                                      mInfluenceScaled ? influence : 1,
-                                     setterArgs, uniSpec);
+                                     setterArgs, uniSpec, cpuUniSpec);
     case ShaderPropertyType::colorProperty:
-        return colorAnimatorCreate(engine, fGLValue, loc, property, relFrame,
-                                   setterArgs, uniSpec);
+        return colorAnimatorCreate(engine, fGLValue, loc, cpuLoc, property, relFrame,
+                                   setterArgs, uniSpec, cpuUniSpec);
     default: RuntimeThrow("Unsupported type");
     }
 }
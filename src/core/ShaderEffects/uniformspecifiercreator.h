@@ -24,6 +24,7 @@
 #include "PropertyCreators/qpointfanimatorcreator.h"
 #include "PropertyCreators/coloranimatorcreator.h"
 #include "glhelpers.h"
+#include "cpushaderprogram.h"
 
 class ShaderEffectJS;
 
@@ -37,6 +38,8 @@ enum class ShaderPropertyType {
 
 typedef std::function<void(QGL33 * const)> UniformSpecifier;
 typedef QList<UniformSpecifier> UniformSpecifiers;
+typedef std::function<void(CpuShaderProgram::Uniforms&)> CpuUniformSpecifier;
+typedef QList<CpuUniformSpecifier> CpuUniformSpecifiers;
 struct CORE_EXPORT UniformSpecifierCreator : public StdSelfRef {
     UniformSpecifierCreator(const ShaderPropertyType type,
                             const bool glValue,
@@ -48,12 +51,14 @@ struct CORE_EXPORT UniformSpecifierCreator : public StdSelfRef {
 
     void create(ShaderEffectJS &engine,
                 const GLint loc,
+                const int cpuLoc,
                 Property * const property,
                 const qreal relFrame,
                 const qreal resolution,
                 const qreal influence,
                 QJSValueList& setterArgs,
-                UniformSpecifiers& uniSpec) const;
+                UniformSpecifiers& uniSpec,
+                CpuUniformSpecifiers& cpuUniSpec) const;
 
     const ShaderPropertyType mType;
     const bool fGLValue;
@@ -15,6 +15,45 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "etask.h"
+#include "Private/Tasks/taskscheduler.h"
+
+#include <chrono>
+
+qint64 eTask::sDeadlineIn(const int msecs) {
+    using namespace std::chrono;
+    const auto now = steady_clock::now().time_since_epoch();
+    return duration_cast<milliseconds>(now).count() + msecs;
+}
+
+bool eTask::moreUrgentThan(const eTask& other) const {
+    if(mPriority != other.mPriority) return mPriority < other.mPriority;
+    if(mDeadline == other.mDeadline) return false;
+    if(mDeadline < 0) return false;
+    if(other.mDeadline < 0) return true;
+    return mDeadline < other.mDeadline;
+}
+
+void eTask::inheritUrgency(const eTask& waiting) {
+    if(mState == eTaskState::finished) return;
+    bool raised = false;
+    // tasks not qued yet would get their priority from the scheduler
+    if(!mPrioritySet || waiting.mPriority < mPriority) {
+        raised = mPriority != waiting.mPriority;
+        setPriority(waiting.mPriority);
+    }
+    if(mPriority == waiting.mPriority && waiting.mDeadline >= 0 &&
+       (mDeadline < 0 || waiting.mDeadline < mDeadline)) {
+        mDeadline = waiting.mDeadline;
+        raised = true;
+    }
+    if(raised) passUrgencyToDependencies();
+}
+
+void eTask::passUrgencyToDependencies() {
+    for(const auto& dependency : mDependencies) {
+        if(dependency) dependency->inheritUrgency(*this);
+    }
+}
 
 bool eTask::queTask() {
     mState = eTaskState::qued;
@@ -27,3 +66,13 @@ void eTask::aboutToProcess(const Hardware hw) {
     mState = eTaskState::processing;
     beforeProcessing(hw);
 }
+
+bool eTask::claimForProcessing() {
+    auto expected = eTaskState::qued;
+    return mState.compare_exchange_strong(expected, eTaskState::processing);
+}
+
+void eTask::dependenciesFinished() {
+    const auto scheduler = TaskScheduler::instance();
+    if(scheduler) scheduler->dependenciesFinished(this);
+}
@@ -42,9 +42,51 @@ public:
 
     virtual bool nextStep() { return false; }
 
+    //! @brief Dependent tasks can be released by the worker thread
+    //! right after processing, before afterProcessing is called.
+    //! Return true only if afterProcessing does not affect dependents.
+    virtual bool releasesDependentsOnWorker() const { return false; }
+    //! @brief The task can be started by the worker thread that finished
+    //! its last dependency, beforeProcessing has to be thread-safe
+    //! and must not finish the task.
+    virtual bool startableOnWorker() const { return false; }
+
+    //! @brief Tasks without priority get one from the scheduler when qued
+    void setPriority(const eTaskPriority priority) {
+        mPriority = priority;
+        mPrioritySet = true;
+    }
+    eTaskPriority priority() const { return mPriority; }
+    bool hasPriority() const { return mPrioritySet; }
+
+    //! @brief Deadline from sDeadlineIn, orders tasks of the same priority
+    void setDeadline(const qint64 deadline) { mDeadline = deadline; }
+    qint64 deadline() const { return mDeadline; }
+    //! @brief Returns deadline msecs milliseconds from now
+    static qint64 sDeadlineIn(const int msecs);
+
+    bool moreUrgentThan(const eTask& other) const;
+
+    //! @brief Raises the priority and the deadline to the ones of a more
+    //! urgent task waiting for this one, passes them on to own dependencies
+    void inheritUrgency(const eTask& waiting);
+
     bool queTask();
 
+    //! @brief Atomically changes the state from qued to processing,
+    //! returns false if the task was canceled in the meantime.
+    bool claimForProcessing();
+
     void aboutToProcess(const Hardware hw);
+private:
+    void dependenciesFinished();
+    //! @brief Called once the urgency is known, when the task is qued
+    void passUrgencyToDependencies();
+
+    bool mPrioritySet = false;
+    eTaskPriority mPriority = eTaskPriority::interactive;
+    qint64 mDeadline = -1;
+    QList<stdptr<eTask>> mDependencies;
 };
 
 Q_DECLARE_METATYPE(stdsptr<eTask>);
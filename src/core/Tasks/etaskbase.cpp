@@ -52,9 +52,16 @@ void eTaskBase::addDependent(eTask * const task) {
     } else if(mState == eTaskState::canceled) {
         task->cancel();
     } else {
+        std::lock_guard<std::mutex> lock(mDependentMutex);
+        if(mDependentReleased) return;
         if(mDependent.contains(task)) return;
         mDependent << task;
         task->incDependencies();
+        // dependencies inherit the urgency of the tasks waiting for them
+        if(const auto self = dynamic_cast<eTask*>(this)) {
+            task->mDependencies << self;
+            if(task->isQued()) self->inheritUrgency(*task);
+        }
     }
 }
 
@@ -67,20 +74,27 @@ void eTaskBase::addDependent(const Dependent &func) {
 }
 
 void eTaskBase::cancel() {
-    if(mState == eTaskState::processing) {
-        mCancel = true;
-        return;
-    }
-    mState = eTaskState::canceled;
+    // the state can be changed by a worker starting this task
+    auto state = mState.load();
+    do {
+        if(state == eTaskState::processing) {
+            mCancel = true;
+            return;
+        }
+    } while(!mState.compare_exchange_weak(state, eTaskState::canceled));
     cancelDependent();
     afterCanceled();
 }
 
 void eTaskBase::moveDependent(eTaskBase* const to) {
-    for(const auto& dependent : mDependent) {
-        to->mDependent << dependent;
+    {
+        std::lock_guard<std::mutex> lock(mDependentMutex);
+        std::lock_guard<std::mutex> toLock(to->mDependentMutex);
+        for(const auto& dependent : mDependent) {
+            to->mDependent << dependent;
+        }
+        mDependent.clear();
     }
-    mDependent.clear();
     for(const auto& dependent : mDependentF) {
         to->mDependentF << dependent;
     }
@@ -101,11 +115,21 @@ std::exception_ptr eTaskBase::takeException() {
     return exc;
 }
 
-void eTaskBase::tellDependentThatFinished() {
-    for(const auto& dependent : mDependent) {
-        if(dependent) dependent->decDependencies();
+void eTaskBase::releaseDependent() {
+    QList<stdptr<eTask>> dependent;
+    {
+        std::lock_guard<std::mutex> lock(mDependentMutex);
+        if(mDependentReleased) return;
+        mDependentReleased = true;
+        std::swap(dependent, mDependent);
     }
-    mDependent.clear();
+    for(const auto& task : dependent) {
+        if(task && task->decDependencies()) task->dependenciesFinished();
+    }
+}
+
+void eTaskBase::tellDependentThatFinished() {
+    releaseDependent();
     for(const auto& dependent : mDependentF) {
         if(dependent.fFinished) dependent.fFinished();
     }
@@ -113,10 +137,14 @@ void eTaskBase::tellDependentThatFinished() {
 }
 
 void eTaskBase::cancelDependent() {
-    for(const auto& dependent : mDependent) {
-        if(dependent) dependent->cancel();
+    QList<stdptr<eTask>> dependent;
+    {
+        std::lock_guard<std::mutex> lock(mDependentMutex);
+        std::swap(dependent, mDependent);
+    }
+    for(const auto& task : dependent) {
+        if(task) task->cancel();
     }
-    mDependent.clear();
     for(const auto& dependent : mDependentF) {
         if(dependent.fCanceled) dependent.fCanceled();
     }
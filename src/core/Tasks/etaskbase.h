@@ -19,6 +19,11 @@
 
 #include "../smartPointers/ememory.h"
 
+#include <QAtomicInt>
+
+#include <mutex>
+#include <atomic>
+
 enum class eTaskState {
     created,
     qued,
@@ -28,6 +33,20 @@ enum class eTaskState {
     waiting
 };
 
+//! @brief Classes of work, ordered from the most urgent
+enum class eTaskPriority : short {
+    //! @brief Current frame under the playhead
+    interactive,
+    //! @brief Frames rendered ahead for playback
+    lookahead,
+    //! @brief Frames rendered for output
+    output,
+    //! @brief Disk access not needed to display anything
+    backgroundIo,
+    //! @brief Cleanup
+    housekeeping
+};
+
 class eTask;
 
 class CORE_EXPORT eTaskBase {
@@ -61,24 +80,31 @@ public:
     bool isActive() { return mState != eTaskState::created &&
                              mState != eTaskState::finished; }
 
-    bool readyToBeProcessed() { return mNDependancies == 0; }
+    bool readyToBeProcessed() { return mNDependancies.load() == 0; }
 
     bool waitingToCancel() const { return mCancel; }
     void cancel();
+
+    //! @brief Decrements dependency counters of dependent tasks,
+    //! can be called from the worker thread that processed this task.
+    void releaseDependent();
 protected:
-    eTaskState mState = eTaskState::created;
+    std::atomic<eTaskState> mState{eTaskState::created};
 
     void moveDependent(eTaskBase* const to);
 private:
-    void decDependencies() { mNDependancies--; }
-    void incDependencies() { mNDependancies++; }
+    //! @brief Returns true if it was the last dependency
+    bool decDependencies() { return !mNDependancies.deref(); }
+    void incDependencies() { mNDependancies.ref(); }
 
     void tellDependentThatFinished();
     void cancelDependent();
 
-    bool mCancel = false;
-    int mNDependancies = 0;
+    std::atomic<bool> mCancel{false};
+    QAtomicInt mNDependancies = 0;
     QList<Dependent> mDependentF;
+    std::mutex mDependentMutex;
+    bool mDependentReleased = false;
     QList<stdptr<eTask>> mDependent;
     std::exception_ptr mUpdateException;
 };
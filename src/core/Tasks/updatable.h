@@ -90,7 +90,9 @@ template <typename T>
 class CORE_EXPORT SPtrDisposer : public eCpuTask {
     e_OBJECT
 protected:
-    SPtrDisposer(const T& ptr) : mPtr(ptr) {}
+    SPtrDisposer(const T& ptr) : mPtr(ptr) {
+        setPriority(eTaskPriority::housekeeping);
+    }
 public:
     void beforeProcessing(const Hardware) final {}
     void process() final { mPtr.reset(); }
@@ -33,6 +33,9 @@
 #include "Boxes/internallinkcanvas.h"
 #include "pointtypemenu.h"
 #include "Animators/transformanimator.h"
+#include "Animators/qrealanimator.h"
+#include "CacheHandlers/cachecontainer.h"
+#include "memorydatahandler.h"
 #include "glhelpers.h"
 #include "Private/document.h"
 #include "svgexporter.h"
@@ -423,6 +426,61 @@ void Canvas::setOutputRendering(const bool bT) {
     mRenderingOutput = bT;
 }
 
+//! @brief Lets the memory handler drop baked curves under memory pressure,
+//! animators evaluate their keys again afterwards
+class BakedCurvesCache : public CacheContainer {
+    e_OBJECT
+protected:
+    BakedCurvesCache(Canvas* const scene) : mScene(scene) {}
+public:
+    int getByteCount() override {
+        return mScene->bakedAnimationCurvesBytes();
+    }
+
+    void updateUse() { updateInMemoryManagment(); }
+    void stopUse() { removeFromMemoryManagment(); }
+protected:
+    void noDataLeft_k() override {
+        mScene->clearBakedAnimationCurves();
+    }
+private:
+    Canvas* const mScene;
+};
+
+void Canvas::bakeAnimationCurves(const FrameRange& absRange,
+                                 const int samplesPerFrame) {
+    clearBakedAnimationCurves();
+    // only the sample grids are set up here,
+    // values are stored as the render evaluates frames
+    ca_execOnDescendants([this, &absRange, samplesPerFrame](Property* prop) {
+        if(const auto qa = enve_cast<QrealAnimator*>(prop)) {
+            const auto relRange = qa->prp_absRangeToRelRange(absRange);
+            if(qa->bakeCurve(relRange, samplesPerFrame))
+                mBakedAnimators << qa;
+        }
+    });
+    if(mBakedAnimators.isEmpty() || !MemoryDataHandler::sInstance) return;
+    if(!mBakedCurvesCache)
+        mBakedCurvesCache = enve::make_shared<BakedCurvesCache>(this);
+    mBakedCurvesCache->updateUse();
+}
+
+void Canvas::clearBakedAnimationCurves() {
+    for(const auto& qa : mBakedAnimators) {
+        if(qa) qa->clearBakedCurve();
+    }
+    mBakedAnimators.clear();
+    if(mBakedCurvesCache) mBakedCurvesCache->stopUse();
+}
+
+int Canvas::bakedAnimationCurvesBytes() const {
+    int bytes = 0;
+    for(const auto& qa : mBakedAnimators) {
+        if(qa) bytes += qa->bakedCurveBytes();
+    }
+    return bytes;
+}
+
 void Canvas::setSceneFrame(const int relFrame) {
     const auto cont = mSceneFramesHandler.atFrame(relFrame);
     setSceneFrame(enve::shared<SceneFrameContainer>(cont));
@@ -456,6 +514,12 @@ void Canvas::renderDataFinished(BoxRenderData *renderData) {
     const int relFrame = qRound(renderData->fRelFrame);
     mLastStateId = renderData->fBoxStateId;
 
+    if(currentState && !mPreviewing && !mRenderingOutput) {
+        const auto canvasData = static_cast<CanvasRenderData*>(renderData);
+        mLastComposite = canvasData->fComposite;
+        if(mLastComposite) mLastComposite->fImage = renderData->fRenderedImage;
+    } else if(mPreviewing || mRenderingOutput) mLastComposite.reset();
+
     const auto range = prp_getIdenticalRelRange(relFrame);
     const auto cont = enve::make_shared<SceneFrameContainer>(
                 this, renderData, range,
@@ -947,8 +1011,9 @@ UndoRedoStack::StackBlock Canvas::blockUndoRedo() {
 
 void Canvas::addUndoRedo(const QString& name,
                          const stdfunc<void()>& undo,
-                         const stdfunc<void()>& redo) {
-    mUndoRedoStack->addUndoRedo(name, undo, redo);
+                         const stdfunc<void()>& redo,
+                         const stdsptr<UndoRedoData>& data) {
+    mUndoRedoStack->addUndoRedo(name, undo, redo, data);
 }
 
 void Canvas::pushUndoRedoName(const QString& name) const {
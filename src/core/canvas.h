@@ -51,6 +51,7 @@ class SkCanvas;
 class ImageSequenceBox;
 class Brush;
 class UndoRedoStack;
+class BakedCurvesCache;
 class ExternalLinkBox;
 struct ShaderEffectCreator;
 class VideoBox;
@@ -255,6 +256,12 @@ public:
 
     void setPreviewing(const bool bT);
     void setOutputRendering(const bool bT);
+    //! @brief Bakes the value curves of all animators for absRange,
+    //! values are sampled lazily and accounted by the memory handler
+    void bakeAnimationCurves(const FrameRange& absRange,
+                             const int samplesPerFrame = 1);
+    void clearBakedAnimationCurves();
+    int bakedAnimationCurvesBytes() const;
 
     bool SWT_shouldBeVisible(const SWT_RulesCollection &rules,
                              const bool parentSatisfies,
@@ -332,6 +339,7 @@ public:
         canvasData->fBgColor = toSkColor(mBackgroundColor->getColor());
         canvasData->fCanvasHeight = mHeight;
         canvasData->fCanvasWidth = mWidth;
+        canvasData->fBase = mLastComposite;
     }
 
     bool clipToCanvas() { return mClipToCanvasSize; }
@@ -408,6 +416,14 @@ public:
 
     void setRenderingPreview(const bool bT);
 
+    bool isRenderingPreview() const { return mRenderingPreview; }
+    bool isRenderingOutput() const { return mRenderingOutput; }
+
+    //! @brief Deadline given to tasks qued for the current frame,
+    //! -1 if the frame is not scheduled for playback
+    void setFrameDeadline(const qint64 deadline) { mFrameDeadline = deadline; }
+    qint64 frameDeadline() const { return mFrameDeadline; }
+
     bool isPreviewingOrRendering() const {
         return mPreviewing || mRenderingPreview || mRenderingOutput;
     }
@@ -557,7 +573,8 @@ public:
     const ConnContextObjList<GraphAnimator*>* getSelectedForGraph(const int widgetId) const;
     void addUndoRedo(const QString &name,
                      const stdfunc<void ()> &undo,
-                     const stdfunc<void ()> &redo);
+                     const stdfunc<void ()> &redo,
+                     const stdsptr<UndoRedoData> &data = nullptr);
     void pushUndoRedoName(const QString& name) const;
 
     UndoRedoStack* undoRedoStack() const
@@ -653,9 +670,15 @@ protected:
     bool mPreviewing = false;
     bool mRenderingPreview = false;
     bool mRenderingOutput = false;
+    qint64 mFrameDeadline = -1;
+
+    QList<qptr<QrealAnimator>> mBakedAnimators;
+    stdsptr<BakedCurvesCache> mBakedCurvesCache;
 
     bool mSceneFrameOutdated = false;
     UseSharedPointer<SceneFrameContainer> mSceneFrame;
+    //! @brief Last composited frame, base for redrawing only changed tiles
+    stdsptr<SceneComposite> mLastComposite;
     UseSharedPointer<SceneFrameContainer> mLoadingSceneFrame;
 
     bool mClipToCanvasSize = false;
@@ -191,6 +191,7 @@ SOURCES += \
     Private/Tasks/taskque.cpp \
     Private/Tasks/taskquehandler.cpp \
     Private/Tasks/taskscheduler.cpp \
+    Private/Tasks/workqueue.cpp \
     Private/document.cpp \
     Private/documentrw.cpp \
     Private/esettings.cpp \
@@ -218,11 +219,14 @@ SOURCES += \
     RasterEffects/shadoweffect.cpp \
     RasterEffects/wipeeffect.cpp \
     ReadWrite/basicreadwrite.cpp \
+    ReadWrite/emappedfile.cpp \
     ReadWrite/ereadstream.cpp \
+    ReadWrite/evfilesavetask.cpp \
     ReadWrite/ewritestream.cpp \
     ReadWrite/filefooter.cpp \
     Segments/fitcurves.cpp \
     Segments/smoothcurves.cpp \
+    ShaderEffects/cpushaderprogram.cpp \
     ShaderEffects/shadereffect.cpp \
     ShaderEffects/shadereffectcaller.cpp \
     ShaderEffects/shadereffectcreator.cpp \
@@ -340,6 +344,7 @@ SOURCES += \
     Animators/SmartPath/node.cpp \
     Animators/SmartPath/nodelist.cpp \
     Animators/SmartPath/smartpathanimator.cpp \
+    Animators/SmartPath/smartpathmorph.cpp \
     Animators/interpolationanimatort.cpp \
     nodepointvalues.cpp \
     Animators/SmartPath/smartpathcollection.cpp \
@@ -521,6 +526,7 @@ HEADERS += \
     Private/Tasks/taskque.h \
     Private/Tasks/taskquehandler.h \
     Private/Tasks/taskscheduler.h \
+    Private/Tasks/workqueue.h \
     Private/document.h \
     Private/esettings.h \
     Private/memorystructs.h \
@@ -553,8 +559,11 @@ HEADERS += \
     RasterEffects/shadoweffect.h \
     RasterEffects/wipeeffect.h \
     ReadWrite/basicreadwrite.h \
+    ReadWrite/echunkinfo.h \
     ReadWrite/efuturepos.h \
+    ReadWrite/emappedfile.h \
     ReadWrite/ereadstream.h \
+    ReadWrite/evfilesavetask.h \
     ReadWrite/evformat.h \
     ReadWrite/ewritestream.h \
     ReadWrite/filefooter.h \
@@ -566,6 +575,7 @@ HEADERS += \
     ShaderEffects/PropertyCreators/qpointfanimatorcreator.h \
     ShaderEffects/PropertyCreators/qrealanimatorcreator.h \
     ShaderEffects/PropertyCreators/shaderpropertycreator.h \
+    ShaderEffects/cpushaderprogram.h \
     ShaderEffects/shadereffect.h \
     ShaderEffects/shadereffectcaller.h \
     ShaderEffects/shadereffectcreator.h \
@@ -692,6 +702,7 @@ HEADERS += \
     Animators/SmartPath/node.h \
     Animators/SmartPath/nodelist.h \
     Animators/SmartPath/smartpathanimator.h \
+    Animators/SmartPath/smartpathmorph.h \
     Animators/interpolationanimatort.h \
     nodepointvalues.h \
     Animators/SmartPath/smartpathcollection.h \
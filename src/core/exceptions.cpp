@@ -81,7 +81,17 @@ QString gAllTextFromException(const std::exception &e,
     return allText;
 }
 
+static bool gExceptionDialogsEnabled = true;
+
+void gSetExceptionDialogsEnabled(const bool enabled) {
+    gExceptionDialogsEnabled = enabled;
+}
+
 void gPrintException(const bool fatal, const QString &allText) {
+    if(!gExceptionDialogsEnabled) {
+        qCritical() << allText;
+        return;
+    }
     const QString txt = fatal ? "Fatal" : "Critical";
     const auto icon = fatal ? QMessageBox::Critical : QMessageBox::Warning;
     QMessageBox(icon, txt + " Error", allText).exec();
@@ -86,6 +86,10 @@ CORE_EXPORT
 extern void gPrintExceptionCritical(const std::exception& e);
 CORE_EXPORT
 extern void gPrintExceptionFatal(const std::exception& e);
+//! @brief Without dialogs exceptions are only logged,
+//! used by processes running without user interaction.
+CORE_EXPORT
+extern void gSetExceptionDialogsEnabled(const bool enabled);
 CORE_EXPORT
 extern void gPrintException(const bool fatal, const QString& allText);
 CORE_EXPORT
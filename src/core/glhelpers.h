@@ -22,6 +22,7 @@
 #include "skia/skiaincludes.h"
 
 #include "exceptions.h"
+#include "Tasks/etaskbase.h"
 
 typedef QOpenGLFunctions_3_3_Core QGL33;
 #define BUFFER_OFFSET(i) ((void*)(i))
@@ -65,6 +66,11 @@ struct CORE_EXPORT CpuRenderData {
     //! @brief Texture size
     uint fWidth;
     uint fHeight;
+
+    //! @brief Priority and deadline of the rendered box,
+    //! for helper tasks spawned by the effect
+    eTaskPriority fPriority;
+    qint64 fDeadline;
 };
 
 #endif // GLHELPERS_H
@@ -20,6 +20,212 @@
 #include "exceptions.h"
 #include "pointhelpers.h"
 
+#include <cstring>
+#include <list>
+#include <mutex>
+
+//! @brief Hash of the path geometry, equal paths built independently
+//! for different frames share it
+static uint64_t pathHash(const SkPath& path) {
+    uint64_t hash = 14695981039346656037ULL;
+    const auto add = [&hash](const uint32_t value) {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    };
+    const auto addFloat = [&add](const float value) {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        add(bits);
+    };
+    add(static_cast<uint32_t>(path.getFillType()));
+    SkPath::Iter iter(path, false);
+    SkPoint pts[4];
+    for(SkPath::Verb verb; (verb = iter.next(pts)) != SkPath::kDone_Verb;) {
+        add(static_cast<uint32_t>(verb));
+        int first = 1;
+        int last = 0;
+        switch(verb) {
+        case SkPath::kMove_Verb: first = 0; break;
+        case SkPath::kLine_Verb: last = 1; break;
+        case SkPath::kConic_Verb: addFloat(iter.conicWeight()); last = 2; break;
+        case SkPath::kQuad_Verb: last = 2; break;
+        case SkPath::kCubic_Verb: last = 3; break;
+        default: break;
+        }
+        for(int i = first; i <= last; i++) {
+            addFloat(pts[i].x());
+            addFloat(pts[i].y());
+        }
+    }
+    return hash;
+}
+
+//! @brief Small least recently used cache of path operation results,
+//! shared between render threads
+class PathOpCache {
+public:
+    PathOpCache(const int capacity) : mCapacity(capacity) {}
+
+    bool find(const uint64_t hash, const SkPath& src,
+              const qreal param, SkPath * const result) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for(auto it = mEntries.begin(); it != mEntries.end(); it++) {
+            if(it->fHash != hash || it->fParam != param) continue;
+            if(it->fSrc != src) continue;
+            *result = it->fResult;
+            mEntries.splice(mEntries.begin(), mEntries, it);
+            return true;
+        }
+        return false;
+    }
+
+    void add(const uint64_t hash, const SkPath& src,
+             const qreal param, const SkPath& result) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mEntries.push_front({hash, param, src, result});
+        if(static_cast<int>(mEntries.size()) > mCapacity) mEntries.pop_back();
+    }
+private:
+    struct Entry {
+        uint64_t fHash;
+        qreal fParam;
+        SkPath fSrc;
+        SkPath fResult;
+    };
+
+    const int mCapacity;
+    std::mutex mMutex;
+    std::list<Entry> mEntries;
+};
+
+static PathOpCache sPolylineCache(32);
+static PathOpCache sSolidifyCache(128);
+
+static SkPath cachedPolyline(const uint64_t hash, const SkPath& src) {
+    SkPath polyline;
+    if(sPolylineCache.find(hash, src, 0, &polyline)) return polyline;
+    polyline = gPathToPolyline(src);
+    sPolylineCache.add(hash, src, 0, polyline);
+    return polyline;
+}
+
+//! @brief Returns the points of a single closed convex polyline contour
+static bool convexPolygon(const SkPath& polyline, QVector<SkPoint>& pts) {
+    if(!polyline.isConvex()) return false;
+    bool closed = false;
+    SkPath::Iter iter(polyline, false);
+    SkPoint verbPts[4];
+    for(SkPath::Verb verb; (verb = iter.next(verbPts)) != SkPath::kDone_Verb;) {
+        if(closed) return false;
+        switch(verb) {
+        case SkPath::kMove_Verb:
+            if(!pts.isEmpty()) return false;
+            pts << verbPts[0];
+            break;
+        case SkPath::kLine_Verb:
+            if(verbPts[1] != pts.last()) pts << verbPts[1];
+            break;
+        case SkPath::kClose_Verb:
+            closed = true;
+            break;
+        default: return false;
+        }
+    }
+    if(pts.count() > 1 && pts.first() == pts.last()) pts.removeLast();
+    return closed && pts.count() > 2;
+}
+
+//! @brief Outset of a convex polygon is the outer contour of its stroke
+static void outsetConvex(const SkPath& polyline, const SkStroke& stroker,
+                         SkPath * const dst) {
+    SkPath outline;
+    stroker.strokePath(polyline, &outline);
+    SkPath contour;
+    float maxArea = -1;
+    const auto finishContour = [&]() {
+        if(contour.isEmpty()) return;
+        const auto bounds = contour.getBounds();
+        const float area = bounds.width()*bounds.height();
+        if(area > maxArea) {
+            maxArea = area;
+            *dst = contour;
+        }
+        contour.reset();
+    };
+    SkPath::Iter iter(outline, false);
+    SkPoint pts[4];
+    for(SkPath::Verb verb; (verb = iter.next(pts)) != SkPath::kDone_Verb;) {
+        switch(verb) {
+        case SkPath::kMove_Verb:
+            finishContour();
+            contour.moveTo(pts[0]);
+            break;
+        case SkPath::kLine_Verb:
+            contour.lineTo(pts[1]);
+            break;
+        case SkPath::kQuad_Verb:
+            contour.quadTo(pts[1], pts[2]);
+            break;
+        case SkPath::kConic_Verb:
+            contour.conicTo(pts[1], pts[2], iter.conicWeight());
+            break;
+        case SkPath::kCubic_Verb:
+            contour.cubicTo(pts[1], pts[2], pts[3]);
+            break;
+        case SkPath::kClose_Verb:
+            contour.close();
+            break;
+        default: break;
+        }
+    }
+    finishContour();
+}
+
+//! @brief Inset of a convex polygon, clipped by every edge moved inwards
+static void insetConvex(const QVector<SkPoint>& pts, const qreal dist,
+                        SkPath * const dst) {
+    qreal area2 = 0;
+    const int count = pts.count();
+    for(int i = 0; i < count; i++) {
+        const auto& p0 = pts.at(i);
+        const auto& p1 = pts.at((i + 1) % count);
+        area2 += qreal(p0.x())*qreal(p1.y()) - qreal(p1.x())*qreal(p0.y());
+    }
+    const qreal orient = area2 > 0 ? 1 : -1;
+    QVector<QPointF> poly;
+    for(const auto& pt : pts) poly << toQPointF(pt);
+    QVector<QPointF> clipped;
+    for(int i = 0; i < count && poly.count() > 2; i++) {
+        const QPointF p0 = toQPointF(pts.at(i));
+        const QPointF p1 = toQPointF(pts.at((i + 1) % count));
+        const QPointF edge = p1 - p0;
+        const qreal len = pointToLen(edge);
+        if(isZero6Dec(len)) continue;
+        // inward normal
+        const QPointF normal = QPointF(-edge.y(), edge.x())*(orient/len);
+        const qreal offset = QPointF::dotProduct(normal, p0) + dist;
+        const auto side = [&](const QPointF& pt) {
+            return QPointF::dotProduct(normal, pt) - offset;
+        };
+        clipped.clear();
+        const int polyCount = poly.count();
+        for(int j = 0; j < polyCount; j++) {
+            const QPointF& a = poly.at(j);
+            const QPointF& b = poly.at((j + 1) % polyCount);
+            const qreal sa = side(a);
+            const qreal sb = side(b);
+            if(sa >= 0) clipped << a;
+            if((sa >= 0) != (sb >= 0)) clipped << a + (b - a)*(sa/(sa - sb));
+        }
+        poly.swap(clipped);
+    }
+    dst->reset();
+    if(poly.count() < 3) return;
+    dst->moveTo(toSkPoint(poly.first()));
+    for(int i = 1; i < poly.count(); i++) dst->lineTo(toSkPoint(poly.at(i)));
+    dst->close();
+}
+
 void gSolidify(const qreal widthT,
                const SkPath &src,
                SkPath * const dst) {
@@ -27,20 +233,35 @@ void gSolidify(const qreal widthT,
         *dst = src;
         return;
     }
-    SkPathOp op = widthT < 0 ? SkPathOp::kDifference_SkPathOp :
-                               SkPathOp::kUnion_SkPathOp;
+    const uint64_t hash = pathHash(src);
+    if(sSolidifyCache.find(hash, src, widthT, dst)) return;
+
     const qreal aWidth2 = qAbs(widthT*2);
     SkStroke strokerSk;
     strokerSk.setJoin(SkPaint::kRound_Join);
     strokerSk.setCap(SkPaint::kRound_Cap);
     strokerSk.setWidth(static_cast<float>(aWidth2));
 
-    SkPath src2 = gPathToPolyline(src);
-    SkPath outline;
-    strokerSk.strokePath(src2, &outline);
-    SkPath result;
-    Op(src2, outline, op, dst);
+    const SkPath src2 = cachedPolyline(hash, src);
+    QVector<SkPoint> convexPts;
+    if(convexPolygon(src2, convexPts)) {
+        // exact offsets without a boolean operation
+        if(widthT > 0) outsetConvex(src2, strokerSk, dst);
+        else insetConvex(convexPts, -widthT, dst);
+    } else {
+        const SkPathOp op = widthT < 0 ? SkPathOp::kDifference_SkPathOp :
+                                         SkPathOp::kUnion_SkPathOp;
+        SkPath outline;
+        strokerSk.strokePath(src2, &outline);
+        if(!Op(src2, outline, op, dst)) {
+            // a failed operation is not cached, it is retried next time
+            *dst = src2;
+            dst->setFillType(src.getFillType());
+            return;
+        }
+    }
     dst->setFillType(src.getFillType());
+    sSolidifyCache.add(hash, src, widthT, *dst);
 
 //    SkOpBuilder builder;
 //    builder.add(src, SkPathOp::kUnion_SkPathOp);
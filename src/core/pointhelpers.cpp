@@ -57,6 +57,13 @@ qreal gCubicValueAtT(const qCubicSegment1D &seg, const qreal t) {
             t*t*t*seg.p1();
 }
 
+qreal gCubicDerivativeAtT(const qCubicSegment1D &seg, const qreal t) {
+    const qreal mt = 1 - t;
+    return 3*mt*mt*(seg.c1() - seg.p0()) +
+            6*mt*t*(seg.c2() - seg.c1()) +
+            3*t*t*(seg.p1() - seg.c2());
+}
+
 qreal gSolveForP2(const qreal p0, const qreal p1,
                   const qreal p3, const qreal t,
                   const qreal value) {
@@ -93,6 +100,21 @@ qCubicSegment1D::Pair gDividedAtX(const qCubicSegment1D& seg,
 
 qreal gTFromX(const qCubicSegment1D &seg,
              const qreal x) {
+    // Newton-Raphson usually converges in two or three steps,
+    // fall back to bisection if it leaves [0, 1] or stalls
+    const qreal span = seg.p1() - seg.p0();
+    if(!isZero6Dec(span)) {
+        qreal t = qBound(0., (x - seg.p0())/span, 1.);
+        for(int i = 0; i < 8; i++) {
+            const qreal xGuess = gCubicValueAtT(seg, t);
+            if(qAbs(xGuess - x) <= 0.0001) return t;
+            const qreal dx = gCubicDerivativeAtT(seg, t);
+            if(isZero6Dec(dx)) break;
+            t -= (xGuess - x)/dx;
+            if(t < 0 || t > 1) break;
+        }
+    }
+
     qreal minT = 0.;
     qreal maxT = 1.;
     qreal xGuess;
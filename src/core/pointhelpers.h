@@ -93,6 +93,8 @@ extern qreal gCubicValueAtT(const qCubicSegment1D &seg,
                             const qreal t);
 extern QPointF gCubicValueAtT(const qCubicSegment2D &seg,
                               const qreal t);
+extern qreal gCubicDerivativeAtT(const qCubicSegment1D &seg,
+                                 const qreal t);
 
 //! @brief Only for beziers that do not have multiple points of the same x value,
 //! e.g., for GraphAnimators.
@@ -17,6 +17,9 @@
 #include "svgimporter.h"
 
 #include <QtXml/QDomDocument>
+#include <QXmlStreamReader>
+#include <QThread>
+#include <QFileInfo>
 
 #include "Boxes/containerbox.h"
 #include "colorhelpers.h"
@@ -34,6 +37,9 @@
 #include "matrixdecomposition.h"
 #include "transformvalues.h"
 #include "regexhelpers.h"
+#include "canvas.h"
+#include "Private/Tasks/complextask.h"
+#include "Private/Tasks/taskscheduler.h"
 
 #define RGXS REGEX_SPACES
 
@@ -78,6 +84,74 @@ struct SvgGradient {
     GradientType fType;
 };
 
+struct SvgGradients {
+    QMap<QString, SvgGradient> fGradients;
+    //       to       from
+    QMap<QString, QStringList> fUnresolvedLinks;
+};
+
+//! @brief Element of the parsed svg tree,
+//! keeps only the tag, the attributes, the text and the children.
+class SvgElement {
+public:
+    SvgElement(const QString& tagName) : mTagName(tagName) {}
+
+    const QString& tagName() const { return mTagName; }
+
+    QString attribute(const QString& name,
+                      const QString& defValue = QString()) const {
+        for(const auto& attr : mAttributes) {
+            if(attr.first == name) return attr.second;
+        }
+        return defValue;
+    }
+
+    void setAttributes(const QXmlStreamAttributes& attributes) {
+        mAttributes.reserve(attributes.count());
+        for(const auto& attr : attributes) {
+            mAttributes.append({attr.qualifiedName().toString(),
+                                attr.value().toString()});
+        }
+    }
+
+    void releaseAttribute(const QString& name) {
+        for(int i = 0; i < mAttributes.count(); i++) {
+            if(mAttributes.at(i).first != name) continue;
+            mAttributes.remove(i);
+            return;
+        }
+    }
+
+    //! @brief Text of the element and its descendants.
+    const QString& text() const { return mText; }
+    void appendText(const QString& text) { mText.append(text); }
+
+    const std::vector<std::unique_ptr<SvgElement>>& children() const {
+        return mChildren;
+    }
+
+    SvgElement* addChild(std::unique_ptr<SvgElement>&& child) {
+        mChildren.push_back(std::move(child));
+        return mChildren.back().get();
+    }
+
+    //! @brief Parsed data of path, polyline and polygon elements.
+    SkPath& path() { return mPath; }
+    const SkPath& path() const { return mPath; }
+private:
+    const QString mTagName;
+    QVector<QPair<QString, QString>> mAttributes;
+    QString mText;
+    std::vector<std::unique_ptr<SvgElement>> mChildren;
+    SkPath mPath;
+};
+
+struct SvgDocument {
+    std::unique_ptr<SvgElement> fRoot;
+    std::vector<SvgElement*> fPathElements;
+    int fElementCount = 0;
+};
+
 class FillSvgAttributes {
 public:
     FillSvgAttributes() {}
@@ -143,13 +217,16 @@ public:
     const StrokeSvgAttributes &getStrokeAttributes() const;
     const TextSvgAttributes &getTextAttributes() const;
 
-    void loadBoundingBoxAttributes(const QDomElement &element);
+    void loadBoundingBoxAttributes(const SvgElement &element,
+                                   const SvgGradients &gradients);
 
     bool hasTransform() const;
 
     void apply(BoundingBox *box) const;
-    void setFillAttribute(const QString &value);
-    void setStrokeAttribute(const QString &value);
+    void setFillAttribute(const QString &value,
+                          const SvgGradients &gradients);
+    void setStrokeAttribute(const QString &value,
+                            const SvgGradients &gradients);
 protected:
     SkPathFillType mFillRule = SkPathFillType::kEvenOdd;
 
@@ -174,6 +251,7 @@ class SmartVectorPath;
 class VectorPathSvgAttributes : public BoxSvgAttributes {
 public:
     SkPath& path() { return mPath; }
+    void setPath(const SkPath& path) { mPath = path; }
 
     void apply(SmartVectorPath * const path);
 
@@ -353,22 +431,20 @@ static void parseNumbersArray(const QChar *&str,
     }
 }
 
-bool parsePolylineData(const QString &dataStr,
-                       VectorPathSvgAttributes &attributes,
+bool parsePolylineData(const QString &dataStr, SkPath& path,
                        const bool isPolygon) {
     float x0 = 0, y0 = 0;              // starting point
     float x = 0, y = 0;                // current point
+    // QString data is always 0-terminated, as parseNumbersArray requires
     const QChar *str = dataStr.constData();
     const QChar *end = str + dataStr.size();
 
-    SkPath& path = attributes.path();
     while (str != end) {
         while(str->isSpace()) ++str;
-        QChar endc = *end;
-        *const_cast<QChar *>(end) = 0; // parseNumbersArray requires 0-termination that QStringRef cannot guarantee
+        const QChar * const numbersStart = str;
         QVarLengthArray<float, 8> arg;
         parseNumbersArray(str, arg);
-        *const_cast<QChar *>(end) = endc;
+        if(str == numbersStart) break;
         const float *num = arg.constData();
         int count = arg.count();
         bool first = true;
@@ -399,54 +475,65 @@ bool parsePolylineData(const QString &dataStr,
     return true;
 }
 
-void loadElement(const QDomElement &element, ContainerBox *parentGroup,
-                 const BoxSvgAttributes &parentGroupAttributes,
-                 const GradientCreator& gradientCreator);
-
-qsptr<ContainerBox> loadBoxesGroup(const QDomElement &groupElement,
-                                   ContainerBox *parentGroup,
-                                   const BoxSvgAttributes &attributes,
-                                   const GradientCreator& gradientCreator) {
-    const QDomNodeList allRootChildNodes = groupElement.childNodes();
-    qsptr<ContainerBox> boxesGroup;
-    const bool hasTransform = attributes.hasTransform();
-    if(allRootChildNodes.count() > 1 || hasTransform || !parentGroup) {
-        boxesGroup = enve::make_shared<ContainerBox>(eBoxType::group);
-        boxesGroup->planCenterPivotPosition();
-        attributes.apply(boxesGroup.get());
-        if(parentGroup) parentGroup->addContained(boxesGroup);
+void parsePathElement(SvgElement& element) {
+    const QString& tagName = element.tagName();
+    if(tagName == "path") {
+        const QString pathStr = element.attribute("d");
+        SkParsePath::FromSVGString(pathStr.toStdString().data(), &element.path());
+        element.releaseAttribute("d");
     } else {
-        boxesGroup = parentGroup->ref<ContainerBox>();
+        const QString pointsStr = element.attribute("points");
+        parsePolylineData(pointsStr, element.path(), tagName == "polygon");
+        element.releaseAttribute("points");
     }
+}
+
+bool isPathTagName(const QString& tagName) {
+    return tagName == "path" || tagName == "polyline" || tagName == "polygon";
+}
 
-    for(int i = 0; i < allRootChildNodes.count(); i++) {
-        const QDomNode iNode = allRootChildNodes.at(i);
-        if(iNode.isElement()) {
-            loadElement(iNode.toElement(), boxesGroup.get(),
-                        attributes, gradientCreator);
+void parseSvgTree(QXmlStreamReader& reader, SvgDocument& document) {
+    QList<SvgElement*> openElements;
+    while(!reader.atEnd()) {
+        switch(reader.readNext()) {
+        case QXmlStreamReader::StartElement: {
+            const QString tagName = reader.qualifiedName().toString();
+            auto element = std::make_unique<SvgElement>(tagName);
+            element->setAttributes(reader.attributes());
+            SvgElement* added;
+            if(openElements.isEmpty()) {
+                if(tagName != "svg")
+                    RuntimeThrow("File does not have svg root element");
+                document.fRoot = std::move(element);
+                added = document.fRoot.get();
+            } else added = openElements.last()->addChild(std::move(element));
+            openElements << added;
+            if(isPathTagName(tagName)) document.fPathElements.push_back(added);
+            document.fElementCount++;
+        } break;
+        case QXmlStreamReader::EndElement: {
+            const auto ended = openElements.takeLast();
+            if(openElements.isEmpty()) return;
+            const auto parent = openElements.last();
+            if(parent->tagName() == "text" || parent->tagName() == "tspan")
+                parent->appendText(ended->text());
+        } break;
+        case QXmlStreamReader::Characters:
+            if(openElements.isEmpty() || reader.isWhitespace()) break;
+            openElements.last()->appendText(reader.text().toString());
+            break;
+        default: break;
         }
     }
-    return boxesGroup;
+    if(reader.hasError())
+        RuntimeThrow("Invalid svg file: " + reader.errorString());
+    if(!document.fRoot) RuntimeThrow("File does not have svg root element");
 }
 
-void loadVectorPath(const QDomElement &pathElement,
+void loadVectorPath(const SvgElement &pathElement,
                     ContainerBox *parentGroup,
                     VectorPathSvgAttributes& attributes) {
-    const QString pathStr = pathElement.attribute("d");
-    SkParsePath::FromSVGString(pathStr.toStdString().data(), &attributes.path());
-    if(attributes.isEmpty()) return;
-    const auto vectorPath = enve::make_shared<SmartVectorPath>();
-    vectorPath->planCenterPivotPosition();
-    attributes.apply(vectorPath.get());
-    parentGroup->addContained(vectorPath);
-}
-
-void loadPolyline(const QDomElement &pathElement,
-                  ContainerBox *parentGroup,
-                  VectorPathSvgAttributes &attributes,
-                  const bool isPolygon) {
-    const QString pathStr = pathElement.attribute("points");
-    parsePolylineData(pathStr, attributes, isPolygon);
+    attributes.setPath(pathElement.path());
     if(attributes.isEmpty()) return;
     const auto vectorPath = enve::make_shared<SmartVectorPath>();
     vectorPath->planCenterPivotPosition();
@@ -454,7 +541,7 @@ void loadPolyline(const QDomElement &pathElement,
     parentGroup->addContained(vectorPath);
 }
 
-void loadCircle(const QDomElement &pathElement,
+void loadCircle(const SvgElement &pathElement,
                 ContainerBox *parentGroup,
                 const BoxSvgAttributes &attributes) {
 
@@ -488,7 +575,7 @@ void loadCircle(const QDomElement &pathElement,
     parentGroup->addContained(circle);
 }
 
-void loadRect(const QDomElement &pathElement,
+void loadRect(const SvgElement &pathElement,
               ContainerBox *parentGroup,
               const BoxSvgAttributes &attributes) {
 
@@ -520,7 +607,7 @@ void loadRect(const QDomElement &pathElement,
     parentGroup->addContained(rect);
 }
 
-void loadText(const QDomElement &pathElement,
+void loadText(const SvgElement &pathElement,
               ContainerBox *parentGroup,
               const BoxSvgAttributes &attributes) {
 
@@ -633,166 +720,235 @@ QMatrix getMatrixFromString(const QString &str) {
     return matrix;
 }
 
-static QMap<QString, SvgGradient> gGradients;
-//            to       from
-static QMap<QString, QStringList> gUnresolvedGradientLinks;
-void loadElement(const QDomElement &element, ContainerBox *parentGroup,
-                 const BoxSvgAttributes &parentGroupAttributes,
-                 const GradientCreator& gradientCreator) {
-    const QString tagName = element.tagName();
-    if(tagName == "defs") {
-        const QDomNodeList allRootChildNodes = element.childNodes();
-        for(int i = 0; i < allRootChildNodes.count(); i++) {
-            const QDomNode iNode = allRootChildNodes.at(i);
-            if(iNode.isElement()) {
-                loadElement(iNode.toElement(), parentGroup,
-                            parentGroupAttributes, gradientCreator);
-            }
-        }
-        return;
-    } else if(tagName == "linearGradient" || tagName == "radialGradient") {
-        GradientType type;
-        if(tagName == "linearGradient") {
-            type = GradientType::LINEAR;
-        } else { //if(tagName == "radialGradient") {
-            type = GradientType::RADIAL;
-        }
-        const QString id = element.attribute("id");
-        QString linkId = element.attribute("xlink:href");
-        Gradient* gradient = nullptr;
-        if(linkId.isEmpty()) {
-            gradient = gradientCreator();
-            const QDomNodeList allRootChildNodes = element.childNodes();
-            for(int i = 0; i < allRootChildNodes.count(); i++) {
-                const QDomNode iNode = allRootChildNodes.at(i);
-                if(!iNode.isElement()) continue;
-                const QDomElement elem = iNode.toElement();
-                if(elem.tagName() != "stop") continue;
-                QString stopColorS;
-                QString stopOpacityS;
-                const QString stopStyle = elem.attribute("style");
-                QList<SvgAttribute> attributesList;
-                extractSvgAttributes(stopStyle, &attributesList);
-                for(const auto& attr : attributesList) {
-                    if(attr.fName == "stop-color") {
-                        stopColorS = attr.fValue;
-
-                    } else if(attr.fName == "stop-opacity") {
-                        stopOpacityS = attr.fValue;
-                    }
-                }
-                if(stopColorS.isEmpty()) {
-                    stopColorS = elem.attribute("stop-color");
-                }
-                if(stopOpacityS.isEmpty()) {
-                    stopOpacityS = elem.attribute("stop-opacity");
-                }
-
-                QColor stopColor;
-                toColor(stopColorS, stopColor);
-                if(!stopOpacityS.isEmpty()) {
-                    stopColor.setAlphaF(toDouble(stopOpacityS));
-                }
+//! @brief Creates boxes for the parsed svg tree,
+//! can be interrupted after any number of elements.
+class SvgBoxesBuilder {
+public:
+    SvgBoxesBuilder(const SvgElement& root, ContainerBox* const target,
+                    const GradientCreator& gradientCreator) :
+        mGradientCreator(gradientCreator) {
+        const auto attributes = std::make_shared<BoxSvgAttributes>();
+        pushChildren(root, target, attributes);
+    }
 
-                gradient->addColor(stopColor);
-            }
-        } else {
-            if(linkId.at(0) == "#") linkId.remove(0, 1);
-            const auto it = gGradients.find(linkId);
-            if(it == gGradients.end()) {
-                gUnresolvedGradientLinks[linkId].append(id);
-                gradient = nullptr;
-            } else {
-                gradient = it.value().fGradient;
-            }
-        }
-        const auto it = gUnresolvedGradientLinks.find(id);
-        if(it != gUnresolvedGradientLinks.end()) {
-            if(gradient) {
-                for(const auto& linking : it.value()) {
-                    auto& grad = gGradients[linking];
-                    grad.fGradient = gradient;
-                    grad.fType = type;
-                }
-            } else {
-                gUnresolvedGradientLinks[linkId] = it.value();
-            }
+    ~SvgBoxesBuilder() {
+        auto it = mGradients.fUnresolvedLinks.begin();
+        while(it != mGradients.fUnresolvedLinks.end()) {
+            qDebug() << "unresolved gradient links to " + it.key() + ":";
+            qDebug() << it.value().join(", ");
+            it++;
         }
+    }
 
-        double x1;
-        double x2;
-        double y1;
-        double y2;
-        switch(type) {
-        case GradientType::LINEAR:
-        {
-            const QString x1s = element.attribute("x1");
-            const QString y1s = element.attribute("y1");
-            const QString x2s = element.attribute("x2");
-            const QString y2s = element.attribute("y2");
-
-            x1 = toDouble(x1s);
-            y1 = toDouble(y1s),
-            x2 = toDouble(x2s);
-            y2 = toDouble(y2s);
-            break;
-        }
-        case GradientType::RADIAL:
-        {
-            const QString cxs = element.attribute("cx");
-            const QString cys = element.attribute("cy");
-            const QString rs = element.attribute("r");
-
-            const double cx = toDouble(cxs);
-            const double cy = toDouble(cys);
-            const double r = toDouble(rs);
-
-            x1 = cx;
-            y1 = cy;
-            x2 = cx + r;
-            y2 = cy + r;
-            break;
+    //! @brief Loads up to maxElements elements,
+    //! returns true if the whole tree has been loaded.
+    bool build(const int maxElements) {
+        int i = 0;
+        while(i < maxElements && !mStack.isEmpty()) {
+            const auto pending = mStack.takeLast();
+            loadElement(pending);
+            if(pending.fElement) i++;
         }
+        mLoadedCount += i;
+        return mStack.isEmpty();
+    }
+
+    int loadedCount() const { return mLoadedCount; }
+private:
+    struct PendingElement {
+        const SvgElement* fElement;
+        qptr<ContainerBox> fParent;
+        stdsptr<const BoxSvgAttributes> fAttributes;
+        //! @brief Removed if still empty once all its children are loaded
+        qptr<ContainerBox> fCreatedGroup;
+    };
+
+    void pushChildren(const SvgElement& element, ContainerBox* const parent,
+                      const stdsptr<const BoxSvgAttributes>& attributes) {
+        const auto& children = element.children();
+        for(auto it = children.rbegin(); it != children.rend(); it++) {
+            mStack.append({it->get(), parent, attributes, nullptr});
         }
+    }
+
+    void loadElement(const PendingElement& pending);
+    void loadGradient(const SvgElement &element);
+    void loadBoxesGroup(const SvgElement &element, ContainerBox *parentGroup,
+                        const stdsptr<const BoxSvgAttributes>& attributes);
 
-        const QString gradTrans = element.attribute("gradientTransform");
-        const QMatrix trans = getMatrixFromString(gradTrans);
-        gGradients.insert(id, {gradient,
-                               x1, y1,
-                               x2, y2,
-                               trans, type});
-    } else if(tagName == "path" || tagName == "polyline" || tagName == "polygon") {
+    const GradientCreator mGradientCreator;
+    SvgGradients mGradients;
+    QList<PendingElement> mStack;
+    int mLoadedCount = 0;
+};
+
+void SvgBoxesBuilder::loadBoxesGroup(
+        const SvgElement &element, ContainerBox *parentGroup,
+        const stdsptr<const BoxSvgAttributes>& attributes) {
+    const bool hasTransform = attributes->hasTransform();
+    if(element.children().size() > 1 || hasTransform) {
+        const auto boxesGroup = enve::make_shared<ContainerBox>(eBoxType::group);
+        boxesGroup->planCenterPivotPosition();
+        attributes->apply(boxesGroup.get());
+        parentGroup->addContained(boxesGroup);
+        mStack.append({nullptr, nullptr, nullptr, boxesGroup.get()});
+        pushChildren(element, boxesGroup.get(), attributes);
+    } else {
+        pushChildren(element, parentGroup, attributes);
+    }
+}
+
+void SvgBoxesBuilder::loadElement(const PendingElement& pending) {
+    if(pending.fCreatedGroup) {
+        if(pending.fCreatedGroup->getContainedBoxesCount() == 0)
+            pending.fCreatedGroup->removeFromParent_k();
+        return;
+    }
+    const auto parentGroup = pending.fParent.data();
+    if(!parentGroup) return;
+    const auto& element = *pending.fElement;
+    const auto& parentGroupAttributes = *pending.fAttributes;
+    const QString& tagName = element.tagName();
+    if(tagName == "defs") {
+        pushChildren(element, parentGroup, pending.fAttributes);
+    } else if(tagName == "linearGradient" || tagName == "radialGradient") {
+        loadGradient(element);
+    } else if(isPathTagName(tagName)) {
         VectorPathSvgAttributes attributes;
         attributes.setParent(parentGroupAttributes);
-        attributes.loadBoundingBoxAttributes(element);
-        if(tagName == "path") {
-            loadVectorPath(element, parentGroup, attributes);
-        } else if(tagName == "polyline") {
-            loadPolyline(element, parentGroup, attributes, false);
-        } else if(tagName == "polygon") {
-            loadPolyline(element, parentGroup, attributes, true);
-        }
+        attributes.loadBoundingBoxAttributes(element, mGradients);
+        loadVectorPath(element, parentGroup, attributes);
     } else if(tagName == "g" || tagName == "text" ||
               tagName == "circle" || tagName == "ellipse" ||
               tagName == "rect" || tagName == "tspan") {
-        BoxSvgAttributes attributes;
-        attributes.setParent(parentGroupAttributes);
-        attributes.loadBoundingBoxAttributes(element);
+        const auto attributes = std::make_shared<BoxSvgAttributes>();
+        attributes->setParent(parentGroupAttributes);
+        attributes->loadBoundingBoxAttributes(element, mGradients);
         if(tagName == "g" || tagName == "text") {
-            const auto group = loadBoxesGroup(element, parentGroup,
-                                              attributes, gradientCreator);
-            if(group->getContainedBoxesCount() == 0)
-                group->removeFromParent_k();
+            loadBoxesGroup(element, parentGroup, attributes);
         } else if(tagName == "circle" || tagName == "ellipse") {
-            loadCircle(element, parentGroup, attributes);
+            loadCircle(element, parentGroup, *attributes);
         } else if(tagName == "rect") {
-            loadRect(element, parentGroup, attributes);
+            loadRect(element, parentGroup, *attributes);
         } else if(tagName == "tspan") {
-            loadText(element, parentGroup, attributes);
+            loadText(element, parentGroup, *attributes);
         }
     } else qDebug() << "Unrecognized tagName \"" + tagName + "\"";
 }
 
+void SvgBoxesBuilder::loadGradient(const SvgElement &element) {
+    auto& gradients = mGradients.fGradients;
+    auto& unresolvedLinks = mGradients.fUnresolvedLinks;
+    const QString& tagName = element.tagName();
+    GradientType type;
+    if(tagName == "linearGradient") {
+        type = GradientType::LINEAR;
+    } else { //if(tagName == "radialGradient") {
+        type = GradientType::RADIAL;
+    }
+    const QString id = element.attribute("id");
+    QString linkId = element.attribute("xlink:href");
+    Gradient* gradient = nullptr;
+    if(linkId.isEmpty()) {
+        gradient = mGradientCreator();
+        for(const auto& child : element.children()) {
+            const SvgElement& elem = *child;
+            if(elem.tagName() != "stop") continue;
+            QString stopColorS;
+            QString stopOpacityS;
+            const QString stopStyle = elem.attribute("style");
+            QList<SvgAttribute> attributesList;
+            extractSvgAttributes(stopStyle, &attributesList);
+            for(const auto& attr : attributesList) {
+                if(attr.fName == "stop-color") {
+                    stopColorS = attr.fValue;
+
+                } else if(attr.fName == "stop-opacity") {
+                    stopOpacityS = attr.fValue;
+                }
+            }
+            if(stopColorS.isEmpty()) {
+                stopColorS = elem.attribute("stop-color");
+            }
+            if(stopOpacityS.isEmpty()) {
+                stopOpacityS = elem.attribute("stop-opacity");
+            }
+
+            QColor stopColor;
+            toColor(stopColorS, stopColor);
+            if(!stopOpacityS.isEmpty()) {
+                stopColor.setAlphaF(toDouble(stopOpacityS));
+            }
+
+            gradient->addColor(stopColor);
+        }
+    } else {
+        if(linkId.at(0) == "#") linkId.remove(0, 1);
+        const auto it = gradients.find(linkId);
+        if(it == gradients.end()) {
+            unresolvedLinks[linkId].append(id);
+            gradient = nullptr;
+        } else {
+            gradient = it.value().fGradient;
+        }
+    }
+    const auto it = unresolvedLinks.find(id);
+    if(it != unresolvedLinks.end()) {
+        if(gradient) {
+            for(const auto& linking : it.value()) {
+                auto& grad = gradients[linking];
+                grad.fGradient = gradient;
+                grad.fType = type;
+            }
+        } else {
+            unresolvedLinks[linkId] = it.value();
+        }
+    }
+
+    double x1;
+    double x2;
+    double y1;
+    double y2;
+    switch(type) {
+    case GradientType::LINEAR:
+    {
+        const QString x1s = element.attribute("x1");
+        const QString y1s = element.attribute("y1");
+        const QString x2s = element.attribute("x2");
+        const QString y2s = element.attribute("y2");
+
+        x1 = toDouble(x1s);
+        y1 = toDouble(y1s),
+        x2 = toDouble(x2s);
+        y2 = toDouble(y2s);
+        break;
+    }
+    case GradientType::RADIAL:
+    {
+        const QString cxs = element.attribute("cx");
+        const QString cys = element.attribute("cy");
+        const QString rs = element.attribute("r");
+
+        const double cx = toDouble(cxs);
+        const double cy = toDouble(cys);
+        const double r = toDouble(rs);
+
+        x1 = cx;
+        y1 = cy;
+        x2 = cx + r;
+        y2 = cy + r;
+        break;
+    }
+    }
+
+    const QString gradTrans = element.attribute("gradientTransform");
+    const QMatrix trans = getMatrixFromString(gradTrans);
+    gradients.insert(id, {gradient,
+                          x1, y1,
+                          x2, y2,
+                          trans, type});
+}
+
 bool getUrlId(const QString &urlStr, QString *id) {
     const QRegExp rx = QRegExp(RGXS "url\\(\\s*#(.*)\\)" RGXS, Qt::CaseInsensitive);
     if(rx.exactMatch(urlStr)) {
@@ -806,14 +962,15 @@ bool getUrlId(const QString &urlStr, QString *id) {
 }
 
 bool getGradientFromString(const QString &colorStr,
+                           const SvgGradients &gradients,
                            FillSvgAttributes * const target) {
     const QRegExp rx = QRegExp(RGXS "url\\(\\s*(.*)\\s*\\)" RGXS, Qt::CaseInsensitive);
     if(rx.exactMatch(colorStr)) {
         const QStringList capturedTxt = rx.capturedTexts();
         QString id = capturedTxt.at(1);
         if(id.at(0) == '#') id.remove(0, 1);
-        const auto it = gGradients.find(id);
-        if(it != gGradients.end()) {
+        const auto it = gradients.fGradients.find(id);
+        if(it != gradients.fGradients.end()) {
             target->setGradient(it.value());
             return true;
         }
@@ -831,22 +988,23 @@ bool getFlatColorFromString(const QString &colorStr, FillSvgAttributes *target)
     return true;
 }
 
-qsptr<BoundingBox> ImportSVG::loadSVGFile(
-        const QDomDocument& src,
-        const GradientCreator& gradientCreator) {
-    const QDomElement rootElement = src.firstChildElement("svg");
-    if(rootElement.isNull()) RuntimeThrow("File does not have svg root element");
-    BoxSvgAttributes attributes;
-    const auto result = loadBoxesGroup(rootElement, nullptr,
-                                       attributes, gradientCreator);
-    gGradients.clear();
-    auto it = gUnresolvedGradientLinks.begin();
-    while(it != gUnresolvedGradientLinks.end()) {
-        qDebug() << "unresolved gradient links to " + it.key() + ":";
-        qDebug() << it.value().join(", ");
-        it++;
+qsptr<ContainerBox> createRootGroup() {
+    const auto result = enve::make_shared<ContainerBox>(eBoxType::group);
+    result->planCenterPivotPosition();
+    BoxSvgAttributes().apply(result.get());
+    return result;
+}
+
+qsptr<BoundingBox> loadSVG(QXmlStreamReader& reader,
+                           const GradientCreator& gradientCreator) {
+    SvgDocument document;
+    parseSvgTree(reader, document);
+    for(const auto element : document.fPathElements) {
+        parsePathElement(*element);
     }
-    gUnresolvedGradientLinks.clear();
+    const auto result = createRootGroup();
+    SvgBoxesBuilder(*document.fRoot, result.get(),
+                    gradientCreator).build(document.fElementCount);
     if(result->getContainedBoxesCount() == 1) {
         return qSharedPointerCast<BoundingBox>(
                     result->takeContained_k(0));
@@ -856,22 +1014,25 @@ qsptr<BoundingBox> ImportSVG::loadSVGFile(
     return result;
 }
 
+qsptr<BoundingBox> ImportSVG::loadSVGFile(
+        const QDomDocument& src,
+        const GradientCreator& gradientCreator) {
+    QXmlStreamReader reader(src.toByteArray());
+    return loadSVG(reader, gradientCreator);
+}
+
 qsptr<BoundingBox> ImportSVG::loadSVGFile(
         const QByteArray& src,
         const GradientCreator& gradientCreator) {
-    QDomDocument document;
-    if(!document.setContent(src))
-        RuntimeThrow("Cannot set file as QDomDocument content");
-    return loadSVGFile(document, gradientCreator);
+    QXmlStreamReader reader(src);
+    return loadSVG(reader, gradientCreator);
 }
 
 qsptr<BoundingBox> ImportSVG::loadSVGFile(
         QIODevice* const src,
         const GradientCreator& gradientCreator) {
-    QDomDocument document;
-    if(!document.setContent(src))
-        RuntimeThrow("Cannot set file as QDomDocument content");
-    return loadSVGFile(document, gradientCreator);
+    QXmlStreamReader reader(src);
+    return loadSVG(reader, gradientCreator);
 }
 
 qsptr<BoundingBox> ImportSVG::loadSVGFile(
@@ -883,6 +1044,114 @@ qsptr<BoundingBox> ImportSVG::loadSVGFile(
     return loadSVGFile(&file, gradientCreator);
 }
 
+#define SVG_IMPORT_BATCH 256
+
+//! @brief Parses the file and its path data on cpu threads,
+//! then fills the target group in batches on the main thread.
+class SvgImportTask : public ComplexTask {
+public:
+    SvgImportTask(const QString& filename, ContainerBox* const target,
+                  const GradientCreator& gradientCreator) :
+        ComplexTask(100, "SVG " + QFileInfo(filename).fileName()),
+        mFilename(filename), mTarget(target),
+        mGradientCreator(gradientCreator),
+        mDocument(std::make_shared<SvgDocument>()) {}
+
+    void nextStep() override {
+        if(done()) return;
+        if(!mTarget) return cancel();
+        switch(mStage) {
+        case Stage::parse: return parse();
+        case Stage::parsePaths: return parsePaths();
+        case Stage::build: return build();
+        }
+    }
+private:
+    enum class Stage { parse, parsePaths, build };
+
+    void parse() {
+        mStage = Stage::parsePaths;
+        const auto document = mDocument;
+        const QString filename = mFilename;
+        const auto task = enve::make_shared<eCustomCpuTask>(
+                    nullptr, [document, filename]() {
+            QFile file(filename);
+            if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
+                RuntimeThrow("Cannot open file " + filename);
+            QXmlStreamReader reader(&file);
+            parseSvgTree(reader, *document);
+        }, nullptr, nullptr);
+        task->queTask();
+        addTask(task);
+    }
+
+    void parsePaths() {
+        setValue(20);
+        mStage = Stage::build;
+        const int count = int(mDocument->fPathElements.size());
+        const int nTasks = qMin(count, QThread::idealThreadCount());
+        if(nTasks == 0) return build();
+        mRemainingPathTasks = nTasks;
+        const auto document = mDocument;
+        for(int i = 0; i < nTasks; i++) {
+            const int first = i*count/nTasks;
+            const int last = (i + 1)*count/nTasks;
+            const auto task = enve::make_shared<eCustomCpuTask>(
+                        nullptr, [document, first, last]() {
+                for(int j = first; j < last; j++) {
+                    parsePathElement(*document->fPathElements[j]);
+                }
+            }, nullptr, nullptr);
+            task->queTask();
+            addTask(task);
+        }
+    }
+
+    void build() {
+        if(mRemainingPathTasks > 0 && --mRemainingPathTasks > 0) return;
+        const auto scene = mTarget->getParentScene();
+        if(!scene) return cancel();
+        if(!mBuilder) {
+            mBuilder = std::make_unique<SvgBoxesBuilder>(
+                        *mDocument->fRoot, mTarget, mGradientCreator);
+        }
+        const auto block = scene->blockUndoRedo();
+        if(mBuilder->build(SVG_IMPORT_BATCH)) {
+            mBuilder.reset();
+            return finish();
+        }
+        const int total = qMax(1, mDocument->fElementCount);
+        setValue(qMin(99, 40 + 60*mBuilder->loadedCount()/total));
+        addEmptyTask();
+    }
+
+    const QString mFilename;
+    const qptr<ContainerBox> mTarget;
+    const GradientCreator mGradientCreator;
+    const stdsptr<SvgDocument> mDocument;
+    Stage mStage = Stage::parse;
+    int mRemainingPathTasks = 0;
+    std::unique_ptr<SvgBoxesBuilder> mBuilder;
+};
+
+qsptr<BoundingBox> ImportSVG::loadSVGFileAsync(
+        const QString &filename,
+        const GradientCreator& gradientCreator) {
+    const auto result = createRootGroup();
+    result->prp_setName(QFileInfo(filename).completeBaseName());
+    const auto task = new SvgImportTask(filename, result.get(),
+                                        gradientCreator);
+    const auto taskSPtr = qsptr<SvgImportTask>(task, &QObject::deleteLater);
+    const qptr<ContainerBox> resultPtr = result.get();
+    QObject::connect(task, &ComplexTask::canceled, [resultPtr]() {
+        if(resultPtr && resultPtr->getContainedBoxesCount() == 0)
+            resultPtr->removeFromParent_k();
+    });
+    task->nextStep();
+    TaskScheduler::instance()->addComplexTask(taskSPtr);
+    return result;
+}
+
 void BoxSvgAttributes::setParent(const BoxSvgAttributes &parent) {
     mFillAttributes = parent.getFillAttributes();
     mStrokeAttributes = parent.getStrokeAttributes();
@@ -910,22 +1179,24 @@ const TextSvgAttributes &BoxSvgAttributes::getTextAttributes() const {
     return mTextAttributes;
 }
 
-void BoxSvgAttributes::setFillAttribute(const QString &value) {
+void BoxSvgAttributes::setFillAttribute(const QString &value,
+                                        const SvgGradients &gradients) {
     if(value.contains("none")) {
         mFillAttributes.setPaintType(NOPAINT);
     } else if(getFlatColorFromString(value, &mFillAttributes)) {
-    } else if(getGradientFromString(value, &mFillAttributes)) {
+    } else if(getGradientFromString(value, gradients, &mFillAttributes)) {
     } else {
         qDebug() << "setFillAttribute - format not recognised:" <<
                     endl << value;
     }
 }
 
-void BoxSvgAttributes::setStrokeAttribute(const QString &value) {
+void BoxSvgAttributes::setStrokeAttribute(const QString &value,
+                                          const SvgGradients &gradients) {
     if(value.contains("none")) {
         mStrokeAttributes.setPaintType(NOPAINT);
     } else if(getFlatColorFromString(value, &mStrokeAttributes)) {
-    } else if(getGradientFromString(value, &mStrokeAttributes)) {
+    } else if(getGradientFromString(value, gradients, &mStrokeAttributes)) {
     } else {
         qDebug() << "setStrokeAttribute - format not recognised:" <<
                     endl << value;
@@ -938,7 +1209,8 @@ QString stripPx(const QString& val) {
     return result;
 }
 
-void BoxSvgAttributes::loadBoundingBoxAttributes(const QDomElement &element) {
+void BoxSvgAttributes::loadBoundingBoxAttributes(
+        const SvgElement &element, const SvgGradients &gradients) {
     QList<SvgAttribute> styleAttributes;
     const QString styleAttributesStr = element.attribute("style");
     extractSvgAttributes(styleAttributesStr, &styleAttributes);
@@ -971,7 +1243,7 @@ void BoxSvgAttributes::loadBoundingBoxAttributes(const QDomElement &element) {
 
         case 'f':
             if(name == "fill") {
-                setFillAttribute(value);
+                setFillAttribute(value, gradients);
             } else if(name == "fill-rule") {
                 if(value == "nonzero") {
                     mFillRule = SkPathFillType::kWinding;
@@ -1028,7 +1300,7 @@ void BoxSvgAttributes::loadBoundingBoxAttributes(const QDomElement &element) {
         case 's':
             if(name.contains("stroke")) {
                 if(name == "stroke") {
-                    setStrokeAttribute(value);
+                    setStrokeAttribute(value, gradients);
                 } else if(name == "stroke-dasharray") {
                     //strokeDashArray = value;
                 } else if(name == "stroke-dashoffset") {
@@ -1105,13 +1377,13 @@ void BoxSvgAttributes::loadBoundingBoxAttributes(const QDomElement &element) {
     mId = element.attribute("id", mId);
 
     const QString fillAttributesStr = element.attribute("fill");
-    if(!fillAttributesStr.isEmpty()) setFillAttribute(fillAttributesStr);
+    if(!fillAttributesStr.isEmpty()) setFillAttribute(fillAttributesStr, gradients);
 
     const QString fillOp = element.attribute("fill-opacity");
     if(!fillOp.isEmpty()) mFillAttributes.setColorOpacity(toDouble(fillOp));
 
     const QString strokeAttributesStr = element.attribute("stroke");
-    if(!strokeAttributesStr.isEmpty()) setStrokeAttribute(strokeAttributesStr);
+    if(!strokeAttributesStr.isEmpty()) setStrokeAttribute(strokeAttributesStr, gradients);
 
     const QString strokeOp = element.attribute("stroke-opacity");
     if(!strokeOp.isEmpty()) mFillAttributes.setColorOpacity(toDouble(strokeOp));
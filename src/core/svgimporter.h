@@ -39,6 +39,11 @@ namespace ImportSVG {
     CORE_EXPORT
     qsptr<BoundingBox> loadSVGFile(const QString &filename,
                                    const GradientCreator& gradientCreator);
+    //! @brief Returns an empty group right away,
+    //! it is filled in batches by a background import task.
+    CORE_EXPORT
+    qsptr<BoundingBox> loadSVGFileAsync(const QString &filename,
+                                        const GradientCreator& gradientCreator);
 }
 
 #endif // SVGIMPORTER_H
@@ -16,19 +16,30 @@
 
 #include "undoredo.h"
 #include "exceptions.h"
+#include "memorydatahandler.h"
+#include "CacheHandlers/cachecontainer.h"
+#include "Private/esettings.h"
 
 class UndoRedo_priv {
 public:
     UndoRedo_priv(const int frame,
                   const QString& name,
                   const std::function<void()>& undo,
-                  const std::function<void()>& redo) :
-        fFrame(frame), fName(name), fUndo(undo), fRedo(redo) {}
+                  const std::function<void()>& redo,
+                  const stdsptr<UndoRedoData>& data = nullptr) :
+        fFrame(frame), fName(name), fUndo(undo), fRedo(redo), fData(data) {}
+    virtual ~UndoRedo_priv() = default;
+
+    virtual int bytesInMemory() const
+    { return fData ? fData->bytesInMemory() : 0; }
+    virtual int moveToTmpFile()
+    { return fData ? fData->moveToTmpFile() : 0; }
 
     const int fFrame;
     const QString fName;
     const std::function<void()> fUndo;
     const std::function<void()> fRedo;
+    const stdsptr<UndoRedoData> fData;
 };
 
 class UndoRedoSet : public UndoRedo_priv {
@@ -42,6 +53,20 @@ public:
     { mSet << undoRedo; }
     bool isEmpty()
     { return mSet.isEmpty(); }
+
+    int bytesInMemory() const override {
+        int bytes = 0;
+        for(const auto& undoRedo : mSet)
+            bytes += undoRedo->bytesInMemory();
+        return bytes;
+    }
+
+    int moveToTmpFile() override {
+        int bytes = 0;
+        for(const auto& undoRedo : mSet)
+            bytes += undoRedo->moveToTmpFile();
+        return bytes;
+    }
 private:
     void undo();
     void redo();
@@ -59,8 +84,34 @@ void UndoRedoSet::redo() {
         undoRedo->fRedo();
 }
 
+//! @brief Lets the memory handler free undo/redo data
+//! like any other cache, in the least recently used order.
+class UndoRedoStackCache : public CacheContainer {
+    e_OBJECT
+protected:
+    UndoRedoStackCache(UndoRedoStack* const stack) : mStack(stack) {}
+public:
+    int getByteCount() override {
+        return int(qMin(mStack->bytesInMemory(), qint64(INT_MAX)));
+    }
+
+    void updateUse() { updateInMemoryManagment(); }
+protected:
+    void noDataLeft_k() override {}
+private:
+    int free_RAM_k() override {
+        const qint64 bytes = mStack->freeMemory(mStack->bytesInMemory());
+        return int(qMin(bytes, qint64(INT_MAX)));
+    }
+
+    UndoRedoStack* const mStack;
+};
+
 UndoRedoStack::UndoRedoStack(const std::function<bool(int)> &changeFrameFunc) :
-    mChangeFrameFunc(changeFrameFunc) {}
+    mChangeFrameFunc(changeFrameFunc) {
+    if(MemoryDataHandler::sInstance)
+        mCache = enve::make_shared<UndoRedoStackCache>(this);
+}
 
 void UndoRedoStack::pushName(const QString &name) {
     if(mCurrentSetName.isEmpty()) {
@@ -74,6 +125,7 @@ bool UndoRedoStack::newCollection() {
         mRedoStack.clear();
         emptySomeOfUndo();
         mUndoStack << mCurrentSet;
+        if(mCache) mCache->updateUse();
         checkUndoRedoChanged();
     }
     mCurrentSet = nullptr;
@@ -91,21 +143,69 @@ void UndoRedoStack::addToSet(const stdsptr<UndoRedo_priv>& undoRedo) {
 }
 
 void UndoRedoStack::emptySomeOfUndo() {
-    if(mUndoStack.length() > 50) {
-        //            for(int i = 0; i < 50; i++) {
-        mUndoStack.removeFirst();
-        //            }
+    const auto& sett = eSettings::instance();
+    if(sett.fUndoCap > 0) {
+        while(mUndoStack.length() >= sett.fUndoCap) {
+            mUndoStack.removeFirst();
+        }
+    }
+    if(sett.fUndoRamMBCap.fValue <= 0) return;
+    const qint64 budget = qint64(sett.fUndoRamMBCap.fValue)*1024*1024;
+    const qint64 bytes = bytesInMemory();
+    if(bytes > budget) freeMemory(bytes - budget);
+}
+
+qint64 UndoRedoStack::bytesInMemory() const {
+    qint64 bytes = 0;
+    for(const auto& undoRedo : mUndoStack)
+        bytes += undoRedo->bytesInMemory();
+    for(const auto& undoRedo : mRedoStack)
+        bytes += undoRedo->bytesInMemory();
+    if(mCurrentSet) bytes += mCurrentSet->bytesInMemory();
+    return bytes;
+}
+
+qint64 UndoRedoStack::freeMemory(const qint64 bytes) {
+    qint64 freed = 0;
+    if(eSettings::instance().fHddCache) {
+        // data written asynchronously counts as released right away,
+        // otherwise every entry would be moved before the first write ends
+        qint64 released = 0;
+        const auto moveToTmpFile = [&](const stdsptr<UndoRedo_priv>& undoRedo) {
+            const int inMemory = undoRedo->bytesInMemory();
+            if(inMemory == 0) return;
+            freed += undoRedo->moveToTmpFile();
+            released += inMemory;
+        };
+        for(const auto& undoRedo : mUndoStack) {
+            if(released >= bytes) return freed;
+            moveToTmpFile(undoRedo);
+        }
+        for(const auto& undoRedo : mRedoStack) {
+            if(released >= bytes) return freed;
+            moveToTmpFile(undoRedo);
+        }
+    } else {
+        // nowhere to move the data, drop the oldest history,
+        // the last undo step always stays available
+        while(freed < bytes && mUndoStack.length() > 1) {
+            freed += mUndoStack.takeFirst()->bytesInMemory();
+        }
+        checkUndoRedoChanged();
     }
+    return freed;
 }
 
 void UndoRedoStack::addUndoRedo(const QString& name,
                                 const std::function<void()>& undoFunc,
-                                const std::function<void()>& redoFunc) {
+                                const std::function<void()>& redoFunc,
+                                const stdsptr<UndoRedoData>& data) {
     if(mUndoRedoBlocked) return;
     if(!undoFunc) RuntimeThrow("Missing undo function.");
     if(!redoFunc) RuntimeThrow("Missing redo function.");
     const auto undoRedo = std::make_shared<UndoRedo_priv>(mCurrentAbsFrame, name,
-                                                          undoFunc, redoFunc);
+                                                          undoFunc, redoFunc,
+                                                          data);
     addToSet(undoRedo);
 }
 
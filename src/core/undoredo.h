@@ -23,6 +23,19 @@
 
 class UndoRedo_priv;
 class UndoRedoSet;
+class UndoRedoStackCache;
+
+//! @brief Data kept by an undo/redo entry,
+//! lets the stack measure it and move it out of memory.
+class CORE_EXPORT UndoRedoData : public StdSelfRef {
+public:
+    //! @brief Bytes currently held in memory
+    virtual int bytesInMemory() const = 0;
+    //! @brief Schedules moving the data to a temporary file,
+    //! returns the number of bytes freed right away,
+    //! data written asynchronously is not counted
+    virtual int moveToTmpFile() = 0;
+};
 
 class CORE_EXPORT UndoRedoStack : public SelfRef {
     Q_OBJECT
@@ -52,7 +65,8 @@ public:
 
     void addUndoRedo(const QString &name,
                      const std::function<void()> &undo,
-                     const std::function<void()> &redo);
+                     const std::function<void()> &redo,
+                     const stdsptr<UndoRedoData> &data = nullptr);
 
     QString undoText() const;
     QString redoText() const;
@@ -64,6 +78,13 @@ public:
     bool undo();
     void emptySomeOfUndo();
 
+    //! @brief Bytes held in memory by undo/redo data
+    qint64 bytesInMemory() const;
+    //! @brief Frees memory held by the oldest entries first,
+    //! data still being written counts towards the requested bytes,
+    //! returns the number of bytes freed right away
+    qint64 freeMemory(const qint64 bytes);
+
     StackBlock blockUndoRedo();
 
     void setFrame(const int frame)
@@ -105,6 +126,8 @@ private:
     stdsptr<UndoRedoSet> mCurrentSet;
     QList<stdsptr<UndoRedo_priv>> mUndoStack;
     QList<stdsptr<UndoRedo_priv>> mRedoStack;
+
+    stdsptr<UndoRedoStackCache> mCache;
 };
 
 #endif // UNDOREDO_H
@@ -0,0 +1,109 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <iostream>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QGuiApplication>
+#include <QSurfaceFormat>
+
+#include "shaderconformance.h"
+
+void setDefaultFormat() {
+    QSurfaceFormat format;
+    format.setVersion(3, 3);
+    format.setProfile(QSurfaceFormat::CoreProfile);
+    format.setDepthBufferSize(24);
+    format.setStencilBufferSize(8);
+    format.setSamples(0);
+    QSurfaceFormat::setDefaultFormat(format);
+}
+
+int main(int argc, char *argv[]) {
+#ifdef Q_OS_LINUX
+    // run headless when there is no display to connect to
+    if(!qEnvironmentVariableIsSet("QT_QPA_PLATFORM") &&
+       !qEnvironmentVariableIsSet("DISPLAY") &&
+       !qEnvironmentVariableIsSet("WAYLAND_DISPLAY")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+#endif
+    QGuiApplication::setAttribute(Qt::AA_UseDesktopOpenGL);
+    setDefaultFormat();
+    QGuiApplication app(argc, argv);
+    app.setApplicationName("enve shader conformance");
+    setlocale(LC_NUMERIC, "C");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Compares the cpu translation of "
+                                     "shader effects with OpenGL output.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("directory",
+        "Directory with the .frag and .gre files of shader effects.");
+    const ShaderConformance::Tolerance defaults;
+    const QCommandLineOption diffOpt({"d", "max-diff"},
+        "Largest channel difference, in 0-255 units, counted as a match.",
+        "value", QString::number(defaults.fMaxChannelDiff));
+    const QCommandLineOption ratioOpt({"r", "max-mismatch"},
+        "Fraction of pixels allowed to differ by more than max-diff.",
+        "value", QString::number(defaults.fMaxMismatchRatio));
+    const QCommandLineOption requireGpuOpt("require-gpu",
+        "Fail instead of checking the cpu output only "
+        "when OpenGL 3.3 core is not available.");
+    parser.addOptions({diffOpt, ratioOpt, requireGpuOpt});
+    parser.process(app);
+
+    const auto args = parser.positionalArguments();
+    if(args.count() != 1) parser.showHelp(1);
+    const QDir dir(args.first());
+    const auto frags = dir.entryList({"*.frag"}, QDir::Files, QDir::Name);
+    if(frags.isEmpty()) {
+        std::cerr << "No shaders found in " <<
+                     dir.path().toStdString() << std::endl;
+        return 1;
+    }
+
+    ShaderConformance::Tolerance tolerance;
+    tolerance.fMaxChannelDiff = parser.value(diffOpt).toInt();
+    tolerance.fMaxMismatchRatio = parser.value(ratioOpt).toDouble();
+    ShaderConformance conformance(tolerance);
+    const QString gpuError = conformance.initializeGpu();
+    if(!gpuError.isEmpty()) {
+        std::cerr << "Gpu not available: " <<
+                     gpuError.toStdString() << std::endl;
+        if(parser.isSet(requireGpuOpt)) return 1;
+        std::cerr << "Only checking the cpu output" << std::endl;
+    }
+
+    int failed = 0;
+    for(const auto& frag : frags) {
+        const auto result = conformance.check(dir.filePath(frag));
+        std::cout << (result.fPassed ? "PASS " : "FAIL ") <<
+                     frag.toStdString();
+        if(!result.fError.isEmpty()) {
+            std::cout << ": " << result.fError.toStdString();
+        } else if(result.fGpuCompared) {
+            std::cout << ": max diff " << result.fMaxChannelDiff <<
+                         ", " << 100*result.fMismatchRatio <<
+                         "% pixels over tolerance";
+        }
+        std::cout << std::endl;
+        if(!result.fPassed) failed++;
+    }
+    std::cout << frags.count() - failed << "/" << frags.count() <<
+                 " shaders passed" << std::endl;
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,239 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "shaderconformance.h"
+
+#include <QDomDocument>
+#include <QFile>
+#include <QFileInfo>
+
+static const int sWidth = 67;
+static const int sHeight = 45;
+
+//! @brief Premultiplied gradients with a checker pattern and falling alpha
+static std::vector<unsigned char> sCreateFixture() {
+    std::vector<unsigned char> pixels(4*sWidth*sHeight);
+    for(int y = 0; y < sHeight; y++) {
+        for(int x = 0; x < sWidth; x++) {
+            const int a = 255 - x*96/(sWidth - 1);
+            const int r = x*255/(sWidth - 1);
+            const int g = y*255/(sHeight - 1);
+            const int b = (x/8 + y/8) % 2 ? 255 : 32;
+            unsigned char* const pix = &pixels[4*(y*sWidth + x)];
+            pix[0] = static_cast<unsigned char>(r*a/255);
+            pix[1] = static_cast<unsigned char>(g*a/255);
+            pix[2] = static_cast<unsigned char>(b*a/255);
+            pix[3] = static_cast<unsigned char>(a);
+        }
+    }
+    return pixels;
+}
+
+ShaderConformance::ShaderConformance(const Tolerance& tolerance) :
+    mTolerance(tolerance), mFixture(sCreateFixture()) {}
+
+ShaderConformance::~ShaderConformance() {
+    if(mVAO) mGL->glDeleteVertexArrays(1, &mVAO);
+}
+
+QString ShaderConformance::initializeGpu() {
+    try {
+        auto gl = std::make_unique<OffscreenQGL33c>();
+        gl->initialize();
+        gl->makeCurrent();
+        iniTexturedVShaderVBO(gl.get());
+        iniTexturedVShaderVAO(gl.get(), mVAO);
+        mGL = std::move(gl);
+    } catch(const std::exception& e) {
+        mVAO = 0;
+        return gAllTextFromException(e);
+    }
+    return QString();
+}
+
+ShaderConformance::Values ShaderConformance::sReadValues(
+        const QString& grePath) {
+    QFile file(grePath);
+    if(!file.open(QIODevice::ReadOnly))
+        RuntimeThrow("Could not open '" + grePath + "'");
+    QDomDocument document;
+    QString errorMsg;
+    if(!document.setContent(&file, &errorMsg))
+        RuntimeThrow("Invalid '" + grePath + "': " + errorMsg);
+    Values values;
+    const auto props = document.elementsByTagName("Property");
+    for(int i = 0; i < props.count(); i++) {
+        const auto prop = props.at(i).toElement();
+        if(prop.attribute("glValue") != "true") continue;
+        QString ini = prop.attribute("ini", "0");
+        ini.remove('[').remove(']');
+        QVector<float> value;
+        for(const auto& comp : ini.split(',')) {
+            bool ok;
+            value << comp.trimmed().toFloat(&ok);
+            if(!ok) RuntimeThrow("Invalid ini value for '" +
+                                 prop.attribute("name") + "'");
+        }
+        // a single value initializes every component
+        while(value.count() < 4) value << value.last();
+        values[prop.attribute("name")] = value;
+    }
+    return values;
+}
+
+ShaderConformance::Pixels ShaderConformance::renderCpu(
+        const CpuShaderProgram& program, const Values& values,
+        const int tileHeight) const {
+    CpuShaderProgram::Uniforms uniforms(
+                static_cast<size_t>(program.uniformCount()));
+    for(auto it = values.begin(); it != values.end(); it++) {
+        const int index = program.uniformIndex(it.key().toStdString());
+        if(index < 0) continue;
+        auto& uniform = uniforms[static_cast<size_t>(index)];
+        for(int i = 0; i < 4; i++) uniform.fV[i] = it.value().at(i);
+    }
+
+    // the source is only read
+    const auto srcPixels = const_cast<unsigned char*>(mFixture.data());
+    const CpuShaderProgram::Image src{srcPixels, sWidth, sHeight,
+                                      4*sWidth, false};
+    Pixels result(mFixture.size());
+    for(int top = 0; top < sHeight; top += tileHeight) {
+        const int height = qMin(tileHeight, sHeight - top);
+        const CpuShaderProgram::Image dst{&result[4*top*sWidth], sWidth,
+                                          height, 4*sWidth, false};
+        program.process(uniforms, src, dst, 0, top);
+    }
+    return result;
+}
+
+ShaderConformance::Pixels ShaderConformance::renderGpu(
+        const QString& fragPath, const Values& values) const {
+    const auto gl = mGL.get();
+    GLuint program;
+    gIniProgram(gl, program, GL_TEXTURED_VERT, fragPath);
+    gl->glUseProgram(program);
+
+    GLint count = 0;
+    gl->glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+    for(GLuint i = 0; i < static_cast<GLuint>(count); i++) {
+        char name[256];
+        GLint size;
+        GLenum type;
+        gl->glGetActiveUniform(program, i, sizeof(name), nullptr,
+                               &size, &type, name);
+        const GLint loc = gl->glGetUniformLocation(program, name);
+        if(type == GL_SAMPLER_2D) {
+            gl->glUniform1i(loc, 0);
+            continue;
+        }
+        // values computed by effect scripts are left at zero, same as on cpu
+        const auto value = values.value(name, QVector<float>(4, 0.f));
+        switch(type) {
+        case GL_FLOAT: gl->glUniform1fv(loc, 1, value.data()); break;
+        case GL_FLOAT_VEC2: gl->glUniform2fv(loc, 1, value.data()); break;
+        case GL_FLOAT_VEC3: gl->glUniform3fv(loc, 1, value.data()); break;
+        case GL_FLOAT_VEC4: gl->glUniform4fv(loc, 1, value.data()); break;
+        case GL_INT:
+        case GL_BOOL: gl->glUniform1i(loc, qRound(value.at(0))); break;
+        default:
+            gl->glDeleteProgram(program);
+            RuntimeThrow("Unsupported type of uniform '" +
+                         QString(name) + "'");
+        }
+    }
+
+    GLuint textures[2];
+    gl->glGenTextures(2, textures);
+    for(int i = 0; i < 2; i++) {
+        gl->glBindTexture(GL_TEXTURE_2D, textures[i]);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        gl->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, sWidth, sHeight, 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE,
+                         i == 0 ? mFixture.data() : nullptr);
+    }
+    GLuint fbo;
+    gl->glGenFramebuffers(1, &fbo);
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    gl->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                               GL_TEXTURE_2D, textures[1], 0);
+
+    gl->glViewport(0, 0, sWidth, sHeight);
+    gl->glClearColor(0, 0, 0, 0);
+    gl->glClear(GL_COLOR_BUFFER_BIT);
+    gl->glActiveTexture(GL_TEXTURE0);
+    gl->glBindTexture(GL_TEXTURE_2D, textures[0]);
+    gl->glBindVertexArray(mVAO);
+    gl->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    Pixels result(mFixture.size());
+    gl->glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    gl->glReadPixels(0, 0, sWidth, sHeight, GL_RGBA,
+                     GL_UNSIGNED_BYTE, result.data());
+
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gl->glDeleteFramebuffers(1, &fbo);
+    gl->glDeleteTextures(2, textures);
+    gl->glDeleteProgram(program);
+    checkGLErrors(gl, "Rendering '" + fragPath + "' failed.");
+    return result;
+}
+
+ShaderConformance::Result ShaderConformance::check(
+        const QString& fragPath) const {
+    Result result;
+    try {
+        const QFileInfo fragInfo(fragPath);
+        const auto values = sReadValues(fragInfo.path() + "/" +
+                                        fragInfo.completeBaseName() + ".gre");
+
+        QFile file(fragPath);
+        if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
+            RuntimeThrow("Could not open '" + fragPath + "'");
+        const auto source = file.readAll().toStdString();
+        const auto program = CpuShaderProgram::sCompile(source);
+
+        const auto cpu = renderCpu(*program, values, sHeight);
+        // effects run per tile, tile offsets must not change the result
+        if(cpu != renderCpu(*program, values, 16))
+            RuntimeThrow("Tiled cpu output differs from the whole image");
+
+        if(gpuAvailable()) {
+            const auto gpu = renderGpu(fragPath, values);
+            int mismatched = 0;
+            for(size_t i = 0; i < cpu.size(); i += 4) {
+                int pixelDiff = 0;
+                for(size_t j = i; j < i + 4; j++) {
+                    pixelDiff = qMax(pixelDiff, qAbs(cpu[j] - gpu[j]));
+                }
+                result.fMaxChannelDiff = qMax(result.fMaxChannelDiff,
+                                              pixelDiff);
+                if(pixelDiff > mTolerance.fMaxChannelDiff) mismatched++;
+            }
+            result.fGpuCompared = true;
+            result.fMismatchRatio = qreal(mismatched)/(sWidth*sHeight);
+            result.fPassed = result.fMismatchRatio <=
+                             mTolerance.fMaxMismatchRatio;
+        } else result.fPassed = true;
+    } catch(const std::exception& e) {
+        result.fError = gAllTextFromException(e);
+        result.fPassed = false;
+    }
+    return result;
+}
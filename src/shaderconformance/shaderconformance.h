@@ -0,0 +1,72 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SHADERCONFORMANCE_H
+#define SHADERCONFORMANCE_H
+
+#include <QMap>
+#include <QVector>
+
+#include "Private/Tasks/offscreenqgl33c.h"
+#include "ShaderEffects/cpushaderprogram.h"
+
+//! @brief Checks the cpu translation of shader effects against
+//! the same fragment shaders rendered with OpenGL
+class ShaderConformance {
+public:
+    struct Tolerance {
+        //! @brief Largest channel difference in 0-255 units still counted
+        //! as a match, covers rounding and float precision differences
+        int fMaxChannelDiff = 2;
+        //! @brief Fraction of pixels allowed to differ by more,
+        //! covers sampling position differences at hard edges
+        qreal fMaxMismatchRatio = 0.001;
+    };
+
+    struct Result {
+        bool fPassed = false;
+        bool fGpuCompared = false;
+        QString fError;
+        int fMaxChannelDiff = 0;
+        qreal fMismatchRatio = 0;
+    };
+
+    ShaderConformance(const Tolerance& tolerance);
+    ~ShaderConformance();
+
+    //! @brief Returns the error, empty if the gpu can be used
+    QString initializeGpu();
+    bool gpuAvailable() const { return mVAO != 0; }
+
+    //! @brief Uniform values are read from the .gre file next to fragPath
+    Result check(const QString& fragPath) const;
+private:
+    using Values = QMap<QString, QVector<float>>;
+    using Pixels = std::vector<unsigned char>;
+
+    static Values sReadValues(const QString& grePath);
+
+    Pixels renderCpu(const CpuShaderProgram& program,
+                     const Values& values, const int tileHeight) const;
+    Pixels renderGpu(const QString& fragPath, const Values& values) const;
+
+    const Tolerance mTolerance;
+    Pixels mFixture;
+    std::unique_ptr<OffscreenQGL33c> mGL;
+    GLuint mVAO = 0;
+};
+
+#endif // SHADERCONFORMANCE_H